@@ -195,7 +195,7 @@ bool Application::LoadResource(I32 type, const std::string& identifier, const st
 	}
 	case 0: // ResourceInfo::Type::Font
 	{
-		FontPtr fontPtr = resourceManager.Create<Font>(identifier.c_str(), FontLoader::FromFile(resourceFilename));
+		FontPtr fontPtr = resourceManager.CreateAsync<Font>(identifier.c_str(), FontLoader::FromFileAsync(resourceFilename));
 		if (!fontPtr.IsValid())
 		{
 			resourceID = InvalidResourceID;
@@ -210,7 +210,7 @@ bool Application::LoadResource(I32 type, const std::string& identifier, const st
 	}
 	case 1: // ResourceInfo::Type::Texture
 	{
-		TexturePtr texturePtr = resourceManager.Create<Texture>(identifier.c_str(), TextureLoader::FromFile(resourceFilename));
+		TexturePtr texturePtr = resourceManager.CreateAsync<Texture>(identifier.c_str(), TextureLoader::FromFileAsync(resourceFilename));
 		if (!texturePtr.IsValid())
 		{
 			resourceID = InvalidResourceID;
@@ -225,7 +225,7 @@ bool Application::LoadResource(I32 type, const std::string& identifier, const st
 	}
 	case 2: // ResourceInfo::Type::Tileset
 	{
-		tmx::TilesetPtr tilesetPtr = resourceManager.Create<tmx::Tileset>(identifier.c_str(), tmx::TilesetLoader::FromFile(resourceFilename));
+		tmx::TilesetPtr tilesetPtr = resourceManager.CreateAsync<tmx::Tileset>(identifier.c_str(), tmx::TilesetLoader::FromFileAsync(resourceFilename));
 		if (!tilesetPtr.IsValid())
 		{
 			resourceID = InvalidResourceID;
@@ -240,7 +240,7 @@ bool Application::LoadResource(I32 type, const std::string& identifier, const st
 	}
 	case 3: // ResourceInfo::Type::Map
 	{
-		tmx::MapPtr mapPtr = resourceManager.Create<tmx::Map>(identifier.c_str(), tmx::MapLoader::FromFile(resourceFilename));
+		tmx::MapPtr mapPtr = resourceManager.CreateAsync<tmx::Map>(identifier.c_str(), tmx::MapLoader::FromFileAsync(resourceFilename));
 		if (!mapPtr.IsValid())
 		{
 			resourceID = InvalidResourceID;
@@ -255,7 +255,7 @@ bool Application::LoadResource(I32 type, const std::string& identifier, const st
 	}
 	case 4: // ResourceInfo::Type::Animation
 	{
-		AnimationPtr animPtr = resourceManager.Create<Animation>(identifier.c_str(), AnimationLoader::FromFile(resourceFilename));
+		AnimationPtr animPtr = resourceManager.CreateAsync<Animation>(identifier.c_str(), AnimationLoader::FromFileAsync(resourceFilename));
 		if (!animPtr.IsValid())
 		{
 			resourceID = InvalidResourceID;
@@ -270,7 +270,7 @@ bool Application::LoadResource(I32 type, const std::string& identifier, const st
 	}
 	case 5: // ResourceInfo::Type::AnimationStateMachine
 	{
-		AnimationStateMachinePtr animPtr = resourceManager.Create<AnimationStateMachine>(identifier.c_str(), AnimationStateMachineLoader::FromFile(resourceFilename));
+		AnimationStateMachinePtr animPtr = resourceManager.CreateAsync<AnimationStateMachine>(identifier.c_str(), AnimationStateMachineLoader::FromFileAsync(resourceFilename));
 		if (!animPtr.IsValid())
 		{
 			resourceID = InvalidResourceID;
@@ -300,7 +300,7 @@ bool Application::LoadResource(I32 type, const std::string& identifier, const st
 	}
 	case 7: // ResourceInfo::Type::Sound
 	{
-		SoundID soundID = AudioSystem::GetInstance().PrepareSound(identifier.c_str(), resourceFilename);
+		SoundID soundID = AudioSystem::GetInstance().PrepareSoundAsync(identifier.c_str(), resourceFilename);
 		if (soundID == InvalidSoundID)
 		{
 			resourceID = InvalidResourceID;
@@ -351,6 +351,9 @@ void Application::Run()
 			accumulator += dt;
 			fpsAccumulator += dt;
 
+			// Finalize the resources decoded by the loading threads
+			ResourceManager::GetInstance().Update();
+
 			Events();
 
 			// Fixed time 60 FPS
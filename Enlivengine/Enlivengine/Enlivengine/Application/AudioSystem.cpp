@@ -641,6 +641,24 @@ SoundID AudioSystem::PrepareSound(const char* id, const std::string& filename)
 	}
 }
 
+SoundID AudioSystem::PrepareSoundAsync(const char* id, const std::string& filename)
+{
+	const SoundBufferPtr soundBuffer = ResourceManager::GetInstance().CreateAsync(id, SoundBufferLoader::FromFileAsync(filename));
+	if (soundBuffer.IsValid())
+	{
+		const SoundID soundId = soundBuffer.GetID();
+		if (!IsSoundLoaded(soundId))
+		{
+			mLoadedSounds.push_back(soundId);
+		}
+		return soundId;
+	}
+	else
+	{
+		return InvalidResourceID;
+	}
+}
+
 bool AudioSystem::IsSoundLoaded(SoundID id) const
 {
 	const size_t size = mLoadedSounds.size();
@@ -669,7 +687,7 @@ SoundPtr AudioSystem::PlaySound(SoundID id)
 	if (mSounds.size() < MAX_SOUNDS && ResourceManager::GetInstance().Has(id))
 	{
 		const SoundBufferPtr soundBuffer = ResourceManager::GetInstance().Get<en::SoundBuffer>(id);
-		if (soundBuffer.IsValid())
+		if (soundBuffer.IsLoaded())
 		{
 			mSounds.push_back(new Sound(soundBuffer, this));
 			Sound* sound = mSounds.back();
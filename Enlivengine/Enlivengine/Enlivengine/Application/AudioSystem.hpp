@@ -207,6 +207,7 @@ public:
 	void SetSoundsEnabled(bool enabled);
 	F32 GetCurrentSoundsVolume() const;
 	SoundID PrepareSound(const char* id, const std::string& filename);
+	SoundID PrepareSoundAsync(const char* id, const std::string& filename); // Can't be played until the ResourceManager finalized it
 	bool IsSoundLoaded(SoundID id) const;
 	bool IsSoundLoaded(const char* id) const;
 	U32 GetLoadedSoundsCount() const;
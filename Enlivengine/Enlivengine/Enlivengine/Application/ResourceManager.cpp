@@ -13,7 +13,7 @@ ResourceID StringToResourceID(const std::string& str)
 
 BaseResource::BaseResource()
 	: mID(InvalidResourceID)
-	, mLoaded(false)
+	, mLoadingState(ResourceLoadingState::Failed)
 	, mIdentifier()
 	, mFilename()
 {
@@ -21,7 +21,17 @@ BaseResource::BaseResource()
 
 bool BaseResource::IsLoaded() const
 {
-	return mLoaded;
+	return mLoadingState == ResourceLoadingState::Loaded;
+}
+
+bool BaseResource::IsLoading() const
+{
+	return mLoadingState == ResourceLoadingState::Loading;
+}
+
+ResourceLoadingState BaseResource::GetLoadingState() const
+{
+	return mLoadingState;
 }
 
 bool BaseResource::IsFromFile() const
@@ -52,7 +62,29 @@ const std::string& BaseResource::GetFilename() const
 } // namespace priv
 
 ResourceManager::ResourceManager()
+	: mResources()
+	, mRequests()
+	, mRequestedCount(0)
+	, mFinalizedCount(0)
+	, mLoadingThreads()
+	, mMutex()
+	, mCondition()
+	, mPendingRequests()
+	, mStopping(false)
+{
+}
+
+ResourceManager::~ResourceManager()
 {
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mStopping = true;
+	}
+	mCondition.notify_all();
+	for (std::thread& thread : mLoadingThreads)
+	{
+		thread.join();
+	}
 }
 
 bool ResourceManager::Has(const std::string& str) const
@@ -72,16 +104,15 @@ void ResourceManager::Release(const std::string& str)
 
 void ResourceManager::Release(ResourceID id)
 {
-	const auto itr = mResources.find(id);
-	if (itr != mResources.end())
-	{
-		mResources.erase(itr);
-	}
+	Remove(id);
 }
 
 void ResourceManager::ReleaseAll()
 {
-	mResources.clear();
+	while (!mResources.empty())
+	{
+		Remove(mResources.begin()->first);
+	}
 }
 
 U32 ResourceManager::Count() const
@@ -89,4 +120,104 @@ U32 ResourceManager::Count() const
 	return static_cast<U32>(mResources.size());
 }
 
+void ResourceManager::Update()
+{
+	while (!mRequests.empty() && mRequests.front()->prepared.load(std::memory_order_acquire))
+	{
+		std::unique_ptr<AsyncRequest> request = std::move(mRequests.front());
+		mRequests.pop_front();
+		if (request->released == nullptr)
+		{
+			const bool loaded = request->prepareResult && request->finalize();
+			request->resource->mLoadingState = (loaded) ? ResourceLoadingState::Loaded : ResourceLoadingState::Failed;
+		}
+		mFinalizedCount++;
+	}
+	if (mRequests.empty())
+	{
+		mRequestedCount = 0;
+		mFinalizedCount = 0;
+	}
+}
+
+bool ResourceManager::IsLoading() const
+{
+	return !mRequests.empty();
+}
+
+U32 ResourceManager::GetLoadingCount() const
+{
+	return static_cast<U32>(mRequests.size());
+}
+
+F32 ResourceManager::GetLoadingProgress() const
+{
+	return (mRequestedCount > 0) ? static_cast<F32>(mFinalizedCount) / static_cast<F32>(mRequestedCount) : 1.0f;
+}
+
+void ResourceManager::AddRequest(std::unique_ptr<AsyncRequest> request)
+{
+	if (mLoadingThreads.empty())
+	{
+		// Decoding files is mostly waiting for the disk or the memory, a few threads are enough
+		const U32 maxThreadCount = 4;
+		const U32 hardwareThreads = static_cast<U32>(std::thread::hardware_concurrency());
+		const U32 threadCount = (hardwareThreads > 2) ? ((hardwareThreads - 1 < maxThreadCount) ? hardwareThreads - 1 : maxThreadCount) : 1;
+		for (U32 i = 0; i < threadCount; ++i)
+		{
+			mLoadingThreads.emplace_back(&ResourceManager::RunLoadingThread, this);
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mPendingRequests.push_back(request.get());
+	}
+	mCondition.notify_one();
+	mRequests.push_back(std::move(request));
+	mRequestedCount++;
+}
+
+void ResourceManager::Remove(ResourceID id)
+{
+	const auto itr = mResources.find(id);
+	if (itr == mResources.end())
+	{
+		return;
+	}
+	if (itr->second->IsLoading())
+	{
+		// A loading thread might still be filling it
+		for (std::unique_ptr<AsyncRequest>& request : mRequests)
+		{
+			if (request->resource == itr->second.get())
+			{
+				request->released = std::move(itr->second);
+				break;
+			}
+		}
+	}
+	mResources.erase(itr);
+}
+
+void ResourceManager::RunLoadingThread()
+{
+	while (true)
+	{
+		AsyncRequest* request = nullptr;
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mCondition.wait(lock, [this]() { return mStopping || !mPendingRequests.empty(); });
+			if (mStopping)
+			{
+				return;
+			}
+			request = mPendingRequests.front();
+			mPendingRequests.pop_front();
+		}
+		request->prepareResult = request->prepare();
+		request->prepared.store(true, std::memory_order_release);
+	}
+}
+
 } // namespace en
@@ -1,7 +1,12 @@
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 #include <string>
@@ -16,6 +21,13 @@ namespace en
 using ResourceID = U32;
 constexpr ResourceID InvalidResourceID = U32_Max;
 
+enum class ResourceLoadingState
+{
+	Loading, // Requested with CreateAsync, not usable until it is finalized
+	Loaded,
+	Failed
+};
+
 namespace priv
 {
 
@@ -27,6 +39,8 @@ public:
 	BaseResource();
 
 	bool IsLoaded() const;
+	bool IsLoading() const;
+	ResourceLoadingState GetLoadingState() const;
 	bool IsFromFile() const;
 	bool IsManaged() const;
 	ResourceID GetID() const;
@@ -35,7 +49,7 @@ public:
 
 public:
 	ResourceID mID;
-	bool mLoaded;
+	ResourceLoadingState mLoadingState;
 	std::string mIdentifier;
 	std::string mFilename;
 };
@@ -53,6 +67,9 @@ public:
 	ResourceID GetID() const;
 	bool IsValid() const;
 	operator bool() const;
+	// Failed for invalid pointers
+	ResourceLoadingState GetLoadingState() const;
+	bool IsLoaded() const;
 	void Release();
 
 	T* GetPtr() const;
@@ -90,6 +107,27 @@ private:
 	LoaderFunc mFunc;
 };
 
+// Loads in two steps : Prepare runs on a loading thread and only touches the resource, never the ResourceManager
+// Finalize runs on the main thread once Prepare succeeded : dependencies, graphics or audio objects
+template <typename T>
+class AsyncResourceLoader
+{
+public:
+	using LoaderFunc = std::function<bool(T&)>;
+
+public:
+	AsyncResourceLoader(LoaderFunc prepare, LoaderFunc finalize);
+	// Everything on the main thread, for the resources made of other resources
+	AsyncResourceLoader(const ResourceLoader<T>& loader);
+
+	bool Prepare(T& resource) const;
+	bool Finalize(T& resource) const;
+
+private:
+	LoaderFunc mPrepare;
+	LoaderFunc mFinalize;
+};
+
 enum class ResourceKnownStrategy
 {
 	Reuse = 0,
@@ -104,7 +142,12 @@ class ResourceManager
 	ENLIVE_SINGLETON(ResourceManager);
 
 public:
+	~ResourceManager();
+
 	template <typename T> ResourcePtr<T> Create(const std::string& str, const ResourceLoader<T>& loader, ResourceKnownStrategy knownStrategy = ResourceKnownStrategy::Reuse);
+	// Returns at once with a Loading resource, prepared on the loading threads and finalized by Update
+	// Requests are finalized in order : a resource can use the ones requested before it
+	template <typename T> ResourcePtr<T> CreateAsync(const std::string& str, const AsyncResourceLoader<T>& loader, ResourceKnownStrategy knownStrategy = ResourceKnownStrategy::Reuse);
 	template <typename T> ResourcePtr<T> Get(const std::string& str);
 	template <typename T> ResourcePtr<T> Get(ResourceID id);
 
@@ -120,13 +163,45 @@ public:
 
 	U32 Count() const;
 
+	// Main thread, once per frame : finalizes the prepared requests
+	void Update();
+
+	bool IsLoading() const;
+	U32 GetLoadingCount() const;
+	// Finalized requests over the requests made since the last time nothing was loading, 1 when nothing is loading
+	F32 GetLoadingProgress() const;
+
 private:
 	template <typename T> friend class ResourcePtr;
 	template <typename T> T* GetRawPtr(ResourceID id);
 	template <typename T> const T* GetRawPtr(ResourceID id) const;
 
+	struct AsyncRequest
+	{
+		priv::BaseResource* resource;
+		std::function<bool()> prepare;
+		std::function<bool()> finalize;
+		std::unique_ptr<priv::BaseResource> released; // Kept alive until prepared when released while loading
+		bool prepareResult;
+		std::atomic<bool> prepared;
+	};
+
+	void AddRequest(std::unique_ptr<AsyncRequest> request);
+	void Remove(ResourceID id);
+	void RunLoadingThread();
+
 private:
 	std::unordered_map<ResourceID, std::unique_ptr<priv::BaseResource>> mResources;
+
+	std::deque<std::unique_ptr<AsyncRequest>> mRequests; // Main thread, in the order they are finalized
+	U32 mRequestedCount;
+	U32 mFinalizedCount;
+
+	std::vector<std::thread> mLoadingThreads; // Started by the first request
+	std::mutex mMutex;
+	std::condition_variable mCondition;
+	std::deque<AsyncRequest*> mPendingRequests; // Waiting for a loading thread, guarded by mMutex
+	bool mStopping; // Guarded by mMutex
 };
 
 } // namespace en
@@ -23,6 +23,18 @@ ResourcePtr<T>::operator bool() const
 	return IsValid();
 }
 
+template <typename T>
+ResourceLoadingState ResourcePtr<T>::GetLoadingState() const
+{
+	return (IsValid()) ? mManager->GetRawPtr<T>(mID)->GetLoadingState() : ResourceLoadingState::Failed;
+}
+
+template <typename T>
+bool ResourcePtr<T>::IsLoaded() const
+{
+	return GetLoadingState() == ResourceLoadingState::Loaded;
+}
+
 template <typename T>
 void ResourcePtr<T>::Release()
 {
@@ -77,6 +89,32 @@ bool ResourceLoader<T>::Load(T& resource) const
 	return mFunc(resource);
 }
 
+template <typename T>
+AsyncResourceLoader<T>::AsyncResourceLoader(LoaderFunc prepare, LoaderFunc finalize)
+	: mPrepare(std::move(prepare))
+	, mFinalize(std::move(finalize))
+{
+}
+
+template <typename T>
+AsyncResourceLoader<T>::AsyncResourceLoader(const ResourceLoader<T>& loader)
+	: mPrepare()
+	, mFinalize([loader](T& resource) { return loader.Load(resource); })
+{
+}
+
+template <typename T>
+bool AsyncResourceLoader<T>::Prepare(T& resource) const
+{
+	return (mPrepare) ? mPrepare(resource) : true;
+}
+
+template <typename T>
+bool AsyncResourceLoader<T>::Finalize(T& resource) const
+{
+	return (mFinalize) ? mFinalize(resource) : true;
+}
+
 template <typename T> 
 ResourcePtr<T> ResourceManager::Create(const std::string& str, const ResourceLoader<T>& loader, ResourceKnownStrategy knownStrategy)
 {
@@ -88,9 +126,10 @@ ResourcePtr<T> ResourceManager::Create(const std::string& str, const ResourceLoa
 		if (T* resourcePtr = resource.get())
         {
             resourcePtr->mIdentifier = str;
-			resourcePtr->mLoaded = loader.Load(*resourcePtr);
+			resourcePtr->mLoadingState = (loader.Load(*resourcePtr)) ? ResourceLoadingState::Loaded : ResourceLoadingState::Failed;
 			resourcePtr->mID = id;
 
+			Remove(id);
 			mResources[resourcePtr->mID] = std::move(resource);
 
 			return ResourcePtr<T>(id, this);
@@ -110,6 +149,42 @@ ResourcePtr<T> ResourceManager::Create(const std::string& str, const ResourceLoa
 	}
 }
 
+template <typename T>
+ResourcePtr<T> ResourceManager::CreateAsync(const std::string& str, const AsyncResourceLoader<T>& loader, ResourceKnownStrategy knownStrategy)
+{
+	ResourceID id = priv::StringToResourceID(str);
+	const auto itr = mResources.find(id);
+	if (itr == mResources.end() || knownStrategy == ResourceKnownStrategy::Reload)
+	{
+		std::unique_ptr<T> resource = std::make_unique<T>();
+		T* resourcePtr = resource.get();
+		resourcePtr->mIdentifier = str;
+		resourcePtr->mLoadingState = ResourceLoadingState::Loading;
+		resourcePtr->mID = id;
+
+		Remove(id);
+		mResources[id] = std::move(resource);
+
+		std::unique_ptr<AsyncRequest> request = std::make_unique<AsyncRequest>();
+		request->resource = resourcePtr;
+		request->prepare = [resourcePtr, loader]() { return loader.Prepare(*resourcePtr); };
+		request->finalize = [resourcePtr, loader]() { return loader.Finalize(*resourcePtr); };
+		request->prepareResult = false;
+		request->prepared = false;
+		AddRequest(std::move(request));
+
+		return ResourcePtr<T>(id, this);
+	}
+	else if (knownStrategy == ResourceKnownStrategy::Reuse)
+	{
+		return ResourcePtr<T>(id, this);
+	}
+	else
+	{
+		return ResourcePtr<T>(InvalidResourceID, this);
+	}
+}
+
 template <typename T> 
 ResourcePtr<T> ResourceManager::Get(const std::string& str)
 {
@@ -94,6 +94,17 @@ public:
 			return result;
 		});
 	}
+
+	// Loaded on the main thread : it uses its texture through the ResourceManager
+	static AsyncResourceLoader<Animation> FromFileAsync(const std::string& filename)
+	{
+		return AsyncResourceLoader<Animation>(ResourceLoader<Animation>([filename](Animation& r)
+		{
+			const bool result = r.LoadFromFile(filename);
+			r.mFilename = (result) ? filename : "";
+			return result;
+		}));
+	}
 };
 
 } // namespace en
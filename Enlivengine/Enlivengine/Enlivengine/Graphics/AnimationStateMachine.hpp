@@ -305,6 +305,17 @@ public:
 			return result;
 		});
 	}
+
+	// Loaded on the main thread : it uses its animation through the ResourceManager
+	static AsyncResourceLoader<AnimationStateMachine> FromFileAsync(const std::string& filename)
+	{
+		return AsyncResourceLoader<AnimationStateMachine>(ResourceLoader<AnimationStateMachine>([filename](AnimationStateMachine& r)
+		{
+			const bool result = r.LoadFromFile(filename);
+			r.mFilename = (result) ? filename : "";
+			return result;
+		}));
+	}
 };
 
 } // namespace en
@@ -1,6 +1,59 @@
 #include <Enlivengine/Graphics/SFMLResources.hpp>
 
+#include <SFML/Audio/InputSoundFile.hpp>
+
+#include <memory>
+#include <vector>
+
 namespace en
 {
 
-} // namespace en
\ No newline at end of file
+template <>
+AsyncResourceLoader<Texture> TextureLoader::FromFileAsync(const std::string& filename)
+{
+	std::shared_ptr<sf::Image> image = std::make_shared<sf::Image>();
+	return AsyncResourceLoader<Texture>([filename, image](Texture&)
+	{
+		return image->loadFromFile(filename);
+	},
+	[filename, image](Texture& r)
+	{
+		const bool result = r.loadFromImage(*image);
+		r.mFilename = (result) ? filename : "";
+		*image = sf::Image();
+		return result;
+	});
+}
+
+template <>
+AsyncResourceLoader<SoundBuffer> SoundBufferLoader::FromFileAsync(const std::string& filename)
+{
+	struct Samples
+	{
+		std::vector<sf::Int16> samples;
+		unsigned int channelCount;
+		unsigned int sampleRate;
+	};
+	std::shared_ptr<Samples> samples = std::make_shared<Samples>();
+	return AsyncResourceLoader<SoundBuffer>([filename, samples](SoundBuffer&)
+	{
+		sf::InputSoundFile file;
+		if (!file.openFromFile(filename))
+		{
+			return false;
+		}
+		samples->samples.resize(static_cast<std::size_t>(file.getSampleCount()));
+		samples->channelCount = file.getChannelCount();
+		samples->sampleRate = file.getSampleRate();
+		return file.read(samples->samples.data(), file.getSampleCount()) == file.getSampleCount();
+	},
+	[filename, samples](SoundBuffer& r)
+	{
+		const bool result = r.loadFromSamples(samples->samples.data(), samples->samples.size(), samples->channelCount, samples->sampleRate);
+		r.mFilename = (result) ? filename : "";
+		samples->samples = std::vector<sf::Int16>();
+		return result;
+	});
+}
+
+} // namespace en
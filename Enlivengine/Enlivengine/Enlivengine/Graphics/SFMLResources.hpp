@@ -30,6 +30,20 @@ class SFMLResourcesLoader
 				return result;
 			});
 		}
+
+		// Fonts and images are read on the loading thread
+		static AsyncResourceLoader<T> FromFileAsync(const std::string& filename)
+		{
+			return AsyncResourceLoader<T>([filename](T& r)
+			{
+				return r.loadFromFile(filename);
+			},
+			[filename](T& r)
+			{
+				r.mFilename = filename;
+				return true;
+			});
+		}
 };
 
 } // namespace priv
@@ -49,4 +63,9 @@ using FontLoader = priv::SFMLResourcesLoader<Font>;
 using ImageLoader = priv::SFMLResourcesLoader<Image>;
 using SoundBufferLoader = priv::SFMLResourcesLoader<SoundBuffer>;
 
+// The image is decoded on the loading thread, only its upload to the graphics card is left to the main thread
+template <> AsyncResourceLoader<Texture> TextureLoader::FromFileAsync(const std::string& filename);
+// The samples are decoded on the loading thread, the audio buffer is filled by the main thread
+template <> AsyncResourceLoader<SoundBuffer> SoundBufferLoader::FromFileAsync(const std::string& filename);
+
 } // namespace en
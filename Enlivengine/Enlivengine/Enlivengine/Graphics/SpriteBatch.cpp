@@ -0,0 +1,97 @@
+#include <Enlivengine/Graphics/SpriteBatch.hpp>
+
+#include <Enlivengine/Math/Utilities.hpp>
+#include <Enlivengine/Graphics/SFMLWrapper.hpp>
+
+namespace en
+{
+
+SpriteBatch::SpriteBatch()
+	: mBatches()
+	, mBatchCount(0)
+	, mQuadCount(0)
+{
+}
+
+void SpriteBatch::Draw(const sf::Texture& texture, const sf::IntRect& textureRect, const Vector2f& position, const Vector2f& origin, const Vector2f& scale, F32 rotation, const Color& color)
+{
+	// Same matrix as sf::Transformable::getTransform
+	const F32 cosine = Math::Cos(-rotation);
+	const F32 sine = Math::Sin(-rotation);
+	const F32 sxc = scale.x * cosine;
+	const F32 syc = scale.y * cosine;
+	const F32 sxs = scale.x * sine;
+	const F32 sys = scale.y * sine;
+	const F32 tx = -origin.x * sxc - origin.y * sys + position.x;
+	const F32 ty = origin.x * sxs - origin.y * syc + position.y;
+	const sf::Transform transform(sxc, sys, tx, -sxs, syc, ty, 0.0f, 0.0f, 1.0f);
+	Draw(texture, textureRect, transform, color);
+}
+
+void SpriteBatch::Draw(const sf::Texture& texture, const sf::IntRect& textureRect, const sf::Transform& transform, const Color& color)
+{
+	// Like sf::Sprite, a negative size flips the texture, not the quad
+	const F32 width = static_cast<F32>((textureRect.width >= 0) ? textureRect.width : -textureRect.width);
+	const F32 height = static_cast<F32>((textureRect.height >= 0) ? textureRect.height : -textureRect.height);
+	const F32 left = static_cast<F32>(textureRect.left);
+	const F32 right = left + static_cast<F32>(textureRect.width);
+	const F32 top = static_cast<F32>(textureRect.top);
+	const F32 bottom = top + static_cast<F32>(textureRect.height);
+	const sf::Color vertexColor = toSF(color);
+
+	sf::VertexArray& vertices = GetVertices(texture);
+	vertices.append(sf::Vertex(transform.transformPoint(0.0f, 0.0f), vertexColor, sf::Vector2f(left, top)));
+	vertices.append(sf::Vertex(transform.transformPoint(width, 0.0f), vertexColor, sf::Vector2f(right, top)));
+	vertices.append(sf::Vertex(transform.transformPoint(width, height), vertexColor, sf::Vector2f(right, bottom)));
+	vertices.append(sf::Vertex(transform.transformPoint(0.0f, height), vertexColor, sf::Vector2f(left, bottom)));
+	mQuadCount++;
+}
+
+void SpriteBatch::Draw(const sf::Sprite& sprite)
+{
+	if (sprite.getTexture() != nullptr)
+	{
+		Draw(*sprite.getTexture(), sprite.getTextureRect(), sprite.getTransform(), toEN(sprite.getColor()));
+	}
+}
+
+void SpriteBatch::Flush(sf::RenderTarget& target, sf::RenderStates states)
+{
+	for (U32 i = 0; i < mBatchCount; ++i)
+	{
+		states.texture = mBatches[i].texture;
+		target.draw(mBatches[i].vertices, states);
+	}
+	Clear();
+}
+
+void SpriteBatch::Clear()
+{
+	for (U32 i = 0; i < mBatchCount; ++i)
+	{
+		mBatches[i].vertices.clear();
+	}
+	mBatchCount = 0;
+	mQuadCount = 0;
+}
+
+sf::VertexArray& SpriteBatch::GetVertices(const sf::Texture& texture)
+{
+	// A layer only uses a few textures
+	for (U32 i = 0; i < mBatchCount; ++i)
+	{
+		if (mBatches[i].texture == &texture)
+		{
+			return mBatches[i].vertices;
+		}
+	}
+	if (mBatchCount == mBatches.size())
+	{
+		mBatches.push_back({ nullptr, sf::VertexArray(sf::Quads) });
+	}
+	Batch& batch = mBatches[mBatchCount++];
+	batch.texture = &texture;
+	return batch.vertices;
+}
+
+} // namespace en
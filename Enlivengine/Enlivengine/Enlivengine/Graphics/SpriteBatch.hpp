@@ -0,0 +1,57 @@
+#pragma once
+
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Sprite.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+
+#include <Enlivengine/System/NonCopyable.hpp>
+#include <Enlivengine/System/PrimitiveTypes.hpp>
+#include <Enlivengine/Math/Vector2.hpp>
+#include <Enlivengine/Graphics/Color.hpp>
+
+#include <vector>
+
+namespace en
+{
+
+// Textured quads accumulated in one vertex array per texture, drawn with one draw call per texture
+// The quads are computed on the CPU when added, filling a batch doesn't need a render target
+// Quads of the same texture keep their order, textures are drawn in the order they were first used
+class SpriteBatch : private NonCopyable
+{
+public:
+	SpriteBatch();
+
+	// Same quad as a sf::Sprite : origin in local pixels, then scale, rotation in degrees and position
+	void Draw(const sf::Texture& texture, const sf::IntRect& textureRect, const Vector2f& position, const Vector2f& origin = Vector2f(0.0f, 0.0f), const Vector2f& scale = Vector2f(1.0f, 1.0f), F32 rotation = 0.0f, const Color& color = Color::White);
+	void Draw(const sf::Texture& texture, const sf::IntRect& textureRect, const sf::Transform& transform, const Color& color = Color::White);
+	void Draw(const sf::Sprite& sprite);
+
+	// One draw call per texture used since the last Flush, then Clear
+	void Flush(sf::RenderTarget& target, sf::RenderStates states = sf::RenderStates::Default);
+
+	// The vertex arrays keep their capacity
+	void Clear();
+
+	U32 GetQuadCount() const { return mQuadCount; }
+	U32 GetBatchCount() const { return mBatchCount; }
+	const sf::Texture* GetBatchTexture(U32 batchIndex) const { return mBatches[batchIndex].texture; }
+	const sf::VertexArray& GetBatchVertices(U32 batchIndex) const { return mBatches[batchIndex].vertices; }
+
+private:
+	sf::VertexArray& GetVertices(const sf::Texture& texture);
+
+private:
+	struct Batch
+	{
+		const sf::Texture* texture;
+		sf::VertexArray vertices;
+	};
+
+	std::vector<Batch> mBatches; // Only the first mBatchCount are used, the others are kept for their capacity
+	U32 mBatchCount;
+	U32 mQuadCount;
+};
+
+} // namespace en
@@ -0,0 +1,179 @@
+#include <Enlivengine/Map/BinaryMap.hpp>
+
+#include <Enlivengine/System/Log.hpp>
+
+#include <cassert>
+#include <cstdio>
+#include <filesystem>
+
+namespace en
+{
+namespace tmx
+{
+
+bool BinaryMap::IsBinaryMapFilename(const std::string& filename)
+{
+	return std::filesystem::path(filename).extension().string() == Extension;
+}
+
+std::string BinaryMap::GetLoadFilename(const std::string& filename)
+{
+	if (!IsBinaryMapFilename(filename))
+	{
+		return filename;
+	}
+
+	std::filesystem::path sourcePath(filename);
+	sourcePath.replace_extension(SourceExtension);
+	std::error_code error;
+	if (!std::filesystem::exists(sourcePath, error))
+	{
+		return filename;
+	}
+	if (!std::filesystem::exists(filename, error))
+	{
+		LogWarning(en::LogChannel::Map, 7, "%s isn't cooked, loading %s", filename.c_str(), sourcePath.string().c_str());
+		return sourcePath.string();
+	}
+
+	const std::filesystem::file_time_type binaryTime = std::filesystem::last_write_time(filename, error);
+	const std::filesystem::file_time_type sourceTime = std::filesystem::last_write_time(sourcePath, error);
+	if (!error && binaryTime < sourceTime)
+	{
+		LogWarning(en::LogChannel::Map, 7, "%s is older than %s, loading it until it is cooked again", filename.c_str(), sourcePath.string().c_str());
+		return sourcePath.string();
+	}
+	return filename;
+}
+
+BinaryMapWriter::BinaryMapWriter()
+	: mData()
+{
+}
+
+void BinaryMapWriter::WriteU32(U32 value)
+{
+	mData.push_back(static_cast<U8>(value & 0xFF));
+	mData.push_back(static_cast<U8>((value >> 8) & 0xFF));
+	mData.push_back(static_cast<U8>((value >> 16) & 0xFF));
+	mData.push_back(static_cast<U8>((value >> 24) & 0xFF));
+}
+
+void BinaryMapWriter::WriteF32(F32 value)
+{
+	WriteU32(ConvertToU32Bytes(value));
+}
+
+void BinaryMapWriter::WriteString(const std::string& value)
+{
+	WriteU32(static_cast<U32>(value.size()));
+	mData.insert(mData.end(), value.begin(), value.end());
+}
+
+void BinaryMapWriter::WriteU32Array(const U32* values, U32 count)
+{
+	Align(BinaryMap::Alignment);
+	mData.reserve(mData.size() + count * 4);
+	for (U32 i = 0; i < count; ++i)
+	{
+		WriteU32(values[i]);
+	}
+}
+
+void BinaryMapWriter::Align(U32 alignment)
+{
+	while (mData.size() % alignment != 0)
+	{
+		mData.push_back(0);
+	}
+}
+
+void BinaryMapWriter::OverwriteU32(std::size_t offset, U32 value)
+{
+	assert(offset + 4 <= mData.size());
+	mData[offset] = static_cast<U8>(value & 0xFF);
+	mData[offset + 1] = static_cast<U8>((value >> 8) & 0xFF);
+	mData[offset + 2] = static_cast<U8>((value >> 16) & 0xFF);
+	mData[offset + 3] = static_cast<U8>((value >> 24) & 0xFF);
+}
+
+std::size_t BinaryMapWriter::GetSize() const
+{
+	return mData.size();
+}
+
+bool BinaryMapWriter::SaveToFile(const std::string& filename) const
+{
+	std::FILE* file = std::fopen(filename.c_str(), "wb");
+	if (file == nullptr)
+	{
+		return false;
+	}
+	const bool written = (std::fwrite(mData.data(), 1, mData.size(), file) == mData.size());
+	const bool closed = (std::fclose(file) == 0);
+	return written && closed;
+}
+
+BinaryMapReader::BinaryMapReader(const U8* data, std::size_t size)
+	: mData(data)
+	, mSize(size)
+	, mOffset(0)
+	, mValid(data != nullptr)
+{
+}
+
+U32 BinaryMapReader::ReadU32()
+{
+	if (const U8* bytes = Read(4))
+	{
+		return static_cast<U32>(bytes[0]) | (static_cast<U32>(bytes[1]) << 8) | (static_cast<U32>(bytes[2]) << 16) | (static_cast<U32>(bytes[3]) << 24);
+	}
+	return 0;
+}
+
+F32 BinaryMapReader::ReadF32()
+{
+	return ConvertToF32Bytes(ReadU32());
+}
+
+std::string BinaryMapReader::ReadString()
+{
+	const U32 size = ReadU32();
+	if (const U8* bytes = Read(size))
+	{
+		return std::string(reinterpret_cast<const char*>(bytes), size);
+	}
+	return std::string();
+}
+
+const U32* BinaryMapReader::ReadU32Array(U32 count)
+{
+	// The data starts on a page boundary once mapped, aligned offsets are aligned addresses
+	Read((BinaryMap::Alignment - mOffset % BinaryMap::Alignment) % BinaryMap::Alignment);
+	return reinterpret_cast<const U32*>(Read(static_cast<std::size_t>(count) * 4));
+}
+
+bool BinaryMapReader::IsValid() const
+{
+	return mValid;
+}
+
+std::size_t BinaryMapReader::GetOffset() const
+{
+	return mOffset;
+}
+
+const U8* BinaryMapReader::Read(std::size_t size)
+{
+	if (!mValid || size > mSize - mOffset)
+	{
+		mValid = false;
+		return nullptr;
+	}
+	const U8* bytes = mData + mOffset;
+	mOffset += size;
+	return bytes;
+}
+
+} // namespace tmx
+} // namespace en
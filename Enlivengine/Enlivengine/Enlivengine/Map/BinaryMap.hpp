@@ -0,0 +1,77 @@
+#pragma once
+
+#include <Enlivengine/System/PrimitiveTypes.hpp>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace en
+{
+namespace tmx
+{
+
+// Cooked maps : what the .tmx and its tilesets describe, stored to be used in place once the file is mapped
+// Every value is little-endian, strings are their size followed by their characters
+// The tiles of each layer start on an Alignment boundary so they are read as U32 without a copy
+namespace BinaryMap
+{
+	constexpr U32 Magic = 0x504D4E45; // "ENMP"
+	constexpr U32 Version = 1; // Cooked maps of another version are rejected, cook them again
+	constexpr U32 Alignment = 16;
+	constexpr const char* Extension = ".enmap";
+	constexpr const char* SourceExtension = ".tmx";
+
+	bool IsBinaryMapFilename(const std::string& filename);
+
+	// The file to load for filename : the .tmx next to a cooked map when the cooked map is missing or older than it
+	std::string GetLoadFilename(const std::string& filename);
+}
+
+class BinaryMapWriter
+{
+public:
+	BinaryMapWriter();
+
+	void WriteU32(U32 value);
+	void WriteF32(F32 value);
+	void WriteString(const std::string& value);
+	void WriteU32Array(const U32* values, U32 count);
+	void Align(U32 alignment);
+
+	// Values known once everything else is written, like the size of the file
+	void OverwriteU32(std::size_t offset, U32 value);
+
+	std::size_t GetSize() const;
+	bool SaveToFile(const std::string& filename) const;
+
+private:
+	std::vector<U8> mData;
+};
+
+// Reading past the end returns zeros and invalidates the reader, check IsValid once everything is read
+class BinaryMapReader
+{
+public:
+	BinaryMapReader(const U8* data, std::size_t size);
+
+	U32 ReadU32();
+	F32 ReadF32();
+	std::string ReadString();
+	// Pointer to count values in the data, aligned on BinaryMap::Alignment and still little-endian
+	const U32* ReadU32Array(U32 count);
+
+	bool IsValid() const;
+	std::size_t GetOffset() const;
+
+private:
+	const U8* Read(std::size_t size);
+
+	const U8* mData;
+	std::size_t mSize;
+	std::size_t mOffset;
+	bool mValid;
+};
+
+} // namespace tmx
+} // namespace en
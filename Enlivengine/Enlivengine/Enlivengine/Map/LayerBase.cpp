@@ -1,6 +1,7 @@
 #include <Enlivengine/Map/LayerBase.hpp>
 
 #include <Enlivengine/Map/Map.hpp>
+#include <Enlivengine/Map/BinaryMap.hpp>
 
 namespace en
 {
@@ -85,5 +86,28 @@ bool LayerBase::Parse(ParserXml& parser)
 	return true;
 }
 
+bool LayerBase::ParseBinary(BinaryMapReader& reader)
+{
+	mID = reader.ReadU32();
+	mName = reader.ReadString();
+	mOffset.x = reader.ReadF32();
+	mOffset.y = reader.ReadF32();
+	mOpacity = reader.ReadF32();
+	mVisible = (reader.ReadU32() != 0);
+	mLocked = (reader.ReadU32() != 0);
+	return reader.IsValid();
+}
+
+void LayerBase::WriteBinary(BinaryMapWriter& writer) const
+{
+	writer.WriteU32(mID);
+	writer.WriteString(mName);
+	writer.WriteF32(mOffset.x);
+	writer.WriteF32(mOffset.y);
+	writer.WriteF32(mOpacity);
+	writer.WriteU32(mVisible ? 1 : 0);
+	writer.WriteU32(mLocked ? 1 : 0);
+}
+
 } // namespace tmx
 } // namespace en
\ No newline at end of file
@@ -16,6 +16,8 @@ namespace tmx
 {
 
 class Map;
+class BinaryMapReader;
+class BinaryMapWriter;
 
 class LayerBase : public PropertyHolder
 {
@@ -49,6 +51,8 @@ public:
 
 protected:
 	bool Parse(ParserXml& parser);
+	bool ParseBinary(BinaryMapReader& reader);
+	void WriteBinary(BinaryMapWriter& writer) const;
 
 	Map& mMap;
 
@@ -10,6 +10,21 @@ namespace en
 {
 namespace tmx
 {
+
+namespace
+{
+
+// Cooked maps store the paths of their files relative to their own directory, like the .tmx
+std::string GetRelativePath(const std::string& path, const std::filesystem::path& directory)
+{
+	if (path.empty())
+	{
+		return path;
+	}
+	return std::filesystem::relative(std::filesystem::absolute(path), directory).generic_string();
+}
+
+} // namespace
 	
 Map::Map()
 	: mName("")
@@ -23,6 +38,9 @@ Map::Map()
 	, mHexSideLength(0)
 	, mNextLayerID(0)
 	, mNextObjectID(0)
+	, mTilesets()
+	, mMappedFile()
+	, mLayers()
 {
 }
 
@@ -258,6 +276,200 @@ bool Map::LoadFromFile(const std::string& filename)
 	return true;
 }
 
+bool Map::LoadFromBinaryFile(const std::string& filename)
+{
+	if (!mMappedFile.Open(filename))
+	{
+		LogError(en::LogChannel::Map, 9, "Can't open file at %s", filename.c_str());
+		return false;
+	}
+
+	BinaryMapReader reader(mMappedFile.GetData(), mMappedFile.GetSize());
+	if (reader.ReadU32() != BinaryMap::Magic)
+	{
+		LogError(en::LogChannel::Map, 9, "Invalid cooked map file at %s", filename.c_str());
+		return false;
+	}
+	const U32 version = reader.ReadU32();
+	if (version != BinaryMap::Version)
+	{
+		LogError(en::LogChannel::Map, 9, "%s was cooked with version %d instead of %d, cook it again", filename.c_str(), version, BinaryMap::Version);
+		return false;
+	}
+	if (reader.ReadU32() != mMappedFile.GetSize())
+	{
+		LogError(en::LogChannel::Map, 9, "Truncated cooked map file at %s", filename.c_str());
+		return false;
+	}
+
+	mName = reader.ReadString();
+	const U32 orientation = reader.ReadU32();
+	const U32 renderOrder = reader.ReadU32();
+	const U32 staggerAxis = reader.ReadU32();
+	const U32 staggerIndex = reader.ReadU32();
+	if (orientation > static_cast<U32>(Orientation::Hexagonal) || renderOrder > static_cast<U32>(RenderOrder::LeftUp) || staggerAxis > static_cast<U32>(StaggerAxis::Y) || staggerIndex > static_cast<U32>(StaggerIndex::Even))
+	{
+		LogError(en::LogChannel::Map, 9, "Invalid cooked map file at %s", filename.c_str());
+		return false;
+	}
+	mOrientation = static_cast<Orientation>(orientation);
+	mRenderOrder = static_cast<RenderOrder>(renderOrder);
+	mStaggerAxis = static_cast<StaggerAxis>(staggerAxis);
+	mStaggerIndex = static_cast<StaggerIndex>(staggerIndex);
+	mHexSideLength = reader.ReadU32();
+	mSize.x = reader.ReadU32();
+	mSize.y = reader.ReadU32();
+	mTileSize.x = reader.ReadU32();
+	mTileSize.y = reader.ReadU32();
+	mBackgroundColor.fromInteger(reader.ReadU32());
+	mNextLayerID = reader.ReadU32();
+	mNextObjectID = reader.ReadU32();
+
+	const std::string currentPath = std::filesystem::path(filename).remove_filename().string();
+	const U32 tilesetCount = reader.ReadU32();
+	for (U32 tilesetIndex = 0; tilesetIndex < tilesetCount && reader.IsValid(); ++tilesetIndex)
+	{
+		TilesetMapData tilesetData;
+		tilesetData.firstGid = reader.ReadU32();
+		const std::string source = reader.ReadString();
+		const std::string name = reader.ReadString();
+		Vector2u tileSize;
+		tileSize.x = reader.ReadU32();
+		tileSize.y = reader.ReadU32();
+		const U32 spacing = reader.ReadU32();
+		const U32 margin = reader.ReadU32();
+		const U32 tileCount = reader.ReadU32();
+		const U32 columns = reader.ReadU32();
+		const std::string imageSource = reader.ReadString();
+		const U32 imageTransparent = reader.ReadU32();
+
+		// Same tileset as the one loaded from its .tsx if there is one
+		if (source.size() > 0)
+		{
+			tilesetData.tileset = ResourceManager::GetInstance().GetFromFilename<Tileset>(currentPath + source);
+		}
+		if (!tilesetData.tileset.IsValid())
+		{
+			const std::string identifier = mName + "-tileset" + std::to_string(tilesetIndex);
+			tilesetData.tileset = ResourceManager::GetInstance().Create<Tileset>(identifier, ResourceLoader<Tileset>([&](Tileset& r)
+			{
+				r.mName = name;
+				r.mTileSize = tileSize;
+				r.mSpacing = spacing;
+				r.mMargin = margin;
+				r.mTileCount = tileCount;
+				r.mColumns = columns;
+				r.mPath = currentPath;
+				r.mImageSource = imageSource;
+				r.mImageTransparent.fromInteger(imageTransparent);
+				return r.LoadTexture(filename);
+			}));
+			if (!tilesetData.tileset.IsValid())
+			{
+				LogError(en::LogChannel::Map, 8, "Can't load tileset %s", name.c_str());
+				continue;
+			}
+		}
+		mTilesets.push_back(tilesetData);
+	}
+
+	const U32 layerCount = reader.ReadU32();
+	for (U32 layerIndex = 0; layerIndex < layerCount && reader.IsValid(); ++layerIndex)
+	{
+		const U32 layerType = reader.ReadU32();
+		if (layerType != static_cast<U32>(LayerBase::LayerType::TileLayer))
+		{
+			LogError(en::LogChannel::Map, 9, "Unknown layer type %d in %s", layerType, filename.c_str());
+			return false;
+		}
+		std::unique_ptr<TileLayer> layer = std::make_unique<TileLayer>(*this);
+		if (layer != nullptr && layer->ParseBinary(reader))
+		{
+			mLayers.emplace_back(std::move(layer));
+		}
+	}
+
+	if (!reader.IsValid())
+	{
+		LogError(en::LogChannel::Map, 9, "Invalid cooked map file at %s", filename.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+bool Map::SaveToBinaryFile(const std::string& filename) const
+{
+	BinaryMapWriter writer;
+	writer.WriteU32(BinaryMap::Magic);
+	writer.WriteU32(BinaryMap::Version);
+	const std::size_t fileSizeOffset = writer.GetSize();
+	writer.WriteU32(0);
+
+	writer.WriteString(mName);
+	writer.WriteU32(static_cast<U32>(mOrientation));
+	writer.WriteU32(static_cast<U32>(mRenderOrder));
+	writer.WriteU32(static_cast<U32>(mStaggerAxis));
+	writer.WriteU32(static_cast<U32>(mStaggerIndex));
+	writer.WriteU32(mHexSideLength);
+	writer.WriteU32(mSize.x);
+	writer.WriteU32(mSize.y);
+	writer.WriteU32(mTileSize.x);
+	writer.WriteU32(mTileSize.y);
+	writer.WriteU32(mBackgroundColor.toInteger());
+	writer.WriteU32(mNextLayerID);
+	writer.WriteU32(mNextObjectID);
+
+	const std::filesystem::path directory = std::filesystem::absolute(filename).parent_path();
+	writer.WriteU32(GetTilesetCount());
+	for (const TilesetMapData& tilesetData : mTilesets)
+	{
+		assert(tilesetData.tileset.IsValid());
+		const Tileset& tileset = tilesetData.tileset.Get();
+		writer.WriteU32(tilesetData.firstGid);
+		writer.WriteString(GetRelativePath(tileset.GetFilename(), directory));
+		writer.WriteString(tileset.GetName());
+		writer.WriteU32(tileset.GetTileSize().x);
+		writer.WriteU32(tileset.GetTileSize().y);
+		writer.WriteU32(tileset.GetSpacing());
+		writer.WriteU32(tileset.GetMargin());
+		writer.WriteU32(tileset.GetTileCount());
+		writer.WriteU32(tileset.GetColumns());
+		writer.WriteString(GetRelativePath(tileset.GetPath() + tileset.GetImageSource(), directory));
+		writer.WriteU32(tileset.GetImageTransparent().toInteger());
+	}
+
+	U32 tileLayerCount = 0;
+	for (const LayerBase::Ptr& layer : mLayers)
+	{
+		if (layer->GetLayerType() == LayerBase::LayerType::TileLayer)
+		{
+			tileLayerCount++;
+		}
+		else
+		{
+			LogWarning(en::LogChannel::Map, 7, "Only the tile layers are cooked, %s is skipped", layer->GetName().c_str());
+		}
+	}
+	writer.WriteU32(tileLayerCount);
+	for (const LayerBase::Ptr& layer : mLayers)
+	{
+		if (layer->GetLayerType() == LayerBase::LayerType::TileLayer)
+		{
+			writer.WriteU32(static_cast<U32>(LayerBase::LayerType::TileLayer));
+			static_cast<const TileLayer&>(*layer).WriteBinary(writer);
+		}
+	}
+
+	writer.OverwriteU32(fileSizeOffset, static_cast<U32>(writer.GetSize()));
+	if (!writer.SaveToFile(filename))
+	{
+		LogError(en::LogChannel::Map, 9, "Can't write cooked map file at %s", filename.c_str());
+		return false;
+	}
+	return true;
+}
+
 const std::string& Map::GetName() const
 {
 	return mName;
@@ -1,11 +1,13 @@
 #pragma once
 
 #include <Enlivengine/System/PrimitiveTypes.hpp>
+#include <Enlivengine/System/MappedFile.hpp>
 
 #include <Enlivengine/Math/Vector2.hpp>
 #include <Enlivengine/Graphics/SFMLResources.hpp>
 #include <Enlivengine/Graphics/Color.hpp>
 
+#include <Enlivengine/Map/BinaryMap.hpp>
 #include <Enlivengine/Map/PropertyHolder.hpp>
 #include <Enlivengine/Map/Tileset.hpp>
 #include <Enlivengine/Map/LayerBase.hpp>
@@ -52,6 +54,11 @@ public:
 
 	bool LoadFromFile(const std::string& filename);
 
+	// Cooked maps : the file stays mapped while the map is alive and the tile layers use their tiles in place
+	// Only the tile layers are cooked, the properties and object groups aren't yet
+	bool LoadFromBinaryFile(const std::string& filename);
+	bool SaveToBinaryFile(const std::string& filename) const;
+
 	const std::string& GetName() const;
 	const Vector2u& GetSize() const;
 	const Vector2u& GetTileSize() const;
@@ -109,6 +116,7 @@ private:
 	};
 	std::vector<TilesetMapData> mTilesets;
 
+	MappedFile mMappedFile;
 	std::vector<LayerBase::Ptr> mLayers;
 };
 
@@ -124,11 +132,24 @@ public:
 	{
 		return ResourceLoader<Map>([&filename](Map& r)
 		{
-			const bool result = r.LoadFromFile(filename);
+			const std::string loadFilename = BinaryMap::GetLoadFilename(filename);
+			const bool result = (BinaryMap::IsBinaryMapFilename(loadFilename)) ? r.LoadFromBinaryFile(loadFilename) : r.LoadFromFile(loadFilename);
 			r.mFilename = (result) ? filename : "";
 			return result;
 		});
 	}
+
+	// Maps use their tilesets through the ResourceManager : loaded on the main thread, once the resources requested before are finalized
+	static AsyncResourceLoader<Map> FromFileAsync(const std::string& filename)
+	{
+		return AsyncResourceLoader<Map>(ResourceLoader<Map>([filename](Map& r)
+		{
+			const std::string loadFilename = BinaryMap::GetLoadFilename(filename);
+			const bool result = (BinaryMap::IsBinaryMapFilename(loadFilename)) ? r.LoadFromBinaryFile(loadFilename) : r.LoadFromFile(loadFilename);
+			r.mFilename = (result) ? filename : "";
+			return result;
+		}));
+	}
 };
 
 } // namespace tmx
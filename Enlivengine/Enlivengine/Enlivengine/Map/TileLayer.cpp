@@ -1,8 +1,11 @@
 #include <Enlivengine/Map/TileLayer.hpp>
 
+#include <Enlivengine/Map/BinaryMap.hpp>
 #include <Enlivengine/System/Compression.hpp>
+#include <Enlivengine/System/Endianness.hpp>
 #include <Enlivengine/System/String.hpp>
 
+#include <cmath>
 #include <sstream>
 
 namespace en
@@ -16,7 +19,10 @@ TileLayer::TileLayer(Map& map)
 	, mEncoding(EncodingType::Base64)
 	, mCompression(CompressionType::Zlib)
 	, mTiles()
-	, mVertexArrays()
+	, mTileData(nullptr)
+	, mChunkCount(0, 0)
+	, mChunks()
+	, mMaxTileOverflow(0.0f)
 {
 }
 
@@ -40,43 +46,17 @@ void TileLayer::SetTile(const Vector2u& tileCoords, U32 tileID)
 	assert(tileCoords.x < mSize.x);
 	assert(tileCoords.y < mSize.y);
 	const U32 tileIndex = tileCoords.y * mSize.x + tileCoords.x;
-	assert(tileIndex < static_cast<U32>(mTiles.size()));
-	const U32 vertexIndex = tileIndex * 4;
-
-	const U32 previousTileID = mTiles[tileIndex];
-	const U32 previousTilesetIndex = mMap.GetTilesetIndexFromGID(previousTileID);
-	const U32 tilesetIndex = mMap.GetTilesetIndexFromGID(tileID);
-	
-	// Reset previous tile if needed
-	if ((tilesetIndex != previousTilesetIndex || tileID == 0) && previousTileID > 0 && previousTilesetIndex < mMap.GetTilesetCount())
+	assert(tileIndex < mSize.x * mSize.y);
+	if (mTileData[tileIndex] != tileID)
 	{
-		sf::Vertex* quad = &mVertexArrays[previousTilesetIndex][vertexIndex];
-		quad[0].texCoords = sf::Vector2f(0.0f, 0.0f);
-		quad[1].texCoords = sf::Vector2f(0.0f, 0.0f);
-		quad[2].texCoords = sf::Vector2f(0.0f, 0.0f);
-		quad[3].texCoords = sf::Vector2f(0.0f, 0.0f);
-	}
-
-	// Update new tile if needed
-	mTiles[tileIndex] = tileID;
-	if (tileID > 0 && tilesetIndex < mMap.GetTilesetCount())
-	{
-		TilesetPtr tilesetPtr = mMap.GetTileset(tilesetIndex);
-		if (tilesetPtr.IsValid())
+		if (mTiles.empty())
 		{
-			const Tileset& tileset = tilesetPtr.Get();
-
-            const U32 localTileID = tileID - mMap.GetTilesetFirstGid(tilesetIndex);
-			const Vector2u& tilesetTileSize = tileset.GetTileSize();
-			const Vector2f pos(tileset.ToPos(localTileID));
-			const Vector2f texSize(static_cast<F32>(tilesetTileSize.x), static_cast<F32>(tilesetTileSize.y));
-
-			sf::Vertex* quad = &mVertexArrays[tilesetIndex][vertexIndex];
-			quad[0].texCoords = sf::Vector2f(pos.x, pos.y);
-			quad[1].texCoords = sf::Vector2f(pos.x + texSize.x, pos.y);
-			quad[2].texCoords = sf::Vector2f(pos.x + texSize.x, pos.y + texSize.y);
-			quad[3].texCoords = sf::Vector2f(pos.x, pos.y + texSize.y);
+			// The mapped file is read-only
+			mTiles.assign(mTileData, mTileData + mSize.x * mSize.y);
+			mTileData = mTiles.data();
 		}
+		mTiles[tileIndex] = tileID;
+		GetChunk(tileCoords).dirty = true;
 	}
 }
 
@@ -85,29 +65,52 @@ U32 TileLayer::GetTile(const Vector2u& tileCoords) const
 	assert(tileCoords.x < mSize.x);
 	assert(tileCoords.y < mSize.y);
 	const U32 index = tileCoords.y * mSize.x + tileCoords.x;
-	assert(index < static_cast<U32>(mTiles.size()));
-	return mTiles[index];
+	assert(index < mSize.x * mSize.y);
+	return mTileData[index];
 }
 
 void TileLayer::Render(sf::RenderTarget& target) const
 {
-    const U32 size = static_cast<U32>(mVertexArrays.size());
-    assert(size <= mMap.GetTilesetCount());
-    for (U32 i = 0; i < size; ++i)
-    {
-        sf::RenderStates states;
-
-        const TilesetPtr& tilesetPtr = mMap.GetTileset(i);
-        assert(tilesetPtr.IsValid());
-        const Tileset& tileset = tilesetPtr.Get();
-
-        const TexturePtr& texturePtr = tileset.GetTexture();
-        assert(texturePtr.IsValid());
-        const Texture& texture = texturePtr.Get();
-
-        states.texture = &texture;
-        target.draw(mVertexArrays[i], states);
-    }
+	// World area seen through the view, its bounding box when the view is rotated
+	const sf::FloatRect viewBounds = target.getView().getInverseTransform().transformRect(sf::FloatRect(-1.0f, -1.0f, 2.0f, 2.0f));
+
+	if (mMap.GetOrientation() == Map::Orientation::Orthogonal)
+	{
+		// The chunks are a grid of the world : only the ones under the view are visited
+		// Tiles taller than the map tiles overflow on the cells above, so the view reaches the chunks below
+		const Vector2u& tileSize = mMap.GetTileSize();
+		const F32 chunkWidth = static_cast<F32>(ChunkSize * tileSize.x);
+		const F32 chunkHeight = static_cast<F32>(ChunkSize * tileSize.y);
+		const I32 minX = static_cast<I32>(std::floor(viewBounds.left / chunkWidth));
+		const I32 minY = static_cast<I32>(std::floor(viewBounds.top / chunkHeight));
+		const I32 maxX = static_cast<I32>(std::floor((viewBounds.left + viewBounds.width) / chunkWidth));
+		const I32 maxY = static_cast<I32>(std::floor((viewBounds.top + viewBounds.height + mMaxTileOverflow) / chunkHeight));
+		const I32 firstX = (minX > 0) ? minX : 0;
+		const I32 firstY = (minY > 0) ? minY : 0;
+		const I32 lastX = (maxX < static_cast<I32>(mChunkCount.x) - 1) ? maxX : static_cast<I32>(mChunkCount.x) - 1;
+		const I32 lastY = (maxY < static_cast<I32>(mChunkCount.y) - 1) ? maxY : static_cast<I32>(mChunkCount.y) - 1;
+		for (I32 y = firstY; y <= lastY; ++y)
+		{
+			for (I32 x = firstX; x <= lastX; ++x)
+			{
+				Chunk& chunk = mChunks[x + y * mChunkCount.x];
+				if (chunk.bounds.intersects(viewBounds))
+				{
+					RenderChunk(target, chunk);
+				}
+			}
+		}
+	}
+	else
+	{
+		for (Chunk& chunk : mChunks)
+		{
+			if (chunk.bounds.intersects(viewBounds))
+			{
+				RenderChunk(target, chunk);
+			}
+		}
+	}
 }
 
 bool TileLayer::Parse(ParserXml& parser)
@@ -120,6 +123,8 @@ bool TileLayer::Parse(ParserXml& parser)
 	parser.getAttribute("width", mSize.x);
 	parser.getAttribute("height", mSize.y);
 
+	mTiles.assign(mSize.x * mSize.y, 0);
+	mTileData = mTiles.data();
 	Update();
 
 	if (parser.readNode("data"))
@@ -292,36 +297,154 @@ bool TileLayer::ParseXml(ParserXml& parser)
 	}
 }
 
-void TileLayer::Update()
+bool TileLayer::ParseBinary(BinaryMapReader& reader)
 {
+	if (!LayerBase::ParseBinary(reader))
+	{
+		return false;
+	}
+
+	mSize.x = reader.ReadU32();
+	mSize.y = reader.ReadU32();
+	mEncoding = static_cast<EncodingType>(reader.ReadU32());
+	mCompression = static_cast<CompressionType>(reader.ReadU32());
 	const U32 tileCount = mSize.x * mSize.y;
-	mTiles.resize(tileCount, 0);
-	mVertexArrays.resize(mMap.GetTilesetCount());
-	for (sf::VertexArray& vertexArray : mVertexArrays)
+	const U32* tiles = reader.ReadU32Array(tileCount);
+	if (!reader.IsValid())
 	{
-		const U32 vertexCount = tileCount * 4;
-		vertexArray.setPrimitiveType(sf::Quads);
-		vertexArray.resize(vertexCount);
+		return false;
+	}
+
+	if (GetPlatformEndianness() == Endianness::LittleEndian)
+	{
+		mTiles.clear();
+		mTileData = tiles;
+	}
+	else
+	{
+		mTiles.resize(tileCount);
+		for (U32 i = 0; i < tileCount; ++i)
+		{
+			mTiles[i] = swapU32(tiles[i]);
+		}
+		mTileData = mTiles.data();
+	}
+	Update();
+
+	return true;
+}
+
+void TileLayer::WriteBinary(BinaryMapWriter& writer) const
+{
+	LayerBase::WriteBinary(writer);
+	writer.WriteU32(mSize.x);
+	writer.WriteU32(mSize.y);
+	writer.WriteU32(static_cast<U32>(mEncoding));
+	writer.WriteU32(static_cast<U32>(mCompression));
+	writer.WriteU32Array(mTileData, mSize.x * mSize.y);
+}
+
+void TileLayer::Update()
+{
+	mChunkCount.x = (mSize.x + ChunkSize - 1) / ChunkSize;
+	mChunkCount.y = (mSize.y + ChunkSize - 1) / ChunkSize;
+	mChunks.resize(mChunkCount.x * mChunkCount.y);
+
+	const U32 tilesetCount = mMap.GetTilesetCount();
+	const Vector2u& mapTileSize = mMap.GetTileSize();
+	F32 maxDeltaY = 0.0f;
+	for (U32 tilesetIndex = 0; tilesetIndex < tilesetCount; ++tilesetIndex)
+	{
+		const F32 deltaY = GetTileOverflow(tilesetIndex);
+		maxDeltaY = (tilesetIndex == 0 || deltaY > maxDeltaY) ? deltaY : maxDeltaY;
+	}
+	mMaxTileOverflow = (maxDeltaY > 0.0f) ? maxDeltaY : 0.0f;
+
+	Vector2u chunkCoords;
+	for (chunkCoords.y = 0; chunkCoords.y < mChunkCount.y; ++chunkCoords.y)
+	{
+		for (chunkCoords.x = 0; chunkCoords.x < mChunkCount.x; ++chunkCoords.x)
+		{
+			Chunk& chunk = mChunks[chunkCoords.x + chunkCoords.y * mChunkCount.x];
+			chunk.firstTile = Vector2u(chunkCoords.x * ChunkSize, chunkCoords.y * ChunkSize);
+			chunk.size.x = (mSize.x - chunk.firstTile.x < ChunkSize) ? mSize.x - chunk.firstTile.x : ChunkSize;
+			chunk.size.y = (mSize.y - chunk.firstTile.y < ChunkSize) ? mSize.y - chunk.firstTile.y : ChunkSize;
+			chunk.bounds = sf::FloatRect();
+			chunk.vertexArrays.clear();
+			chunk.tileCounts.assign(tilesetCount, 0);
+			chunk.dirty = true;
+
+			if (tilesetCount == 0)
+			{
+				continue;
+			}
+
+			// Area of the quads BuildChunk will write, without writing them
+			F32 left = 0.0f;
+			F32 top = 0.0f;
+			F32 right = 0.0f;
+			F32 bottom = 0.0f;
+			Vector2u tileCoords;
+			for (tileCoords.y = chunk.firstTile.y; tileCoords.y < chunk.firstTile.y + chunk.size.y; ++tileCoords.y)
+			{
+				for (tileCoords.x = chunk.firstTile.x; tileCoords.x < chunk.firstTile.x + chunk.size.x; ++tileCoords.x)
+				{
+					const Vector2f pos = mMap.CoordsToWorld(tileCoords);
+					const bool firstTile = (tileCoords == chunk.firstTile);
+					left = (firstTile || pos.x < left) ? pos.x : left;
+					top = (firstTile || pos.y - maxDeltaY < top) ? pos.y - maxDeltaY : top;
+					right = (firstTile || pos.x + static_cast<F32>(mapTileSize.x) > right) ? pos.x + static_cast<F32>(mapTileSize.x) : right;
+					bottom = (firstTile || pos.y + static_cast<F32>(mapTileSize.y) > bottom) ? pos.y + static_cast<F32>(mapTileSize.y) : bottom;
+				}
+			}
+			chunk.bounds = sf::FloatRect(left, top, right - left, bottom - top);
+		}
 	}
+}
 
+TileLayer::Chunk& TileLayer::GetChunk(const Vector2u& tileCoords)
+{
+	const U32 chunkIndex = (tileCoords.x / ChunkSize) + (tileCoords.y / ChunkSize) * mChunkCount.x;
+	assert(chunkIndex < static_cast<U32>(mChunks.size()));
+	return mChunks[chunkIndex];
+}
+
+U32 TileLayer::GetVertexIndex(const Chunk& chunk, const Vector2u& tileCoords) const
+{
+	return ((tileCoords.x - chunk.firstTile.x) + (tileCoords.y - chunk.firstTile.y) * chunk.size.x) * 4;
+}
+
+F32 TileLayer::GetTileOverflow(U32 tilesetIndex) const
+{
+	TilesetPtr tilesetPtr = mMap.GetTileset(tilesetIndex);
+	const Vector2u& mapTileSize = mMap.GetTileSize();
+	const Vector2u& tilesetTileSize = (tilesetPtr.IsValid()) ? tilesetPtr.Get().GetTileSize() : mapTileSize;
+	return static_cast<F32>(tilesetTileSize.y) - static_cast<F32>(mapTileSize.y);
+}
+
+void TileLayer::BuildChunk(Chunk& chunk) const
+{
+	const U32 tilesetCount = static_cast<U32>(chunk.tileCounts.size());
+	assert(tilesetCount <= mMap.GetTilesetCount());
 	const sf::Color color = sf::Color(255, 255, 255);
 	const Vector2u& mapTileSize = mMap.GetTileSize();
-	const U32 vertexArrayCount = static_cast<U32>(mVertexArrays.size());
-	for (U32 vertexArrayIndex = 0; vertexArrayIndex < vertexArrayCount; ++vertexArrayIndex)
+	chunk.vertexArrays.resize(tilesetCount);
+	for (U32 tilesetIndex = 0; tilesetIndex < tilesetCount; ++tilesetIndex)
 	{
-		TilesetPtr tilesetPtr = mMap.GetTileset(vertexArrayIndex);
-		const Vector2u& tilesetTileSize = (tilesetPtr.IsValid()) ? tilesetPtr.Get().GetTileSize() : mapTileSize;
-		const F32 deltaY = static_cast<F32>(tilesetTileSize.y - mapTileSize.y);
+		const F32 deltaY = GetTileOverflow(tilesetIndex);
+
+		sf::VertexArray& vertexArray = chunk.vertexArrays[tilesetIndex];
+		vertexArray.setPrimitiveType(sf::Quads);
+		vertexArray.resize(chunk.size.x * chunk.size.y * 4);
 
 		Vector2u tileCoords;
-		for (tileCoords.x = 0; tileCoords.x < mSize.x; ++tileCoords.x)
+		for (tileCoords.y = chunk.firstTile.y; tileCoords.y < chunk.firstTile.y + chunk.size.y; ++tileCoords.y)
 		{
-			for (tileCoords.y = 0; tileCoords.y < mSize.y; ++tileCoords.y)
+			for (tileCoords.x = chunk.firstTile.x; tileCoords.x < chunk.firstTile.x + chunk.size.x; ++tileCoords.x)
 			{
-				const U32 vertexIndex = (tileCoords.x + tileCoords.y * mSize.x) * 4;
 				const Vector2f pos = mMap.CoordsToWorld(tileCoords);
 
-				sf::Vertex* quad = &mVertexArrays[vertexArrayIndex][vertexIndex];
+				sf::Vertex* quad = &vertexArray[GetVertexIndex(chunk, tileCoords)];
 				quad[0].position = sf::Vector2f(pos.x, pos.y - deltaY);
 				quad[1].position = sf::Vector2f(pos.x + static_cast<F32>(mapTileSize.x), pos.y - deltaY);
 				quad[2].position = sf::Vector2f(pos.x + static_cast<F32>(mapTileSize.x), pos.y + static_cast<F32>(mapTileSize.y));
@@ -333,6 +456,94 @@ void TileLayer::Update()
 			}
 		}
 	}
+	chunk.dirty = true;
+}
+
+void TileLayer::UpdateChunk(Chunk& chunk) const
+{
+	const U32 tilesetCount = static_cast<U32>(chunk.vertexArrays.size());
+	assert(tilesetCount <= mMap.GetTilesetCount());
+	for (U32& tileCount : chunk.tileCounts)
+	{
+		tileCount = 0;
+	}
+
+	Vector2u tileCoords;
+	for (tileCoords.y = chunk.firstTile.y; tileCoords.y < chunk.firstTile.y + chunk.size.y; ++tileCoords.y)
+	{
+		for (tileCoords.x = chunk.firstTile.x; tileCoords.x < chunk.firstTile.x + chunk.size.x; ++tileCoords.x)
+		{
+			const U32 vertexIndex = GetVertexIndex(chunk, tileCoords);
+			for (sf::VertexArray& vertexArray : chunk.vertexArrays)
+			{
+				sf::Vertex* quad = &vertexArray[vertexIndex];
+				quad[0].texCoords = sf::Vector2f(0.0f, 0.0f);
+				quad[1].texCoords = sf::Vector2f(0.0f, 0.0f);
+				quad[2].texCoords = sf::Vector2f(0.0f, 0.0f);
+				quad[3].texCoords = sf::Vector2f(0.0f, 0.0f);
+			}
+
+			const U32 tileID = mTileData[tileCoords.y * mSize.x + tileCoords.x];
+			const U32 tilesetIndex = mMap.GetTilesetIndexFromGID(tileID);
+			if (tileID > 0 && tilesetIndex < tilesetCount)
+			{
+				chunk.tileCounts[tilesetIndex]++;
+
+				TilesetPtr tilesetPtr = mMap.GetTileset(tilesetIndex);
+				if (tilesetPtr.IsValid())
+				{
+					const Tileset& tileset = tilesetPtr.Get();
+
+					const U32 localTileID = tileID - mMap.GetTilesetFirstGid(tilesetIndex);
+					const Vector2u& tilesetTileSize = tileset.GetTileSize();
+					const Vector2f pos(tileset.ToPos(localTileID));
+					const Vector2f texSize(static_cast<F32>(tilesetTileSize.x), static_cast<F32>(tilesetTileSize.y));
+
+					sf::Vertex* quad = &chunk.vertexArrays[tilesetIndex][vertexIndex];
+					quad[0].texCoords = sf::Vector2f(pos.x, pos.y);
+					quad[1].texCoords = sf::Vector2f(pos.x + texSize.x, pos.y);
+					quad[2].texCoords = sf::Vector2f(pos.x + texSize.x, pos.y + texSize.y);
+					quad[3].texCoords = sf::Vector2f(pos.x, pos.y + texSize.y);
+				}
+			}
+		}
+	}
+	chunk.dirty = false;
+}
+
+void TileLayer::RenderChunk(sf::RenderTarget& target, Chunk& chunk) const
+{
+	if (chunk.vertexArrays.size() != chunk.tileCounts.size())
+	{
+		BuildChunk(chunk);
+	}
+	if (chunk.dirty)
+	{
+		UpdateChunk(chunk);
+	}
+
+	const U32 size = static_cast<U32>(chunk.vertexArrays.size());
+	assert(size <= mMap.GetTilesetCount());
+	for (U32 i = 0; i < size; ++i)
+	{
+		if (chunk.tileCounts[i] == 0)
+		{
+			continue;
+		}
+
+		sf::RenderStates states;
+
+		const TilesetPtr& tilesetPtr = mMap.GetTileset(i);
+		assert(tilesetPtr.IsValid());
+		const Tileset& tileset = tilesetPtr.Get();
+
+		const TexturePtr& texturePtr = tileset.GetTexture();
+		assert(texturePtr.IsValid());
+		const Texture& texture = texturePtr.Get();
+
+		states.texture = &texture;
+		target.draw(chunk.vertexArrays[i], states);
+	}
 }
 
 } // namespace tmx
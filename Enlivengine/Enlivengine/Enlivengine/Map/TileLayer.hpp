@@ -38,9 +38,14 @@ public:
 	EncodingType GetEncoding() const;
 	CompressionType GetCompression() const;
 
+	// Only marks the chunk of the tile, its vertices are updated when it is drawn next
 	void SetTile(const Vector2u& tileCoords, U32 tileID);
 	U32 GetTile(const Vector2u& tileCoords) const;
 
+	// Tiles are grouped in chunks of ChunkSize x ChunkSize, each with its own bounds and vertex arrays
+	static constexpr U32 ChunkSize = 16;
+
+	// Only the chunks intersecting the view of the target are drawn
     virtual void Render(sf::RenderTarget& target) const;
 
 private:
@@ -51,13 +56,37 @@ private:
 	bool ParseCsv(ParserXml& parser);
 	bool ParseXml(ParserXml& parser);
 
+	// Cooked maps : the tiles stay in the mapped file until one of them changes
+	bool ParseBinary(BinaryMapReader& reader);
+	void WriteBinary(BinaryMapWriter& writer) const;
+
 	void Update();
 
+	struct Chunk
+	{
+		Vector2u firstTile;
+		Vector2u size; // Smaller than ChunkSize on the right and bottom borders
+		sf::FloatRect bounds; // World area covered by its quads, tiles taller than the map tiles included
+		std::vector<sf::VertexArray> vertexArrays; // One per tileset, a quad per tile of the chunk, built when the chunk is first drawn
+		std::vector<U32> tileCounts; // Tiles of each tileset, the empty arrays are not drawn
+		bool dirty; // Tiles changed since the texCoords and tileCounts were written
+	};
+
+	Chunk& GetChunk(const Vector2u& tileCoords);
+	U32 GetVertexIndex(const Chunk& chunk, const Vector2u& tileCoords) const;
+	F32 GetTileOverflow(U32 tilesetIndex) const;
+	void BuildChunk(Chunk& chunk) const;
+	void UpdateChunk(Chunk& chunk) const;
+	void RenderChunk(sf::RenderTarget& target, Chunk& chunk) const;
+
 	Vector2u mSize;
 	EncodingType mEncoding;
 	CompressionType mCompression;
-	std::vector<U32> mTiles;
-	std::vector<sf::VertexArray> mVertexArrays;
+	std::vector<U32> mTiles; // Empty while the tiles are read in place from a cooked map
+	const U32* mTileData; // mTiles or the tiles of the cooked map
+	Vector2u mChunkCount;
+	mutable std::vector<Chunk> mChunks; // Row by row, built and updated by Render
+	F32 mMaxTileOverflow; // How far above their cell the tallest tiles go, widens the view for the culling
 };
 
 } // namespace tmx
@@ -23,6 +23,11 @@ Tileset::Tileset()
 }
 
 bool Tileset::LoadFromFile(const std::string& filename)
+{
+	return ParseFile(filename) && LoadTexture(filename);
+}
+
+bool Tileset::ParseFile(const std::string& filename)
 {
 	ParserXml xml;
 	if (!xml.loadFromFile(filename))
@@ -65,7 +70,12 @@ bool Tileset::LoadFromFile(const std::string& filename)
 		return false;
 	}
 
-    // Update texture
+	return true;
+}
+
+bool Tileset::LoadTexture(const std::string& filename)
+{
+	ENLIVE_UNUSED(filename); // Only logged
     const std::string filepath = mPath + mImageSource;
     if (mImageTransparent != Color::Transparent)
     {
@@ -17,6 +17,9 @@ class Tileset : public Resource<Tileset>
 		Tileset();
 
 		bool LoadFromFile(const std::string& filename);
+		// LoadFromFile in two steps : ParseFile only reads the file, LoadTexture uses the ResourceManager
+		bool ParseFile(const std::string& filename);
+		bool LoadTexture(const std::string& filename);
 
 		const Vector2u& GetTileSize() const;
 		U32 GetSpacing() const;
@@ -34,6 +37,8 @@ class Tileset : public Resource<Tileset>
 		Vector2f ToPos(U32 tileId) const;
 
 	private:
+		friend class Map; // Fills the tilesets cooked in binary maps
+
 		Vector2u mTileSize;
 		U32 mSpacing;
 		U32 mMargin;
@@ -65,6 +70,20 @@ public:
 			return result;
 		});
 	}
+
+	static AsyncResourceLoader<Tileset> FromFileAsync(const std::string& filename)
+	{
+		return AsyncResourceLoader<Tileset>([filename](Tileset& r)
+		{
+			return r.ParseFile(filename);
+		},
+		[filename](Tileset& r)
+		{
+			const bool result = r.LoadTexture(filename);
+			r.mFilename = (result) ? filename : "";
+			return result;
+		});
+	}
 };
 
 } // namespace tmx
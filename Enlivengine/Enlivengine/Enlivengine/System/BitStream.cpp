@@ -0,0 +1,164 @@
+#include <Enlivengine/System/BitStream.hpp>
+
+#include <Enlivengine/System/Assert.hpp>
+
+#include <cmath>
+
+namespace en
+{
+
+static U32 GetMaxQuantizedValue(U32 bits)
+{
+	return (bits >= 32) ? U32_Max : (1u << bits) - 1;
+}
+
+F32 BitQuantization::GetResolution() const
+{
+	return (max - min) / static_cast<F32>(GetMaxQuantizedValue(bits));
+}
+
+U32 BitQuantization::Quantize(F32 value) const
+{
+	assert(min < max);
+	assert(bits >= 1 && bits <= 32);
+	if (!(value > min)) // Also catches NaN
+	{
+		return 0;
+	}
+	const U32 maxValue = GetMaxQuantizedValue(bits);
+	if (value >= max)
+	{
+		return maxValue;
+	}
+	const F64 normalized = static_cast<F64>(value - min) / static_cast<F64>(max - min);
+	return static_cast<U32>(normalized * static_cast<F64>(maxValue) + 0.5);
+}
+
+F32 BitQuantization::Dequantize(U32 value) const
+{
+	const F64 normalized = static_cast<F64>(value) / static_cast<F64>(GetMaxQuantizedValue(bits));
+	return static_cast<F32>(static_cast<F64>(min) + normalized * static_cast<F64>(max - min));
+}
+
+BitWriter::BitWriter()
+	: mData()
+	, mBitCount(0)
+{
+}
+
+void BitWriter::WriteBits(U32 value, U32 bitCount)
+{
+	assert(bitCount >= 1 && bitCount <= 32);
+	assert(bitCount == 32 || (value >> bitCount) == 0);
+	const std::size_t byteCount = (mBitCount + bitCount + 7) >> 3;
+	while (mData.size() < byteCount)
+	{
+		mData.push_back(0);
+	}
+	// At most 39 bits, spread over 5 bytes
+	U64 bits = static_cast<U64>(value) << (mBitCount & 7);
+	for (U32 byteIndex = mBitCount >> 3; bits != 0; ++byteIndex)
+	{
+		mData[byteIndex] |= static_cast<U8>(bits);
+		bits >>= 8;
+	}
+	mBitCount += bitCount;
+}
+
+void BitWriter::WriteBool(bool value)
+{
+	WriteBits(value ? 1 : 0, 1);
+}
+
+void BitWriter::WriteVarU32(U32 value)
+{
+	// Groups of 7 bits, each followed by a continuation bit
+	while (value >= 0x80)
+	{
+		WriteBits((value & 0x7F) | 0x80, 8);
+		value >>= 7;
+	}
+	WriteBits(value, 8);
+}
+
+void BitWriter::WriteF32(F32 value)
+{
+	U32F32 u;
+	u.m_asF32 = value;
+	WriteBits(u.m_asU32, 32);
+}
+
+void BitWriter::WriteFloat(F32 value, const BitQuantization& quantization)
+{
+	WriteBits(quantization.Quantize(value), quantization.bits);
+}
+
+void BitWriter::Clear()
+{
+	mData.clear();
+	mBitCount = 0;
+}
+
+BitReader::BitReader(const void* data, U32 byteCount)
+	: mData(static_cast<const U8*>(data))
+	, mBitSize((data != nullptr) ? byteCount * 8 : 0)
+	, mBitCount(0)
+	, mValid(true)
+{
+}
+
+U32 BitReader::ReadBits(U32 bitCount)
+{
+	assert(bitCount >= 1 && bitCount <= 32);
+	if (!mValid || bitCount > mBitSize - mBitCount)
+	{
+		mValid = false;
+		return 0;
+	}
+	const U32 firstByte = mBitCount >> 3;
+	const U32 lastByte = (mBitCount + bitCount - 1) >> 3;
+	U64 bits = 0;
+	for (U32 byteIndex = lastByte + 1; byteIndex > firstByte; --byteIndex)
+	{
+		bits = (bits << 8) | mData[byteIndex - 1];
+	}
+	bits >>= (mBitCount & 7);
+	mBitCount += bitCount;
+	return static_cast<U32>(bits & ((bitCount >= 32) ? 0xFFFFFFFFull : ((1ull << bitCount) - 1)));
+}
+
+bool BitReader::ReadBool()
+{
+	return ReadBits(1) != 0;
+}
+
+U32 BitReader::ReadVarU32()
+{
+	U32 value = 0;
+	for (U32 shift = 0; shift < 35 && mValid; shift += 7)
+	{
+		const U32 byte = ReadBits(8);
+		value |= (byte & 0x7F) << shift;
+		if ((byte & 0x80) == 0)
+		{
+			return value;
+		}
+	}
+	// More than 5 groups can't come from WriteVarU32
+	mValid = false;
+	return 0;
+}
+
+F32 BitReader::ReadF32()
+{
+	U32F32 u;
+	u.m_asU32 = ReadBits(32);
+	return u.m_asF32;
+}
+
+F32 BitReader::ReadFloat(const BitQuantization& quantization)
+{
+	return quantization.Dequantize(ReadBits(quantization.bits));
+}
+
+} // namespace en
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <Enlivengine/System/PrimitiveTypes.hpp>
+
+#include <vector>
+
+namespace en
+{
+
+// Maps a float in [min, max] to an integer of bits bits
+// The resolution is (max - min) / (2^bits - 1), values outside the range are clamped
+struct BitQuantization
+{
+	constexpr BitQuantization(F32 pMin, F32 pMax, U32 pBits) : min(pMin), max(pMax), bits(pBits) {}
+
+	F32 GetResolution() const;
+	U32 Quantize(F32 value) const;
+	F32 Dequantize(U32 value) const;
+
+	F32 min;
+	F32 max;
+	U32 bits; // [1, 32]
+};
+
+// Bits needed to store any value in [0, maxValue]
+constexpr U32 GetBitsRequired(U32 maxValue)
+{
+	U32 bits = 0;
+	while (maxValue > 0)
+	{
+		bits++;
+		maxValue >>= 1;
+	}
+	return (bits > 0) ? bits : 1;
+}
+
+// Packs values into the smallest number of bits, least significant bits first
+// The data is always padded to a whole byte, so it can be appended to a packet at any time
+class BitWriter
+{
+public:
+	BitWriter();
+
+	void WriteBits(U32 value, U32 bitCount);
+	void WriteBool(bool value);
+	void WriteVarU32(U32 value); // 8 bits for values below 128, up to 40 bits
+	void WriteF32(F32 value); // Lossless
+	void WriteFloat(F32 value, const BitQuantization& quantization);
+
+	// Keep the capacity
+	void Clear();
+
+	const U8* GetData() const { return mData.data(); }
+	U32 GetBitCount() const { return mBitCount; }
+	U32 GetByteCount() const { return static_cast<U32>(mData.size()); }
+
+private:
+	std::vector<U8> mData;
+	U32 mBitCount;
+};
+
+// Reads what a BitWriter wrote, the data must stay alive while reading
+// Reading past the end returns 0 and invalidates the reader, like a failed sf::Packet
+class BitReader
+{
+public:
+	BitReader(const void* data, U32 byteCount);
+
+	U32 ReadBits(U32 bitCount);
+	bool ReadBool();
+	U32 ReadVarU32();
+	F32 ReadF32();
+	F32 ReadFloat(const BitQuantization& quantization);
+
+	bool IsValid() const { return mValid; }
+	// When a value read doesn't make sense to the caller
+	void Invalidate() { mValid = false; }
+	U32 GetRemainingBits() const { return mBitSize - mBitCount; }
+
+	explicit operator bool() const { return mValid; }
+
+private:
+	const U8* mData;
+	U32 mBitSize;
+	U32 mBitCount;
+	bool mValid;
+};
+
+} // namespace en
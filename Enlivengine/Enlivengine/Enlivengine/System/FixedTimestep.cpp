@@ -0,0 +1,63 @@
+#include <Enlivengine/System/FixedTimestep.hpp>
+
+#include <Enlivengine/System/Assert.hpp>
+
+namespace en
+{
+
+FixedTimestep::FixedTimestep(Time interval, U32 maxSteps)
+	: mInterval(interval)
+	, mAccumulator(Time::Zero)
+	, mMaxSteps(maxSteps)
+	, mOverrunCount(0)
+	, mDroppedStepCount(0)
+	, mMaxDueStepCount(0)
+{
+	assert(interval > Time::Zero);
+}
+
+U32 FixedTimestep::Advance(Time dt)
+{
+	mAccumulator += dt;
+	if (mAccumulator < mInterval)
+	{
+		return 0;
+	}
+
+	const U64 dueSteps = static_cast<U64>(mAccumulator.getTicks() / mInterval.getTicks());
+	mAccumulator = mAccumulator % mInterval;
+
+	const U32 dueStepCount = (dueSteps < U32_Max) ? static_cast<U32>(dueSteps) : U32_Max;
+	if (dueStepCount > mMaxDueStepCount)
+	{
+		mMaxDueStepCount = dueStepCount;
+	}
+	if (dueStepCount > mMaxSteps)
+	{
+		mOverrunCount++;
+		mDroppedStepCount += dueStepCount - mMaxSteps;
+		return mMaxSteps;
+	}
+	return dueStepCount;
+}
+
+void FixedTimestep::Reset()
+{
+	mAccumulator = Time::Zero;
+}
+
+void FixedTimestep::SetInterval(Time interval)
+{
+	assert(interval > Time::Zero);
+	mInterval = interval;
+	mAccumulator = Time::Zero;
+}
+
+void FixedTimestep::ResetStatistics()
+{
+	mOverrunCount = 0;
+	mDroppedStepCount = 0;
+	mMaxDueStepCount = 0;
+}
+
+} // namespace en
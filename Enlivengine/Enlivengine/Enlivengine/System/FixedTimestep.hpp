@@ -0,0 +1,46 @@
+#pragma once
+
+#include <Enlivengine/System/PrimitiveTypes.hpp>
+#include <Enlivengine/System/Time.hpp>
+
+namespace en
+{
+
+// Turns elapsed time into a count of fixed steps to run
+// At most maxSteps per Advance : after a hitch the late steps are dropped rather than run in a burst,
+// which would make the next Advance even later
+class FixedTimestep
+{
+public:
+	FixedTimestep(Time interval, U32 maxSteps);
+
+	// Steps to run for dt more elapsed time
+	U32 Advance(Time dt);
+
+	// Forget the accumulated time, the counters are kept
+	void Reset();
+
+	Time GetInterval() const { return mInterval; }
+	void SetInterval(Time interval);
+	U32 GetMaxSteps() const { return mMaxSteps; }
+	void SetMaxSteps(U32 maxSteps) { mMaxSteps = maxSteps; }
+
+	// Until the next step is due
+	Time GetRemainingTime() const { return mInterval - mAccumulator; }
+
+	// Advances that had more steps due than maxSteps, and the steps they dropped
+	U32 GetOverrunCount() const { return mOverrunCount; }
+	U32 GetDroppedStepCount() const { return mDroppedStepCount; }
+	U32 GetMaxDueStepCount() const { return mMaxDueStepCount; } // Most steps due in one Advance, dropped ones included
+	void ResetStatistics();
+
+private:
+	Time mInterval;
+	Time mAccumulator;
+	U32 mMaxSteps;
+	U32 mOverrunCount;
+	U32 mDroppedStepCount;
+	U32 mMaxDueStepCount;
+};
+
+} // namespace en
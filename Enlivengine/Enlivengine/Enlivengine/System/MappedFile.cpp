@@ -0,0 +1,127 @@
+#include <Enlivengine/System/MappedFile.hpp>
+
+#ifdef ENLIVE_PLATFORM_WINDOWS
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+namespace en
+{
+
+MappedFile::MappedFile()
+	: mData(nullptr)
+	, mSize(0)
+#ifdef ENLIVE_PLATFORM_WINDOWS
+	, mFile(nullptr)
+	, mMapping(nullptr)
+#endif // ENLIVE_PLATFORM_WINDOWS
+{
+}
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+#ifdef ENLIVE_PLATFORM_WINDOWS
+
+bool MappedFile::Open(const std::string& filename)
+{
+	Close();
+
+	HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0)
+	{
+		CloseHandle(file);
+		return false;
+	}
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping == nullptr)
+	{
+		CloseHandle(file);
+		return false;
+	}
+	const void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (data == nullptr)
+	{
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+
+	mData = static_cast<const U8*>(data);
+	mSize = static_cast<std::size_t>(size.QuadPart);
+	mFile = file;
+	mMapping = mapping;
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (mData != nullptr)
+	{
+		UnmapViewOfFile(mData);
+		CloseHandle(static_cast<HANDLE>(mMapping));
+		CloseHandle(static_cast<HANDLE>(mFile));
+	}
+	mData = nullptr;
+	mSize = 0;
+	mFile = nullptr;
+	mMapping = nullptr;
+}
+
+#else
+
+bool MappedFile::Open(const std::string& filename)
+{
+	Close();
+
+	const int file = open(filename.c_str(), O_RDONLY);
+	if (file < 0)
+	{
+		return false;
+	}
+	struct stat status;
+	if (fstat(file, &status) != 0 || status.st_size <= 0)
+	{
+		close(file);
+		return false;
+	}
+	void* data = mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+	// The mapping keeps its own reference to the file
+	close(file);
+	if (data == MAP_FAILED)
+	{
+		return false;
+	}
+
+	mData = static_cast<const U8*>(data);
+	mSize = static_cast<std::size_t>(status.st_size);
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (mData != nullptr)
+	{
+		munmap(const_cast<U8*>(mData), mSize);
+	}
+	mData = nullptr;
+	mSize = 0;
+}
+
+#endif // ENLIVE_PLATFORM_WINDOWS
+
+} // namespace en
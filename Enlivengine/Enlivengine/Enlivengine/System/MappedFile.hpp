@@ -0,0 +1,38 @@
+#pragma once
+
+#include <Enlivengine/System/NonCopyable.hpp>
+#include <Enlivengine/System/PlatformDetection.hpp>
+#include <Enlivengine/System/PrimitiveTypes.hpp>
+
+#include <cstddef>
+#include <string>
+
+namespace en
+{
+
+// Read-only view of a whole file in memory, the pages are read by the OS when they are first touched
+// The data stays valid until Close, Open of another file or the destruction
+class MappedFile : private NonCopyable
+{
+public:
+	MappedFile();
+	~MappedFile();
+
+	// Fails for missing and empty files
+	bool Open(const std::string& filename);
+	void Close();
+
+	bool IsOpen() const { return mData != nullptr; }
+	const U8* GetData() const { return mData; }
+	std::size_t GetSize() const { return mSize; }
+
+private:
+	const U8* mData;
+	std::size_t mSize;
+#ifdef ENLIVE_PLATFORM_WINDOWS
+	void* mFile;
+	void* mMapping;
+#endif // ENLIVE_PLATFORM_WINDOWS
+};
+
+} // namespace en
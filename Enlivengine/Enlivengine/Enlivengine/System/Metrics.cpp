@@ -0,0 +1,186 @@
+#include <Enlivengine/System/Metrics.hpp>
+
+#include <cstdio>
+
+namespace en
+{
+
+MetricHistogram::MetricHistogram()
+	: mCount(0)
+	, mSum(0)
+	, mMax(0)
+{
+	Reset();
+}
+
+void MetricHistogram::Record(U64 value)
+{
+	mBuckets[GetBucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+	mCount.fetch_add(1, std::memory_order_relaxed);
+	mSum.fetch_add(value, std::memory_order_relaxed);
+	U64 max = mMax.load(std::memory_order_relaxed);
+	while (value > max && !mMax.compare_exchange_weak(max, value, std::memory_order_relaxed))
+	{
+	}
+}
+
+void MetricHistogram::Reset()
+{
+	for (std::atomic<U64>& bucket : mBuckets)
+	{
+		bucket.store(0, std::memory_order_relaxed);
+	}
+	mCount.store(0, std::memory_order_relaxed);
+	mSum.store(0, std::memory_order_relaxed);
+	mMax.store(0, std::memory_order_relaxed);
+}
+
+U64 MetricHistogram::GetValueAtPercentile(F64 percentile) const
+{
+	const U64 count = GetCount();
+	if (count == 0)
+	{
+		return 0;
+	}
+	const F64 clamped = (percentile < 0.0) ? 0.0 : ((percentile > 100.0) ? 100.0 : percentile);
+	U64 rank = static_cast<U64>(clamped * 0.01 * static_cast<F64>(count) + 0.5);
+	rank = (rank > 0) ? rank : 1;
+
+	U64 seen = 0;
+	for (U32 bucket = 0; bucket < BucketCount; ++bucket)
+	{
+		seen += GetBucketCount(bucket);
+		if (seen >= rank)
+		{
+			return GetBucketHighestValue(bucket);
+		}
+	}
+	return GetMax();
+}
+
+U32 MetricHistogram::GetBucketIndex(U64 value)
+{
+	if (value < SubBucketCount)
+	{
+		return static_cast<U32>(value);
+	}
+	U32 highestBit = 0;
+	for (U64 v = value; v > 1; v >>= 1)
+	{
+		highestBit++;
+	}
+	// [SubBucketCount << (group - 1), SubBucketCount << group) for group >= 1
+	const U32 group = highestBit - SubBucketBits + 1;
+	const U32 subBucket = static_cast<U32>(value >> (group - 1)) - SubBucketCount;
+	return SubBucketCount + (group - 1) * SubBucketCount + subBucket;
+}
+
+U64 MetricHistogram::GetBucketHighestValue(U32 bucket)
+{
+	if (bucket < SubBucketCount)
+	{
+		return bucket;
+	}
+	const U32 group = (bucket - SubBucketCount) / SubBucketCount + 1;
+	const U64 subBucket = (bucket - SubBucketCount) % SubBucketCount;
+	const U64 lowest = (SubBucketCount + subBucket) << (group - 1);
+	return lowest + ((static_cast<U64>(1) << (group - 1)) - 1);
+}
+
+MetricsRegistry::MetricsRegistry()
+	: mCounters()
+	, mGauges()
+	, mHistograms()
+{
+}
+
+MetricCounter& MetricsRegistry::AddCounter(const char* name, const char* help)
+{
+	mCounters.push_back({ name, help, std::unique_ptr<MetricCounter>(new MetricCounter()) });
+	return *mCounters.back().metric;
+}
+
+MetricGauge& MetricsRegistry::AddGauge(const char* name, const char* help)
+{
+	mGauges.push_back({ name, help, std::unique_ptr<MetricGauge>(new MetricGauge()) });
+	return *mGauges.back().metric;
+}
+
+MetricHistogram& MetricsRegistry::AddHistogram(const char* name, const char* help)
+{
+	mHistograms.push_back({ name, help, std::unique_ptr<MetricHistogram>(new MetricHistogram()) });
+	return *mHistograms.back().metric;
+}
+
+void MetricsRegistry::WritePrometheus(std::string& output) const
+{
+	char line[256];
+	const auto writeHeader = [&output](const std::string& name, const std::string& help, const char* type)
+	{
+		output += "# HELP " + name + " " + help + "\n";
+		output += "# TYPE " + name + " " + type + "\n";
+	};
+
+	for (const Entry<MetricCounter>& entry : mCounters)
+	{
+		writeHeader(entry.name, entry.help, "counter");
+		std::snprintf(line, sizeof(line), "%s %llu\n", entry.name.c_str(), static_cast<unsigned long long>(entry.metric->Get()));
+		output += line;
+	}
+	for (const Entry<MetricGauge>& entry : mGauges)
+	{
+		writeHeader(entry.name, entry.help, "gauge");
+		std::snprintf(line, sizeof(line), "%s %lld\n", entry.name.c_str(), static_cast<long long>(entry.metric->Get()));
+		output += line;
+	}
+	for (const Entry<MetricHistogram>& entry : mHistograms)
+	{
+		const MetricHistogram& histogram = *entry.metric;
+		writeHeader(entry.name, entry.help, "histogram");
+		U64 cumulative = 0;
+		for (U32 bucket = 0; bucket < MetricHistogram::BucketCount; ++bucket)
+		{
+			const U64 count = histogram.GetBucketCount(bucket);
+			if (count > 0)
+			{
+				cumulative += count;
+				std::snprintf(line, sizeof(line), "%s_bucket{le=\"%llu\"} %llu\n", entry.name.c_str(), static_cast<unsigned long long>(MetricHistogram::GetBucketHighestValue(bucket)), static_cast<unsigned long long>(cumulative));
+				output += line;
+			}
+		}
+		// Recorded concurrently, the total might be a bit ahead of the buckets read before
+		const U64 count = (histogram.GetCount() > cumulative) ? histogram.GetCount() : cumulative;
+		std::snprintf(line, sizeof(line), "%s_bucket{le=\"+Inf\"} %llu\n%s_sum %llu\n%s_count %llu\n", entry.name.c_str(), static_cast<unsigned long long>(count),
+			entry.name.c_str(), static_cast<unsigned long long>(histogram.GetSum()), entry.name.c_str(), static_cast<unsigned long long>(count));
+		output += line;
+	}
+}
+
+bool MetricsRegistry::WritePrometheusFile(const std::string& path) const
+{
+	std::string output;
+	WritePrometheus(output);
+
+	const std::string temporaryPath = path + ".tmp";
+	std::FILE* file = std::fopen(temporaryPath.c_str(), "wb");
+	if (file == nullptr)
+	{
+		return false;
+	}
+	const bool written = (std::fwrite(output.data(), 1, output.size(), file) == output.size());
+	const bool closed = (std::fclose(file) == 0);
+	if (!written || !closed)
+	{
+		std::remove(temporaryPath.c_str());
+		return false;
+	}
+	if (std::rename(temporaryPath.c_str(), path.c_str()) != 0)
+	{
+		// Windows doesn't rename over an existing file
+		std::remove(path.c_str());
+		return std::rename(temporaryPath.c_str(), path.c_str()) == 0;
+	}
+	return true;
+}
+
+} // namespace en
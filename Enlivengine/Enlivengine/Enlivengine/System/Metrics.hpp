@@ -0,0 +1,107 @@
+#pragma once
+
+#include <Enlivengine/System/NonCopyable.hpp>
+#include <Enlivengine/System/PrimitiveTypes.hpp>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace en
+{
+
+// Metrics are registered once, then recorded from any thread with relaxed atomics : no lock, no allocation
+// The registry writes them in the Prometheus text format, read from another thread the values are only approximately consistent
+
+// Only goes up
+class MetricCounter : private NonCopyable
+{
+public:
+	MetricCounter() : mValue(0) {}
+
+	void Add(U64 value = 1) { mValue.fetch_add(value, std::memory_order_relaxed); }
+	U64 Get() const { return mValue.load(std::memory_order_relaxed); }
+
+private:
+	std::atomic<U64> mValue;
+};
+
+// Current value of something, set or moved by deltas
+class MetricGauge : private NonCopyable
+{
+public:
+	MetricGauge() : mValue(0) {}
+
+	void Set(I64 value) { mValue.store(value, std::memory_order_relaxed); }
+	void Add(I64 delta) { mValue.fetch_add(delta, std::memory_order_relaxed); }
+	I64 Get() const { return mValue.load(std::memory_order_relaxed); }
+
+private:
+	std::atomic<I64> mValue;
+};
+
+// HDR-style : values below SubBucketCount are exact, each power of two above is split in SubBucketCount linear buckets,
+// so any value is known within 1/SubBucketCount of itself whatever its magnitude
+class MetricHistogram : private NonCopyable
+{
+public:
+	static constexpr U32 SubBucketBits = 4;
+	static constexpr U32 SubBucketCount = 1 << SubBucketBits;
+	static constexpr U32 BucketCount = SubBucketCount + (64 - SubBucketBits) * SubBucketCount;
+
+	MetricHistogram();
+
+	void Record(U64 value);
+	void Reset();
+
+	U64 GetCount() const { return mCount.load(std::memory_order_relaxed); }
+	U64 GetSum() const { return mSum.load(std::memory_order_relaxed); }
+	U64 GetMax() const { return mMax.load(std::memory_order_relaxed); }
+	U64 GetBucketCount(U32 bucket) const { return mBuckets[bucket].load(std::memory_order_relaxed); }
+
+	// Highest value of the bucket holding the given percentile [0, 100], 0 when empty
+	U64 GetValueAtPercentile(F64 percentile) const;
+
+	static U32 GetBucketIndex(U64 value);
+	static U64 GetBucketHighestValue(U32 bucket);
+
+private:
+	std::atomic<U64> mBuckets[BucketCount];
+	std::atomic<U64> mCount;
+	std::atomic<U64> mSum;
+	std::atomic<U64> mMax;
+};
+
+class MetricsRegistry : private NonCopyable
+{
+public:
+	MetricsRegistry();
+
+	// Names follow Prometheus : [a-zA-Z_:][a-zA-Z0-9_:]*, counters end with _total, units are in the name
+	// The metrics live as long as the registry
+	MetricCounter& AddCounter(const char* name, const char* help);
+	MetricGauge& AddGauge(const char* name, const char* help);
+	MetricHistogram& AddHistogram(const char* name, const char* help);
+
+	// Histograms are written with their non-empty buckets only
+	void WritePrometheus(std::string& output) const;
+
+	// Through a temporary file renamed over path, so a reader never sees a partial file
+	bool WritePrometheusFile(const std::string& path) const;
+
+private:
+	template <typename T>
+	struct Entry
+	{
+		std::string name;
+		std::string help;
+		std::unique_ptr<T> metric;
+	};
+
+	std::vector<Entry<MetricCounter>> mCounters;
+	std::vector<Entry<MetricGauge>> mGauges;
+	std::vector<Entry<MetricHistogram>> mHistograms;
+};
+
+} // namespace en
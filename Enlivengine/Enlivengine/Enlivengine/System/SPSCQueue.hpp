@@ -0,0 +1,134 @@
+#pragma once
+
+#include <Enlivengine/System/Assert.hpp>
+#include <Enlivengine/System/NonCopyable.hpp>
+#include <Enlivengine/System/PrimitiveTypes.hpp>
+
+#include <atomic>
+#include <vector>
+
+namespace en
+{
+
+// Lock-free bounded ring for exactly one producer thread and one consumer thread
+// Slots are constructed once and reused : values are written and read in place,
+// so a slot holding a vector keeps its capacity and the queue never allocates after construction
+template <typename T>
+class SPSCQueue : private NonCopyable
+{
+public:
+	// capacity must be a power of two
+	explicit SPSCQueue(U32 capacity)
+		: mSlots(capacity)
+		, mMask(capacity - 1)
+		, mHead(0)
+		, mTail(0)
+	{
+		assert(capacity > 0 && (capacity & (capacity - 1)) == 0);
+	}
+
+	// Producer : slot to fill, nullptr if the queue is full
+	T* BeginPush()
+	{
+		const U32 tail = mTail.load(std::memory_order_relaxed);
+		if (tail - mHead.load(std::memory_order_acquire) > mMask)
+		{
+			return nullptr;
+		}
+		return &mSlots[tail & mMask];
+	}
+
+	// Producer : publish the slot returned by BeginPush
+	void EndPush()
+	{
+		mTail.store(mTail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+
+	// Consumer : oldest slot, nullptr if the queue is empty
+	T* BeginPop()
+	{
+		const U32 head = mHead.load(std::memory_order_relaxed);
+		if (head == mTail.load(std::memory_order_acquire))
+		{
+			return nullptr;
+		}
+		return &mSlots[head & mMask];
+	}
+
+	// Consumer : give the slot returned by BeginPop back to the producer
+	void EndPop()
+	{
+		mHead.store(mHead.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+
+	// Producer : up to maxCount contiguous slots to fill, count is 0 if the queue is full
+	T* BeginPush(U32 maxCount, U32& count)
+	{
+		const U32 tail = mTail.load(std::memory_order_relaxed);
+		const U32 free = GetCapacity() - (tail - mHead.load(std::memory_order_acquire));
+		count = Min(Min(free, GetCapacity() - (tail & mMask)), maxCount);
+		return &mSlots[tail & mMask];
+	}
+
+	// Producer : publish the first count slots returned by BeginPush
+	void EndPush(U32 count)
+	{
+		mTail.store(mTail.load(std::memory_order_relaxed) + count, std::memory_order_release);
+	}
+
+	// Consumer : up to maxCount contiguous oldest slots, count is 0 if the queue is empty
+	T* BeginPop(U32 maxCount, U32& count)
+	{
+		const U32 head = mHead.load(std::memory_order_relaxed);
+		const U32 used = mTail.load(std::memory_order_acquire) - head;
+		count = Min(Min(used, GetCapacity() - (head & mMask)), maxCount);
+		return &mSlots[head & mMask];
+	}
+
+	// Consumer : give the first count slots returned by BeginPop back to the producer
+	void EndPop(U32 count)
+	{
+		mHead.store(mHead.load(std::memory_order_relaxed) + count, std::memory_order_release);
+	}
+
+	bool Push(const T& value)
+	{
+		if (T* slot = BeginPush())
+		{
+			*slot = value;
+			EndPush();
+			return true;
+		}
+		return false;
+	}
+
+	bool Pop(T& value)
+	{
+		if (T* slot = BeginPop())
+		{
+			value = *slot;
+			EndPop();
+			return true;
+		}
+		return false;
+	}
+
+	// Only exact when called from the producer or the consumer while the other one is idle
+	U32 GetSize() const { return mTail.load(std::memory_order_acquire) - mHead.load(std::memory_order_acquire); }
+	bool IsEmpty() const { return GetSize() == 0; }
+	U32 GetCapacity() const { return mMask + 1; }
+
+	// Slots can be initialized (reserve...) before the threads start
+	std::vector<T>& GetSlots() { return mSlots; }
+
+private:
+	static U32 Min(U32 a, U32 b) { return (a < b) ? a : b; }
+
+private:
+	std::vector<T> mSlots;
+	U32 mMask;
+	alignas(64) std::atomic<U32> mHead; // Next slot to pop, written by the consumer
+	alignas(64) std::atomic<U32> mTail; // Next slot to push, written by the producer
+};
+
+} // namespace en
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <Enlivengine/System/Assert.hpp>
+#include <Enlivengine/System/PrimitiveTypes.hpp>
+
+#include <utility> // move, swap
+#include <vector>
+
+namespace en
+{
+
+// Densely packed storage addressed by generational handles
+// - Values are contiguous, so iterating with an index over [0, Size()) is cache friendly
+// - Add/Remove/Get are O(1), removal moves the last value into the hole (order is not kept)
+// - Handles of removed values are always detected as invalid : a slot whose generation would wrap around is retired
+//   (8 bytes kept per retired slot, every kGenerationMask reuses of a slot)
+// Handles are U32 (like entt entities) : low bits are the slot index, high bits the generation
+// The generation is never 0, so 0 can always be used as an invalid handle
+template <typename T>
+class SlotMap
+{
+public:
+	using Handle = U32;
+
+	static constexpr U32 kIndexBits = 20;
+	static constexpr U32 kGenerationBits = 32 - kIndexBits;
+	static constexpr U32 kIndexMask = (1u << kIndexBits) - 1;
+	static constexpr U32 kGenerationMask = (1u << kGenerationBits) - 1;
+	static constexpr U32 kMaxSize = kIndexMask;
+	static constexpr Handle InvalidHandle = 0;
+
+	using Iterator = typename std::vector<T>::iterator;
+	using ConstIterator = typename std::vector<T>::const_iterator;
+
+	SlotMap() : mValues(), mDenseToSlot(), mSlots(), mFreeHead(kIndexMask) {}
+
+	Handle Add(const T& value)
+	{
+		const U32 slotIndex = AllocateSlot();
+		mValues.push_back(value);
+		return MakeHandle(slotIndex, mSlots[slotIndex].generation);
+	}
+
+	Handle Add(T&& value)
+	{
+		const U32 slotIndex = AllocateSlot();
+		mValues.push_back(std::move(value));
+		return MakeHandle(slotIndex, mSlots[slotIndex].generation);
+	}
+
+	bool Remove(Handle handle)
+	{
+		const I32 index = GetIndex(handle);
+		if (index >= 0)
+		{
+			RemoveAt(static_cast<U32>(index));
+			return true;
+		}
+		return false;
+	}
+
+	// Swap-and-pop : the last value takes the place of the removed one
+	void RemoveAt(U32 index)
+	{
+		assert(index < Size());
+		const U32 slotIndex = mDenseToSlot[index];
+		const U32 lastIndex = Size() - 1;
+		if (index != lastIndex)
+		{
+			mValues[index] = std::move(mValues[lastIndex]);
+			mDenseToSlot[index] = mDenseToSlot[lastIndex];
+			mSlots[mDenseToSlot[index]].index = index;
+		}
+		mValues.pop_back();
+		mDenseToSlot.pop_back();
+
+		Slot& slot = mSlots[slotIndex];
+		if (slot.generation == kGenerationMask)
+		{
+			// Never matches a handle again and is not reused, so a handle is never given twice
+			slot.generation = 0;
+			slot.index = kIndexMask;
+		}
+		else
+		{
+			slot.generation++;
+			slot.index = mFreeHead;
+			mFreeHead = slotIndex;
+		}
+	}
+
+	bool Has(Handle handle) const { return GetIndex(handle) >= 0; }
+
+	// Dense index of the value, -1 if the handle is invalid
+	I32 GetIndex(Handle handle) const
+	{
+		const U32 slotIndex = handle & kIndexMask;
+		const U32 generation = handle >> kIndexBits;
+		if (slotIndex < mSlots.size() && generation != 0 && mSlots[slotIndex].generation == generation)
+		{
+			return static_cast<I32>(mSlots[slotIndex].index);
+		}
+		return -1;
+	}
+
+	Handle GetHandle(U32 index) const
+	{
+		assert(index < Size());
+		const U32 slotIndex = mDenseToSlot[index];
+		return MakeHandle(slotIndex, mSlots[slotIndex].generation);
+	}
+
+	T* Get(Handle handle)
+	{
+		const I32 index = GetIndex(handle);
+		return (index >= 0) ? &mValues[index] : nullptr;
+	}
+
+	const T* Get(Handle handle) const
+	{
+		const I32 index = GetIndex(handle);
+		return (index >= 0) ? &mValues[index] : nullptr;
+	}
+
+	T& operator[](U32 index) { assert(index < Size()); return mValues[index]; }
+	const T& operator[](U32 index) const { assert(index < Size()); return mValues[index]; }
+
+	U32 Size() const { return static_cast<U32>(mValues.size()); }
+	bool Empty() const { return mValues.empty(); }
+
+	// Handles given before Clear stay invalid
+	void Clear()
+	{
+		const U32 size = Size();
+		for (U32 i = size; i > 0; --i)
+		{
+			RemoveAt(i - 1);
+		}
+	}
+
+	void Reserve(U32 capacity)
+	{
+		mValues.reserve(capacity);
+		mDenseToSlot.reserve(capacity);
+		mSlots.reserve(capacity);
+	}
+
+	// Contiguous values, index i of this vector is the dense index i
+	const std::vector<T>& GetValues() const { return mValues; }
+
+	Iterator begin() { return mValues.begin(); }
+	ConstIterator begin() const { return mValues.begin(); }
+	Iterator end() { return mValues.end(); }
+	ConstIterator end() const { return mValues.end(); }
+
+private:
+	struct Slot
+	{
+		U32 index; // Dense index when used, next free slot when free
+		U32 generation; // 0 once retired
+	};
+
+	static Handle MakeHandle(U32 slotIndex, U32 generation)
+	{
+		return (generation << kIndexBits) | slotIndex;
+	}
+
+	U32 AllocateSlot()
+	{
+		U32 slotIndex;
+		if (mFreeHead != kIndexMask)
+		{
+			slotIndex = mFreeHead;
+			mFreeHead = mSlots[slotIndex].index;
+		}
+		else
+		{
+			assert(mSlots.size() < kMaxSize);
+			slotIndex = static_cast<U32>(mSlots.size());
+			mSlots.push_back({ 0, 1 });
+		}
+		mSlots[slotIndex].index = Size();
+		mDenseToSlot.push_back(slotIndex);
+		return slotIndex;
+	}
+
+private:
+	std::vector<T> mValues;
+	std::vector<U32> mDenseToSlot;
+	std::vector<Slot> mSlots;
+	U32 mFreeHead;
+};
+
+} // namespace en
@@ -0,0 +1,115 @@
+#include <Enlivengine/System/ThreadPool.hpp>
+
+namespace en
+{
+
+ThreadPool::ThreadPool(U32 workerCount)
+	: mWorkers()
+	, mMutex()
+	, mWakeCondition()
+	, mDoneCondition()
+	, mGeneration(0)
+	, mBusyWorkers(0)
+	, mStopping(false)
+	, mTask(nullptr)
+	, mContext(nullptr)
+	, mCount(0)
+	, mNextIndex(0)
+{
+	mWorkers.reserve(workerCount);
+	for (U32 i = 0; i < workerCount; ++i)
+	{
+		mWorkers.emplace_back(&ThreadPool::WorkerLoop, this);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mStopping = true;
+	}
+	mWakeCondition.notify_all();
+	for (std::thread& worker : mWorkers)
+	{
+		worker.join();
+	}
+}
+
+U32 ThreadPool::GetDefaultWorkerCount()
+{
+	const U32 hardwareThreads = static_cast<U32>(std::thread::hardware_concurrency());
+	return (hardwareThreads > 1) ? hardwareThreads - 1 : 0;
+}
+
+void ThreadPool::Run(Task task, void* context, U32 count)
+{
+	if (count == 0)
+	{
+		return;
+	}
+
+	// Not worth waking anyone
+	if (mWorkers.empty() || count == 1)
+	{
+		for (U32 i = 0; i < count; ++i)
+		{
+			task(context, i);
+		}
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mTask = task;
+		mContext = context;
+		mCount = count;
+		mNextIndex.store(0, std::memory_order_relaxed);
+		mBusyWorkers = static_cast<U32>(mWorkers.size());
+		mGeneration++;
+	}
+	mWakeCondition.notify_all();
+
+	RunIndexes();
+
+	std::unique_lock<std::mutex> lock(mMutex);
+	mDoneCondition.wait(lock, [this]() { return mBusyWorkers == 0; });
+}
+
+void ThreadPool::RunIndexes()
+{
+	for (U32 index = mNextIndex.fetch_add(1, std::memory_order_relaxed); index < mCount; index = mNextIndex.fetch_add(1, std::memory_order_relaxed))
+	{
+		mTask(mContext, index);
+	}
+}
+
+void ThreadPool::WorkerLoop()
+{
+	U32 generation = 0;
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mWakeCondition.wait(lock, [this, generation]() { return mStopping || mGeneration != generation; });
+			if (mStopping)
+			{
+				return;
+			}
+			generation = mGeneration;
+		}
+
+		RunIndexes();
+
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mBusyWorkers--;
+			if (mBusyWorkers == 0)
+			{
+				mDoneCondition.notify_one();
+			}
+		}
+	}
+}
+
+} // namespace en
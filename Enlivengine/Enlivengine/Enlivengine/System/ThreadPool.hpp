@@ -0,0 +1,69 @@
+#pragma once
+
+#include <Enlivengine/System/NonCopyable.hpp>
+#include <Enlivengine/System/PrimitiveTypes.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace en
+{
+
+// Fixed set of worker threads running loops of independent tasks
+// Each thread takes the next index as soon as it is free, so long tasks don't hold the short ones back
+// Nothing is allocated once constructed
+class ThreadPool : private NonCopyable
+{
+public:
+	// With 0 workers, everything runs on the calling thread
+	explicit ThreadPool(U32 workerCount);
+	~ThreadPool();
+
+	U32 GetWorkerCount() const { return static_cast<U32>(mWorkers.size()); }
+
+	// Call function(index) for each index in [0, count) on the workers and the calling thread
+	// Returns once every call is done, function must be safe to call concurrently for different indexes
+	template <typename F>
+	void ParallelFor(U32 count, F&& function);
+
+	// One worker per hardware thread, minus the calling thread
+	static U32 GetDefaultWorkerCount();
+
+private:
+	using Task = void(*)(void* context, U32 index);
+
+	void Run(Task task, void* context, U32 count);
+	void RunIndexes();
+	void WorkerLoop();
+
+private:
+	std::vector<std::thread> mWorkers;
+
+	std::mutex mMutex;
+	std::condition_variable mWakeCondition;
+	std::condition_variable mDoneCondition;
+	U32 mGeneration; // Incremented by each Run, wakes the workers
+	U32 mBusyWorkers; // Workers still running the current generation
+	bool mStopping;
+
+	Task mTask;
+	void* mContext;
+	U32 mCount;
+	std::atomic<U32> mNextIndex;
+};
+
+template <typename F>
+void ThreadPool::ParallelFor(U32 count, F&& function)
+{
+	using Function = typename std::remove_reference<F>::type;
+	Run([](void* context, U32 index)
+	{
+		(*static_cast<Function*>(context))(index);
+	}, const_cast<void*>(static_cast<const void*>(&function)), count);
+}
+
+} // namespace en
@@ -34,6 +34,7 @@ ImGuiResourceBrowser::ImGuiResourceBrowser()
 	ImGuiFileDialog::Instance()->SetFilterColor(".ttf", ResourceInfo::ResourceInfoTypeToColor(ResourceInfo::Type::Font).withAlpha(0.8f).toImGuiColor());
 
 	ImGuiFileDialog::Instance()->SetFilterColor(".tmx", ResourceInfo::ResourceInfoTypeToColor(ResourceInfo::Type::Map).withAlpha(0.7f).toImGuiColor());
+	ImGuiFileDialog::Instance()->SetFilterColor(".enmap", ResourceInfo::ResourceInfoTypeToColor(ResourceInfo::Type::Map).withAlpha(0.7f).toImGuiColor());
 	ImGuiFileDialog::Instance()->SetFilterColor(".tsx", ResourceInfo::ResourceInfoTypeToColor(ResourceInfo::Type::Tileset).withAlpha(0.8f).toImGuiColor());
 
 	ImGuiFileDialog::Instance()->SetFilterColor(".ogg", ResourceInfo::ResourceInfoTypeToColor(ResourceInfo::Type::Music).withAlpha(0.8f).toImGuiColor());
@@ -342,7 +343,7 @@ ImGuiResourceBrowser::ResourceInfo::Type ImGuiResourceBrowser::ResourceInfo::Det
 	{
 		return Type::Tileset;
 	}
-	if (ext == ".tmx")
+	if (ext == ".tmx" || ext == ".enmap")
 	{
 		return Type::Map;
 	}
@@ -433,7 +434,7 @@ void ImGuiResourceBrowser::TilesetPreview(ResourceInfo& resourceInfo)
 	if (ImGui::IsItemHovered())
 	{
 		tmx::TilesetPtr tileset = ResourceManager::GetInstance().Get<tmx::Tileset>(resourceInfo.resourceID);
-		if (tileset.IsValid() && tileset.Get().GetTexture().IsValid())
+		if (tileset.IsLoaded() && tileset.Get().GetTexture().IsValid())
 		{
 			ImGui::BeginTooltip();
 
@@ -453,7 +454,7 @@ void ImGuiResourceBrowser::MapPreview(ResourceInfo& resourceInfo)
 	if (ImGui::IsItemHovered())
 	{
 		tmx::MapPtr mapPtr = ResourceManager::GetInstance().Get<tmx::Map>(resourceInfo.resourceID);
-		if (mapPtr.IsValid())
+		if (mapPtr.IsLoaded())
 		{
 			ImGui::BeginTooltip();
 
@@ -493,7 +494,7 @@ void ImGuiResourceBrowser::AnimationPreview(ResourceInfo& resourceInfo)
 	if (ImGui::IsItemHovered())
 	{
 		AnimationPtr animation = ResourceManager::GetInstance().Get<Animation>(resourceInfo.resourceID);
-		if (animation.IsValid() && animation.Get().GetTexture().IsValid())
+		if (animation.IsLoaded() && animation.Get().GetTexture().IsValid())
 		{
 			static ResourceID lastResourceID = 654321;
 			static U32 animationClipIndex;
@@ -521,7 +522,7 @@ void ImGuiResourceBrowser::AnimationPreview(ResourceInfo& resourceInfo)
 void ImGuiResourceBrowser::AnimationStateMachinePreview(ResourceInfo& resourceInfo)
 {
 	AnimationStateMachinePtr ptr = ResourceManager::GetInstance().Get<AnimationStateMachine>(resourceInfo.resourceID);
-	if (ptr.IsValid())
+	if (ptr.IsLoaded())
 	{
 		ImGui::Text(ICON_FA_DIRECTIONS);
 		if (ImGui::IsItemHovered())
@@ -0,0 +1,107 @@
+#include <Enlivengine/Application/ResourceManager.hpp>
+
+#include <doctest/doctest.h>
+
+#include <chrono>
+
+namespace
+{
+
+class TestResource : public en::Resource<TestResource>
+{
+public:
+	TestResource() : mValue(0), mFinalized(false) {}
+
+	en::U32 mValue;
+	bool mFinalized;
+};
+
+en::AsyncResourceLoader<TestResource> TestLoader(en::U32 value)
+{
+	return en::AsyncResourceLoader<TestResource>(
+		[value](TestResource& resource) { resource.mValue = value; return value > 0; },
+		[](TestResource& resource) { resource.mFinalized = true; return true; });
+}
+
+void WaitLoading(en::ResourceManager& resourceManager)
+{
+	for (en::U32 i = 0; i < 1000 && resourceManager.IsLoading(); ++i)
+	{
+		resourceManager.Update();
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+}
+
+} // namespace
+
+DOCTEST_TEST_CASE("ResourceManager async loading")
+{
+	en::ResourceManager& resourceManager = en::ResourceManager::GetInstance();
+	resourceManager.ReleaseAll();
+	DOCTEST_CHECK(!resourceManager.IsLoading());
+	DOCTEST_CHECK(resourceManager.GetLoadingProgress() == 1.0f);
+
+	en::ResourcePtr<TestResource> first = resourceManager.CreateAsync("first", TestLoader(1));
+	bool firstLoadedBefore = false;
+	en::ResourcePtr<TestResource> second = resourceManager.CreateAsync<TestResource>("second", en::AsyncResourceLoader<TestResource>(
+		[](TestResource& resource) { resource.mValue = 2; return true; },
+		[&first, &firstLoadedBefore](TestResource& resource) { firstLoadedBefore = first.IsLoaded(); resource.mFinalized = true; return true; }));
+	en::ResourcePtr<TestResource> failed = resourceManager.CreateAsync("failed", TestLoader(0));
+	DOCTEST_CHECK(first.IsValid());
+	DOCTEST_CHECK(first.GetLoadingState() == en::ResourceLoadingState::Loading);
+	DOCTEST_CHECK(!first.IsLoaded());
+	DOCTEST_CHECK(resourceManager.IsLoading());
+	DOCTEST_CHECK(resourceManager.GetLoadingCount() == 3);
+	DOCTEST_CHECK(resourceManager.GetLoadingProgress() == 0.0f);
+
+	// Already known : reused, not requested again
+	DOCTEST_CHECK(resourceManager.CreateAsync("first", TestLoader(5)).GetID() == first.GetID());
+	DOCTEST_CHECK(resourceManager.GetLoadingCount() == 3);
+
+	WaitLoading(resourceManager);
+	DOCTEST_CHECK(!resourceManager.IsLoading());
+	DOCTEST_CHECK(resourceManager.GetLoadingProgress() == 1.0f);
+	DOCTEST_CHECK(first.IsLoaded());
+	DOCTEST_CHECK(first.Get().mValue == 1);
+	DOCTEST_CHECK(first.Get().mFinalized);
+	DOCTEST_CHECK(second.IsLoaded());
+	DOCTEST_CHECK(second.Get().mValue == 2);
+	DOCTEST_CHECK(firstLoadedBefore);
+
+	// Not finalized when the preparation failed
+	DOCTEST_CHECK(failed.IsValid());
+	DOCTEST_CHECK(failed.GetLoadingState() == en::ResourceLoadingState::Failed);
+	DOCTEST_CHECK(!failed.Get().mFinalized);
+
+	DOCTEST_CHECK(en::ResourcePtr<TestResource>().GetLoadingState() == en::ResourceLoadingState::Failed);
+
+	resourceManager.ReleaseAll();
+}
+
+DOCTEST_TEST_CASE("ResourceManager release while loading")
+{
+	en::ResourceManager& resourceManager = en::ResourceManager::GetInstance();
+	resourceManager.ReleaseAll();
+
+	for (en::U32 i = 0; i < 32; ++i)
+	{
+		resourceManager.CreateAsync("resource" + std::to_string(i), TestLoader(i + 1));
+	}
+	resourceManager.Release("resource3");
+	resourceManager.ReleaseAll();
+	DOCTEST_CHECK(resourceManager.Count() == 0);
+
+	// Still waiting for the loading threads, but nothing is finalized
+	WaitLoading(resourceManager);
+	DOCTEST_CHECK(!resourceManager.IsLoading());
+	DOCTEST_CHECK(resourceManager.Count() == 0);
+
+	// Reloaded while loading
+	en::ResourcePtr<TestResource> resource = resourceManager.CreateAsync("reloaded", TestLoader(1));
+	resourceManager.CreateAsync("reloaded", TestLoader(2), en::ResourceKnownStrategy::Reload);
+	WaitLoading(resourceManager);
+	DOCTEST_CHECK(resource.IsLoaded());
+	DOCTEST_CHECK(resource.Get().mValue == 2);
+
+	resourceManager.ReleaseAll();
+}
@@ -0,0 +1,111 @@
+#include <Enlivengine/Graphics/SpriteBatch.hpp>
+#include <Enlivengine/System/Time.hpp>
+
+#include <doctest/doctest.h>
+
+#include <cstdio>
+
+namespace
+{
+
+bool IsSamePoint(const sf::Vector2f& a, const sf::Vector2f& b)
+{
+	return a.x == doctest::Approx(b.x).epsilon(0.0001) && a.y == doctest::Approx(b.y).epsilon(0.0001);
+}
+
+} // namespace
+
+DOCTEST_TEST_CASE("SpriteBatch quads")
+{
+	// Never uploaded : quads only need the address of their texture
+	sf::Texture texture;
+	en::SpriteBatch batch;
+
+	batch.Draw(texture, sf::IntRect(16, 0, 16, 8), en::Vector2f(100.0f, 50.0f), en::Vector2f(8.0f, 4.0f), en::Vector2f(2.0f, 2.0f), 90.0f, en::Color::Red);
+	DOCTEST_CHECK(batch.GetQuadCount() == 1);
+	DOCTEST_CHECK(batch.GetBatchCount() == 1);
+	const sf::VertexArray& vertices = batch.GetBatchVertices(0);
+	DOCTEST_CHECK(vertices.getVertexCount() == 4);
+	DOCTEST_CHECK(vertices.getPrimitiveType() == sf::Quads);
+
+	// Scaled around the origin, then rotated a quarter turn clockwise around the position
+	DOCTEST_CHECK(IsSamePoint(vertices[0].position, sf::Vector2f(108.0f, 34.0f)));
+	DOCTEST_CHECK(IsSamePoint(vertices[1].position, sf::Vector2f(108.0f, 66.0f)));
+	DOCTEST_CHECK(IsSamePoint(vertices[2].position, sf::Vector2f(92.0f, 66.0f)));
+	DOCTEST_CHECK(IsSamePoint(vertices[3].position, sf::Vector2f(92.0f, 34.0f)));
+	DOCTEST_CHECK(vertices[0].texCoords == sf::Vector2f(16.0f, 0.0f));
+	DOCTEST_CHECK(vertices[2].texCoords == sf::Vector2f(32.0f, 8.0f));
+	DOCTEST_CHECK(vertices[0].color == sf::Color::Red);
+
+	// Same quad as the sprite
+	sf::Sprite sprite;
+	sprite.setTexture(texture);
+	sprite.setTextureRect(sf::IntRect(0, 16, 32, 32));
+	sprite.setOrigin(16.0f, 16.0f);
+	sprite.setScale(1.5f, 0.5f);
+	sprite.setRotation(30.0f);
+	sprite.setPosition(320.0f, 240.0f);
+	batch.Clear();
+	batch.Draw(sprite);
+	const sf::FloatRect bounds = sprite.getGlobalBounds();
+	const sf::VertexArray& spriteVertices = batch.GetBatchVertices(0);
+	DOCTEST_CHECK(spriteVertices.getBounds().left == doctest::Approx(bounds.left));
+	DOCTEST_CHECK(spriteVertices.getBounds().top == doctest::Approx(bounds.top));
+	DOCTEST_CHECK(spriteVertices.getBounds().width == doctest::Approx(bounds.width));
+	DOCTEST_CHECK(spriteVertices.getBounds().height == doctest::Approx(bounds.height));
+	DOCTEST_CHECK(IsSamePoint(spriteVertices[2].position, sprite.getTransform().transformPoint(32.0f, 32.0f)));
+}
+
+DOCTEST_TEST_CASE("SpriteBatch textures")
+{
+	sf::Texture first;
+	sf::Texture second;
+	en::SpriteBatch batch;
+
+	for (en::U32 i = 0; i < 10; ++i)
+	{
+		batch.Draw((i % 3 == 0) ? second : first, sf::IntRect(0, 0, 8, 8), en::Vector2f(static_cast<en::F32>(i), 0.0f));
+	}
+	DOCTEST_CHECK(batch.GetQuadCount() == 10);
+	DOCTEST_CHECK(batch.GetBatchCount() == 2);
+	DOCTEST_CHECK(batch.GetBatchTexture(0) == &second);
+	DOCTEST_CHECK(batch.GetBatchTexture(1) == &first);
+	DOCTEST_CHECK(batch.GetBatchVertices(0).getVertexCount() == 16);
+	DOCTEST_CHECK(batch.GetBatchVertices(1).getVertexCount() == 24);
+
+	// Same texture quads keep their order
+	DOCTEST_CHECK(batch.GetBatchVertices(0)[4].position.x == 3.0f);
+	DOCTEST_CHECK(batch.GetBatchVertices(1)[4].position.x == 2.0f);
+
+	batch.Clear();
+	DOCTEST_CHECK(batch.GetQuadCount() == 0);
+	DOCTEST_CHECK(batch.GetBatchCount() == 0);
+	batch.Draw(first, sf::IntRect(0, 0, 8, 8), en::Vector2f(0.0f, 0.0f));
+	DOCTEST_CHECK(batch.GetBatchCount() == 1);
+	DOCTEST_CHECK(batch.GetBatchTexture(0) == &first);
+	DOCTEST_CHECK(batch.GetBatchVertices(0).getVertexCount() == 4);
+}
+
+// Run with --no-skip
+DOCTEST_TEST_CASE("SpriteBatch benchmark" * doctest::skip())
+{
+	const en::U32 frameCount = 100;
+	const en::U32 quadCount = 10000;
+	sf::Texture textures[4];
+	en::SpriteBatch batch;
+
+	en::Clock clock;
+	for (en::U32 frame = 0; frame < frameCount; ++frame)
+	{
+		batch.Clear();
+		for (en::U32 i = 0; i < quadCount; ++i)
+		{
+			const en::F32 value = static_cast<en::F32>(i + frame);
+			batch.Draw(textures[i % 4], sf::IntRect(0, 0, 64, 64), en::Vector2f(value, value * 0.5f), en::Vector2f(32.0f, 32.0f), en::Vector2f(1.5f, 1.5f), value);
+		}
+	}
+	const en::F32 elapsed = clock.getElapsedTime().asSeconds();
+	DOCTEST_CHECK(batch.GetQuadCount() == quadCount);
+	DOCTEST_CHECK(batch.GetBatchCount() == 4);
+	std::printf("SpriteBatch : %u quads in %.3f ms/frame, %.1f ns/quad\n", quadCount, elapsed * 1000.0f / frameCount, elapsed * 1000000000.0f / (frameCount * quadCount));
+}
@@ -0,0 +1,112 @@
+#include <Enlivengine/System/BitStream.hpp>
+
+#include <doctest/doctest.h>
+
+DOCTEST_TEST_CASE("BitStream bits")
+{
+	DOCTEST_CHECK(en::GetBitsRequired(0) == 1);
+	DOCTEST_CHECK(en::GetBitsRequired(1) == 1);
+	DOCTEST_CHECK(en::GetBitsRequired(4) == 3);
+	DOCTEST_CHECK(en::GetBitsRequired(255) == 8);
+	DOCTEST_CHECK(en::GetBitsRequired(256) == 9);
+	DOCTEST_CHECK(en::GetBitsRequired(en::U32_Max) == 32);
+
+	en::BitWriter writer;
+	DOCTEST_CHECK(writer.GetBitCount() == 0);
+	DOCTEST_CHECK(writer.GetByteCount() == 0);
+	writer.WriteBits(5, 3);
+	writer.WriteBool(true);
+	writer.WriteBits(0x1ABC, 13);
+	writer.WriteBits(en::U32_Max, 32);
+	writer.WriteBits(0, 1);
+	writer.WriteBits(0xDEADBEEF, 32);
+	DOCTEST_CHECK(writer.GetBitCount() == 82);
+	DOCTEST_CHECK(writer.GetByteCount() == 11);
+
+	en::BitReader reader(writer.GetData(), writer.GetByteCount());
+	DOCTEST_CHECK(reader.ReadBits(3) == 5);
+	DOCTEST_CHECK(reader.ReadBool());
+	DOCTEST_CHECK(reader.ReadBits(13) == 0x1ABC);
+	DOCTEST_CHECK(reader.ReadBits(32) == en::U32_Max);
+	DOCTEST_CHECK(reader.ReadBits(1) == 0);
+	DOCTEST_CHECK(reader.ReadBits(32) == 0xDEADBEEF);
+	DOCTEST_CHECK(reader.IsValid());
+	DOCTEST_CHECK(reader.GetRemainingBits() == 6);
+
+	// Padding bits can be read, but not more
+	DOCTEST_CHECK(reader.ReadBits(6) == 0);
+	DOCTEST_CHECK(reader.IsValid());
+	DOCTEST_CHECK(reader.ReadBits(1) == 0);
+	DOCTEST_CHECK(!reader.IsValid());
+	DOCTEST_CHECK(reader.ReadBits(1) == 0);
+	DOCTEST_CHECK(!reader);
+
+	writer.Clear();
+	DOCTEST_CHECK(writer.GetBitCount() == 0);
+	DOCTEST_CHECK(writer.GetByteCount() == 0);
+}
+
+DOCTEST_TEST_CASE("BitStream var U32")
+{
+	const en::U32 values[] = { 0, 1, 127, 128, 300, 16383, 16384, 1000000, en::U32_Max };
+
+	en::BitWriter writer;
+	for (en::U32 value : values)
+	{
+		writer.WriteVarU32(value);
+	}
+	// 1 + 1 + 1 + 2 + 2 + 2 + 3 + 3 + 5 bytes
+	DOCTEST_CHECK(writer.GetByteCount() == 20);
+
+	en::BitReader reader(writer.GetData(), writer.GetByteCount());
+	for (en::U32 value : values)
+	{
+		DOCTEST_CHECK(reader.ReadVarU32() == value);
+	}
+	DOCTEST_CHECK(reader.IsValid());
+	DOCTEST_CHECK(reader.GetRemainingBits() == 0);
+
+	// Truncated
+	en::BitReader truncatedReader(writer.GetData() + 16, 2);
+	truncatedReader.ReadVarU32();
+	DOCTEST_CHECK(!truncatedReader.IsValid());
+}
+
+DOCTEST_TEST_CASE("BitStream floats")
+{
+	const en::BitQuantization quantization(-640.0f, 4736.0f, 16);
+	DOCTEST_CHECK(quantization.GetResolution() < 0.1f);
+	DOCTEST_CHECK(quantization.Quantize(-640.0f) == 0);
+	DOCTEST_CHECK(quantization.Quantize(4736.0f) == 65535);
+	DOCTEST_CHECK(quantization.Quantize(-10000.0f) == 0);
+	DOCTEST_CHECK(quantization.Quantize(10000.0f) == 65535);
+
+	const en::F32 values[] = { -640.0f, -1.5f, 0.0f, 0.01f, 123.456f, 2048.0f, 4735.99f, 4736.0f };
+
+	en::BitWriter writer;
+	for (en::F32 value : values)
+	{
+		writer.WriteFloat(value, quantization);
+		writer.WriteF32(value);
+	}
+	DOCTEST_CHECK(writer.GetBitCount() == 8 * (16 + 32));
+
+	en::BitReader reader(writer.GetData(), writer.GetByteCount());
+	for (en::F32 value : values)
+	{
+		const en::F32 quantized = reader.ReadFloat(quantization);
+		DOCTEST_CHECK(quantized >= value - quantization.GetResolution() * 0.5f - 0.001f);
+		DOCTEST_CHECK(quantized <= value + quantization.GetResolution() * 0.5f + 0.001f);
+		DOCTEST_CHECK(reader.ReadF32() == value);
+	}
+	DOCTEST_CHECK(reader.IsValid());
+
+	// Bounds are exact
+	const en::BitQuantization angle(0.0f, 360.0f, 12);
+	en::BitWriter angleWriter;
+	angleWriter.WriteFloat(0.0f, angle);
+	angleWriter.WriteFloat(360.0f, angle);
+	en::BitReader angleReader(angleWriter.GetData(), angleWriter.GetByteCount());
+	DOCTEST_CHECK(angleReader.ReadFloat(angle) == 0.0f);
+	DOCTEST_CHECK(angleReader.ReadFloat(angle) == 360.0f);
+}
@@ -0,0 +1,42 @@
+#include <Enlivengine/System/FixedTimestep.hpp>
+
+#include <doctest/doctest.h>
+
+DOCTEST_TEST_CASE("FixedTimestep steps")
+{
+	en::FixedTimestep timestep(en::milliseconds(10), 5);
+	DOCTEST_CHECK(timestep.Advance(en::milliseconds(4)) == 0);
+	DOCTEST_CHECK(timestep.GetRemainingTime() == en::milliseconds(6));
+	DOCTEST_CHECK(timestep.Advance(en::milliseconds(6)) == 1);
+	DOCTEST_CHECK(timestep.Advance(en::milliseconds(25)) == 2);
+	DOCTEST_CHECK(timestep.GetRemainingTime() == en::milliseconds(5));
+	DOCTEST_CHECK(timestep.Advance(en::milliseconds(5)) == 1);
+	DOCTEST_CHECK(timestep.GetOverrunCount() == 0);
+	DOCTEST_CHECK(timestep.GetDroppedStepCount() == 0);
+	DOCTEST_CHECK(timestep.GetMaxDueStepCount() == 2);
+
+	timestep.Advance(en::milliseconds(7));
+	timestep.Reset();
+	DOCTEST_CHECK(timestep.Advance(en::milliseconds(7)) == 0);
+}
+
+DOCTEST_TEST_CASE("FixedTimestep catch-up limit")
+{
+	en::FixedTimestep timestep(en::milliseconds(10), 3);
+
+	// A hitch : only maxSteps are run, the late ones are dropped and the remainder is kept
+	DOCTEST_CHECK(timestep.Advance(en::milliseconds(124)) == 3);
+	DOCTEST_CHECK(timestep.GetOverrunCount() == 1);
+	DOCTEST_CHECK(timestep.GetDroppedStepCount() == 9);
+	DOCTEST_CHECK(timestep.GetMaxDueStepCount() == 12);
+	DOCTEST_CHECK(timestep.GetRemainingTime() == en::milliseconds(6));
+
+	// Back to normal right after
+	DOCTEST_CHECK(timestep.Advance(en::milliseconds(16)) == 2);
+	DOCTEST_CHECK(timestep.GetOverrunCount() == 1);
+
+	timestep.ResetStatistics();
+	DOCTEST_CHECK(timestep.GetOverrunCount() == 0);
+	DOCTEST_CHECK(timestep.GetDroppedStepCount() == 0);
+	DOCTEST_CHECK(timestep.GetMaxDueStepCount() == 0);
+}
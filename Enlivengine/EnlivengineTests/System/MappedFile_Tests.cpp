@@ -0,0 +1,38 @@
+#include <Enlivengine/System/MappedFile.hpp>
+
+#include <doctest/doctest.h>
+
+#include <cstdio>
+#include <cstring>
+
+DOCTEST_TEST_CASE("MappedFile")
+{
+	const std::string filename = "MappedFile_Tests.bin";
+	const char content[] = "Enlivengine mapped file";
+	std::FILE* file = std::fopen(filename.c_str(), "wb");
+	DOCTEST_REQUIRE(file != nullptr);
+	std::fwrite(content, 1, sizeof(content), file);
+	std::fclose(file);
+
+	en::MappedFile mappedFile;
+	DOCTEST_CHECK(!mappedFile.IsOpen());
+	DOCTEST_CHECK(mappedFile.Open(filename));
+	DOCTEST_CHECK(mappedFile.IsOpen());
+	DOCTEST_CHECK(mappedFile.GetSize() == sizeof(content));
+	DOCTEST_CHECK(std::memcmp(mappedFile.GetData(), content, sizeof(content)) == 0);
+
+	mappedFile.Close();
+	DOCTEST_CHECK(!mappedFile.IsOpen());
+	DOCTEST_CHECK(mappedFile.GetData() == nullptr);
+	DOCTEST_CHECK(mappedFile.GetSize() == 0);
+
+	// Missing and empty files
+	DOCTEST_CHECK(!mappedFile.Open("MappedFile_Tests_Missing.bin"));
+	file = std::fopen(filename.c_str(), "wb");
+	DOCTEST_REQUIRE(file != nullptr);
+	std::fclose(file);
+	DOCTEST_CHECK(!mappedFile.Open(filename));
+	DOCTEST_CHECK(!mappedFile.IsOpen());
+
+	std::remove(filename.c_str());
+}
@@ -0,0 +1,99 @@
+#include <Enlivengine/System/Metrics.hpp>
+
+#include <doctest/doctest.h>
+
+#include <thread>
+
+DOCTEST_TEST_CASE("MetricHistogram buckets")
+{
+	// Exact below SubBucketCount
+	for (en::U64 value = 0; value < en::MetricHistogram::SubBucketCount; ++value)
+	{
+		DOCTEST_CHECK(en::MetricHistogram::GetBucketHighestValue(en::MetricHistogram::GetBucketIndex(value)) == value);
+	}
+
+	// Each value is in its bucket, and the bucket is within 1/SubBucketCount of it
+	const en::U64 values[] = { 16, 17, 31, 32, 33, 100, 1000, 16666, 123456789, 1ull << 40, ~0ull };
+	for (en::U64 value : values)
+	{
+		const en::U32 bucket = en::MetricHistogram::GetBucketIndex(value);
+		DOCTEST_CHECK(bucket < en::MetricHistogram::BucketCount);
+		const en::U64 highest = en::MetricHistogram::GetBucketHighestValue(bucket);
+		DOCTEST_CHECK(highest >= value);
+		DOCTEST_CHECK(highest - value <= value / en::MetricHistogram::SubBucketCount);
+		DOCTEST_CHECK(en::MetricHistogram::GetBucketHighestValue(bucket - 1) < value);
+	}
+	DOCTEST_CHECK(en::MetricHistogram::GetBucketIndex(~0ull) == en::MetricHistogram::BucketCount - 1);
+}
+
+DOCTEST_TEST_CASE("MetricHistogram percentiles")
+{
+	en::MetricHistogram histogram;
+	DOCTEST_CHECK(histogram.GetValueAtPercentile(50.0) == 0);
+
+	for (en::U64 value = 1; value <= 1000; ++value)
+	{
+		histogram.Record(value);
+	}
+	DOCTEST_CHECK(histogram.GetCount() == 1000);
+	DOCTEST_CHECK(histogram.GetSum() == 500500);
+	DOCTEST_CHECK(histogram.GetMax() == 1000);
+
+	const en::U64 median = histogram.GetValueAtPercentile(50.0);
+	DOCTEST_CHECK(median >= 500);
+	DOCTEST_CHECK(median <= 500 + 500 / en::MetricHistogram::SubBucketCount);
+	const en::U64 p99 = histogram.GetValueAtPercentile(99.0);
+	DOCTEST_CHECK(p99 >= 990);
+	DOCTEST_CHECK(p99 <= 990 + 990 / en::MetricHistogram::SubBucketCount);
+
+	histogram.Reset();
+	DOCTEST_CHECK(histogram.GetCount() == 0);
+	DOCTEST_CHECK(histogram.GetMax() == 0);
+}
+
+DOCTEST_TEST_CASE("MetricsRegistry concurrent recording")
+{
+	en::MetricsRegistry registry;
+	en::MetricCounter& counter = registry.AddCounter("test_events_total", "Events");
+	en::MetricHistogram& histogram = registry.AddHistogram("test_duration_microseconds", "Duration");
+
+	std::vector<std::thread> threads;
+	for (en::U32 t = 0; t < 4; ++t)
+	{
+		threads.emplace_back([&counter, &histogram, t]()
+		{
+			for (en::U32 i = 0; i < 10000; ++i)
+			{
+				counter.Add();
+				histogram.Record(t * 100 + i % 100);
+			}
+		});
+	}
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+	DOCTEST_CHECK(counter.Get() == 40000);
+	DOCTEST_CHECK(histogram.GetCount() == 40000);
+	DOCTEST_CHECK(histogram.GetMax() == 399);
+}
+
+DOCTEST_TEST_CASE("MetricsRegistry Prometheus text")
+{
+	en::MetricsRegistry registry;
+	registry.AddCounter("test_packets_total", "Packets").Add(3);
+	registry.AddGauge("test_players", "Players").Set(-2);
+	en::MetricHistogram& histogram = registry.AddHistogram("test_bytes", "Bytes");
+	histogram.Record(5);
+	histogram.Record(5);
+	histogram.Record(40);
+
+	std::string output;
+	registry.WritePrometheus(output);
+	DOCTEST_CHECK(output.find("# TYPE test_packets_total counter\ntest_packets_total 3\n") != std::string::npos);
+	DOCTEST_CHECK(output.find("# TYPE test_players gauge\ntest_players -2\n") != std::string::npos);
+	DOCTEST_CHECK(output.find("# TYPE test_bytes histogram\n") != std::string::npos);
+	DOCTEST_CHECK(output.find("test_bytes_bucket{le=\"5\"} 2\n") != std::string::npos);
+	DOCTEST_CHECK(output.find("test_bytes_bucket{le=\"41\"} 3\n") != std::string::npos);
+	DOCTEST_CHECK(output.find("test_bytes_bucket{le=\"+Inf\"} 3\ntest_bytes_sum 50\ntest_bytes_count 3\n") != std::string::npos);
+}
@@ -0,0 +1,150 @@
+#include <Enlivengine/System/SPSCQueue.hpp>
+
+#include <thread>
+
+#include <doctest/doctest.h>
+
+DOCTEST_TEST_CASE("SPSCQueue push/pop")
+{
+	en::SPSCQueue<en::U32> queue(4);
+	DOCTEST_CHECK(queue.GetCapacity() == 4);
+	DOCTEST_CHECK(queue.IsEmpty());
+
+	en::U32 value = 0;
+	DOCTEST_CHECK(!queue.Pop(value));
+	DOCTEST_CHECK(queue.BeginPop() == nullptr);
+
+	DOCTEST_CHECK(queue.Push(1));
+	DOCTEST_CHECK(queue.Push(2));
+	DOCTEST_CHECK(queue.Push(3));
+	DOCTEST_CHECK(queue.Push(4));
+	DOCTEST_CHECK(queue.GetSize() == 4);
+	DOCTEST_CHECK(!queue.Push(5));
+	DOCTEST_CHECK(queue.BeginPush() == nullptr);
+
+	DOCTEST_CHECK(queue.Pop(value));
+	DOCTEST_CHECK(value == 1);
+	DOCTEST_CHECK(queue.Push(5));
+
+	// In place
+	en::U32* slot = queue.BeginPop();
+	DOCTEST_CHECK(slot != nullptr);
+	DOCTEST_CHECK(*slot == 2);
+	queue.EndPop();
+
+	for (en::U32 expected = 3; expected <= 5; ++expected)
+	{
+		DOCTEST_CHECK(queue.Pop(value));
+		DOCTEST_CHECK(value == expected);
+	}
+	DOCTEST_CHECK(queue.IsEmpty());
+
+	// Indices wrap around the slots many times
+	for (en::U32 i = 0; i < 100; ++i)
+	{
+		en::U32* pushSlot = queue.BeginPush();
+		DOCTEST_CHECK(pushSlot != nullptr);
+		*pushSlot = i;
+		queue.EndPush();
+		DOCTEST_CHECK(queue.Pop(value));
+		DOCTEST_CHECK(value == i);
+	}
+	DOCTEST_CHECK(queue.IsEmpty());
+}
+
+DOCTEST_TEST_CASE("SPSCQueue batches")
+{
+	en::SPSCQueue<en::U32> queue(8);
+	en::U32 count = 0;
+
+	queue.BeginPop(8, count);
+	DOCTEST_CHECK(count == 0);
+
+	en::U32* slots = queue.BeginPush(5, count);
+	DOCTEST_CHECK(count == 5);
+	for (en::U32 i = 0; i < count; ++i)
+	{
+		slots[i] = i;
+	}
+	queue.EndPush(count);
+	DOCTEST_CHECK(queue.GetSize() == 5);
+
+	slots = queue.BeginPop(3, count);
+	DOCTEST_CHECK(count == 3);
+	DOCTEST_CHECK(slots[0] == 0);
+	DOCTEST_CHECK(slots[2] == 2);
+	queue.EndPop(count);
+
+	// Only contiguous slots : stops at the end of the ring
+	slots = queue.BeginPush(8, count);
+	DOCTEST_CHECK(count == 3);
+	for (en::U32 i = 0; i < count; ++i)
+	{
+		slots[i] = 5 + i;
+	}
+	queue.EndPush(count);
+	slots = queue.BeginPush(8, count);
+	DOCTEST_CHECK(count == 3);
+	for (en::U32 i = 0; i < count; ++i)
+	{
+		slots[i] = 8 + i;
+	}
+	queue.EndPush(count);
+	queue.BeginPush(8, count);
+	DOCTEST_CHECK(count == 0);
+
+	slots = queue.BeginPop(8, count);
+	DOCTEST_CHECK(count == 5);
+	DOCTEST_CHECK(slots[0] == 3);
+	DOCTEST_CHECK(slots[4] == 7);
+	queue.EndPop(count);
+	slots = queue.BeginPop(8, count);
+	DOCTEST_CHECK(count == 3);
+	DOCTEST_CHECK(slots[0] == 8);
+	DOCTEST_CHECK(slots[2] == 10);
+	queue.EndPop(count);
+	DOCTEST_CHECK(queue.IsEmpty());
+}
+
+DOCTEST_TEST_CASE("SPSCQueue threads")
+{
+	const en::U32 count = 200000;
+	en::SPSCQueue<en::U32> queue(64);
+
+	std::thread producer([&queue, count]()
+	{
+		for (en::U32 i = 0; i < count; )
+		{
+			if (queue.Push(i))
+			{
+				i++;
+			}
+			else
+			{
+				std::this_thread::yield();
+			}
+		}
+	});
+
+	// Everything arrives, in order
+	bool ordered = true;
+	en::U32 expected = 0;
+	while (expected < count)
+	{
+		en::U32 value = 0;
+		if (queue.Pop(value))
+		{
+			ordered = ordered && (value == expected);
+			expected++;
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+	producer.join();
+
+	DOCTEST_CHECK(ordered);
+	DOCTEST_CHECK(expected == count);
+	DOCTEST_CHECK(queue.IsEmpty());
+}
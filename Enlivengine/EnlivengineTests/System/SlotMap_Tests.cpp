@@ -0,0 +1,123 @@
+#include <Enlivengine/System/SlotMap.hpp>
+
+#include <doctest/doctest.h>
+
+#include <unordered_set>
+
+DOCTEST_TEST_CASE("SlotMap add/get/remove")
+{
+	en::SlotMap<en::U32> map;
+	DOCTEST_CHECK(map.Size() == 0);
+	DOCTEST_CHECK(map.Empty());
+	DOCTEST_CHECK(!map.Has(en::SlotMap<en::U32>::InvalidHandle));
+
+	const en::SlotMap<en::U32>::Handle a = map.Add(10);
+	const en::SlotMap<en::U32>::Handle b = map.Add(20);
+	const en::SlotMap<en::U32>::Handle c = map.Add(30);
+	DOCTEST_CHECK(a != en::SlotMap<en::U32>::InvalidHandle);
+	DOCTEST_CHECK(a != b);
+	DOCTEST_CHECK(b != c);
+	DOCTEST_CHECK(map.Size() == 3);
+	DOCTEST_CHECK(!map.Empty());
+	DOCTEST_CHECK(*map.Get(a) == 10);
+	DOCTEST_CHECK(*map.Get(b) == 20);
+	DOCTEST_CHECK(*map.Get(c) == 30);
+	DOCTEST_CHECK(map.GetIndex(a) == 0);
+	DOCTEST_CHECK(map.GetHandle(2) == c);
+
+	// Swap-and-pop : c takes the place of a
+	DOCTEST_CHECK(map.Remove(a));
+	DOCTEST_CHECK(map.Size() == 2);
+	DOCTEST_CHECK(!map.Has(a));
+	DOCTEST_CHECK(map.Get(a) == nullptr);
+	DOCTEST_CHECK(!map.Remove(a));
+	DOCTEST_CHECK(map[0] == 30);
+	DOCTEST_CHECK(map[1] == 20);
+	DOCTEST_CHECK(map.GetIndex(c) == 0);
+	DOCTEST_CHECK(*map.Get(b) == 20);
+	DOCTEST_CHECK(*map.Get(c) == 30);
+
+	// Slot reuse doesn't revive old handles
+	const en::SlotMap<en::U32>::Handle d = map.Add(40);
+	DOCTEST_CHECK(d != a);
+	DOCTEST_CHECK(!map.Has(a));
+	DOCTEST_CHECK(*map.Get(d) == 40);
+	DOCTEST_CHECK(map.GetValues().size() == 3);
+
+	map.RemoveAt(map.Size() - 1);
+	DOCTEST_CHECK(!map.Has(d));
+	DOCTEST_CHECK(map.Size() == 2);
+
+	map.Clear();
+	DOCTEST_CHECK(map.Empty());
+	DOCTEST_CHECK(!map.Has(b));
+	DOCTEST_CHECK(!map.Has(c));
+}
+
+DOCTEST_TEST_CASE("SlotMap iteration and removal during iteration")
+{
+	en::SlotMap<en::U32> map;
+	for (en::U32 i = 0; i < 100; ++i)
+	{
+		map.Add(i);
+	}
+
+	// Remove even values, the same way entities are removed while updating them
+	en::U32 size = map.Size();
+	for (en::U32 i = 0; i < size; )
+	{
+		if (map[i] % 2 == 0)
+		{
+			map.RemoveAt(i);
+			size--;
+		}
+		else
+		{
+			i++;
+		}
+	}
+	DOCTEST_CHECK(map.Size() == 50);
+
+	en::U32 sum = 0;
+	for (const en::U32 value : map)
+	{
+		DOCTEST_CHECK(value % 2 == 1);
+		sum += value;
+	}
+	DOCTEST_CHECK(sum == 2500);
+
+	for (en::U32 i = 0; i < map.Size(); ++i)
+	{
+		DOCTEST_CHECK(map.GetIndex(map.GetHandle(i)) == static_cast<en::I32>(i));
+	}
+}
+
+DOCTEST_TEST_CASE("SlotMap generation wrap")
+{
+	using Map = en::SlotMap<en::U32>;
+	Map map;
+	const Map::Handle kept = map.Add(0);
+
+	// The same slot is reused until its generation is exhausted, then retired
+	std::unordered_set<Map::Handle> handles;
+	const en::U32 reuseCount = Map::kGenerationMask + 10;
+	for (en::U32 i = 0; i < reuseCount; ++i)
+	{
+		const Map::Handle handle = map.Add(i);
+		DOCTEST_CHECK(handles.insert(handle).second);
+		DOCTEST_CHECK(map.Remove(handle));
+		DOCTEST_CHECK(!map.Has(handle));
+	}
+	DOCTEST_CHECK(handles.size() == reuseCount);
+	DOCTEST_CHECK(map.Size() == 1);
+	DOCTEST_CHECK(*map.Get(kept) == 0);
+
+	// A retired slot isn't used anymore : the first slot after it is
+	en::U32 slotCount = 0;
+	for (const Map::Handle handle : handles)
+	{
+		const en::U32 slotIndex = handle & Map::kIndexMask;
+		slotCount = (slotIndex + 1 > slotCount) ? slotIndex + 1 : slotCount;
+	}
+	DOCTEST_CHECK(slotCount == 3);
+}
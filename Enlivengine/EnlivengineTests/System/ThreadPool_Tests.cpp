@@ -0,0 +1,55 @@
+#include <Enlivengine/System/ThreadPool.hpp>
+
+#include <doctest/doctest.h>
+
+DOCTEST_TEST_CASE("ThreadPool without workers")
+{
+	en::ThreadPool pool(0);
+	DOCTEST_CHECK(pool.GetWorkerCount() == 0);
+
+	std::vector<en::U32> values(10, 0);
+	pool.ParallelFor(static_cast<en::U32>(values.size()), [&values](en::U32 index)
+	{
+		values[index] = index * 2;
+	});
+	for (en::U32 i = 0; i < values.size(); ++i)
+	{
+		DOCTEST_CHECK(values[i] == i * 2);
+	}
+
+	pool.ParallelFor(0, [](en::U32) { DOCTEST_CHECK(false); });
+}
+
+DOCTEST_TEST_CASE("ThreadPool ParallelFor")
+{
+	en::ThreadPool pool(3);
+	DOCTEST_CHECK(pool.GetWorkerCount() == 3);
+
+	// Each index exactly once, many times in a row
+	std::vector<std::atomic<en::U32>> calls(100);
+	for (auto& call : calls)
+	{
+		call = 0;
+	}
+	for (en::U32 round = 0; round < 200; ++round)
+	{
+		pool.ParallelFor(static_cast<en::U32>(calls.size()), [&calls](en::U32 index)
+		{
+			calls[index]++;
+		});
+	}
+	bool exactlyOnce = true;
+	for (auto& call : calls)
+	{
+		exactlyOnce = exactlyOnce && (call == 200);
+	}
+	DOCTEST_CHECK(exactlyOnce);
+
+	// Everything is done when it returns
+	std::atomic<en::U32> sum(0);
+	pool.ParallelFor(1000, [&sum](en::U32 index)
+	{
+		sum += index;
+	});
+	DOCTEST_CHECK(sum == 999 * 1000 / 2);
+}
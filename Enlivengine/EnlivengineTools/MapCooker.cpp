@@ -0,0 +1,114 @@
+#include <Enlivengine/System/Log.hpp>
+#include <Enlivengine/System/Time.hpp>
+#include <Enlivengine/Application/ResourceManager.hpp>
+#include <Enlivengine/Map/Map.hpp>
+#include <Enlivengine/Map/TileLayer.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+// Cooks a Tiled map and its tilesets into a binary map (.enmap) loaded in place by Map::LoadFromBinaryFile
+// MapCooker <map.tmx> <map.enmap> [loadCount]
+// With a loadCount, both maps are then loaded loadCount times, timed and compared tile by tile
+
+namespace
+{
+
+en::tmx::MapPtr LoadMap(const std::string& identifier, const std::string& filename)
+{
+	// Reload : the map is parsed again, its tilesets and textures are reused
+	return en::ResourceManager::GetInstance().Create<en::tmx::Map>(identifier, en::tmx::MapLoader::FromFile(filename), en::ResourceKnownStrategy::Reload);
+}
+
+en::F32 BenchmarkLoads(const std::string& identifier, const std::string& filename, en::U32 loadCount)
+{
+	en::Clock clock;
+	for (en::U32 i = 0; i < loadCount; ++i)
+	{
+		LoadMap(identifier, filename);
+	}
+	return clock.getElapsedTime().asSeconds() * 1000.0f / static_cast<en::F32>(loadCount);
+}
+
+bool HaveSameTiles(en::tmx::Map& a, en::tmx::Map& b)
+{
+	if (a.GetLayerCount() != b.GetLayerCount() || a.GetTilesetCount() != b.GetTilesetCount())
+	{
+		return false;
+	}
+	for (en::U32 layerIndex = 0; layerIndex < a.GetLayerCount(); ++layerIndex)
+	{
+		if (a.GetLayerTypeByIndex(layerIndex) != en::tmx::LayerBase::LayerType::TileLayer)
+		{
+			continue;
+		}
+		const en::tmx::TileLayer& layerA = a.GetLayerByIndexAs<en::tmx::TileLayer>(layerIndex);
+		const en::tmx::TileLayer& layerB = b.GetLayerByIndexAs<en::tmx::TileLayer>(layerIndex);
+		if (layerA.GetSize() != layerB.GetSize())
+		{
+			return false;
+		}
+		en::Vector2u coords;
+		for (coords.y = 0; coords.y < layerA.GetSize().y; ++coords.y)
+		{
+			for (coords.x = 0; coords.x < layerA.GetSize().x; ++coords.x)
+			{
+				if (layerA.GetTile(coords) != layerB.GetTile(coords))
+				{
+					return false;
+				}
+			}
+		}
+	}
+	return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+	if (argc < 3)
+	{
+		std::printf("Usage : MapCooker <map.tmx> <map%s> [loadCount]\n", en::tmx::BinaryMap::Extension);
+		return EXIT_FAILURE;
+	}
+
+#ifdef ENLIVE_ENABLE_LOG
+	en::LogManager::GetInstance().Initialize();
+#endif // ENLIVE_ENABLE_LOG
+
+	const std::string sourceFilename = argv[1];
+	const std::string cookedFilename = argv[2];
+	const en::U32 loadCount = (argc > 3) ? static_cast<en::U32>(std::atoi(argv[3])) : 0;
+
+	en::tmx::MapPtr sourceMap = LoadMap("source", sourceFilename);
+	if (!sourceMap.IsValid() || !sourceMap.Get().IsLoaded())
+	{
+		std::printf("Can't load %s\n", sourceFilename.c_str());
+		return EXIT_FAILURE;
+	}
+	if (!sourceMap.Get().SaveToBinaryFile(cookedFilename))
+	{
+		std::printf("Can't cook %s\n", cookedFilename.c_str());
+		return EXIT_FAILURE;
+	}
+
+	en::tmx::MapPtr cookedMap = LoadMap("cooked", cookedFilename);
+	if (!cookedMap.IsValid() || !cookedMap.Get().IsLoaded() || !HaveSameTiles(sourceMap.Get(), cookedMap.Get()))
+	{
+		std::printf("%s doesn't load back as %s\n", cookedFilename.c_str(), sourceFilename.c_str());
+		return EXIT_FAILURE;
+	}
+	std::printf("Cooked %s into %s\n", sourceFilename.c_str(), cookedFilename.c_str());
+
+	if (loadCount > 0)
+	{
+		const en::F32 sourceTime = BenchmarkLoads("source", sourceFilename, loadCount);
+		const en::F32 cookedTime = BenchmarkLoads("cooked", cookedFilename, loadCount);
+		std::printf("%s : %.3f ms/load\n", sourceFilename.c_str(), sourceTime);
+		std::printf("%s : %.3f ms/load, %.1fx faster\n", cookedFilename.c_str(), cookedTime, (cookedTime > 0.0f) ? sourceTime / cookedTime : 0.0f);
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -2,6 +2,9 @@
 
 #include <SFML/Network.hpp>
 #include <Common.hpp>
+#include <PacketBatch.hpp>
+#include <PacketPool.hpp>
+#include <ReliableEndpoint.hpp>
 
 #include <Enlivengine/System/Log.hpp>
 #include <Enlivengine/Math/Random.hpp> // Random for ClientID
@@ -15,6 +18,11 @@ public:
 		, mServerPort(DefaultServerPort)
 		, mRunning(false)
 		, mClientID(en::U32_Max)
+		, mDatagram()
+		, mDatagramReader()
+		, mReliable()
+		, mReliablePacket()
+		, mTime(en::Time::Zero)
 	{
 	}
 
@@ -28,6 +36,8 @@ public:
 			return false;
 		}
 		mSocket.setBlocking(false);
+		mReliable.Reset();
+		mTime = en::Time::Zero;
 		mRunning = true;
 		LogInfo(en::LogChannel::All, 5, "Started on port %d", mSocket.getLocalPort());
 		return true;
@@ -37,6 +47,7 @@ public:
 	{
 		LogInfo(en::LogChannel::All, 5, "Stopping...%s", "");
 		mSocket.unbind();
+		mDatagramReader.Clear();
 		mRunning = false;
 		LogInfo(en::LogChannel::All, 5, "Stopped%s", "");
 	}
@@ -49,12 +60,67 @@ public:
 		mSocket.send(packet, mServerAddress, mServerPort); 
 	}
 
+	void SendPacket(const PooledPacket& packet)
+	{
+		if (packet)
+		{
+			mSocket.send(packet.getData(), packet.getDataSize(), mServerAddress, mServerPort);
+		}
+	}
+
+	// Queued until the next SendReliablePackets, then sent again until the server acks it
+	void SendReliablePacket(const PooledPacket& packet, ReliableChannelID channel)
+	{
+		if (packet && !mReliable.Send(packet.getData(), packet.getDataSize(), channel))
+		{
+			LogWarning(en::LogChannel::All, 6, "Reliable queue full, message dropped%s", "");
+		}
+	}
+
+	// Once per frame : the queued reliable messages, the resends due and the acks
+	void SendReliablePackets(en::Time dt)
+	{
+		mTime += dt;
+		mReliablePacket.clear();
+		mReliablePacket << static_cast<en::U8>(ClientPacketID::Reliable);
+		if (IsRunning() && mReliable.WritePacket(mReliablePacket, mTime))
+		{
+			SendPacket(mReliablePacket);
+		}
+	}
+
+	// The server batches its messages : return the next message of the current datagram, then receive another one
+	// Reliable packets are unpacked, their messages are returned in order
 	bool PollPacket(sf::Packet& packet)
 	{
+		if (mReliable.PollMessage(packet))
+		{
+			return true;
+		}
+
 		static sf::IpAddress remoteAddress;
 		static en::U16 remotePort;
-		while (mSocket.receive(packet, remoteAddress, remotePort) == sf::Socket::Done)
+		while (true)
 		{
+			while (mDatagramReader.Next(packet))
+			{
+				const char* data = static_cast<const char*>(packet.getData());
+				if (packet.getDataSize() == 0 || static_cast<en::U8>(data[0]) != static_cast<en::U8>(ServerPacketID::Reliable))
+				{
+					return true;
+				}
+				mReliable.ReadPacket(data + 1, packet.getDataSize() - 1, mTime);
+				if (mReliable.PollMessage(packet))
+				{
+					return true;
+				}
+			}
+
+			if (mSocket.receive(mDatagram, remoteAddress, remotePort) != sf::Socket::Done)
+			{
+				return false;
+			}
+
 			// Someone that is not the server is sending us packet
 			if (remotePort != mServerPort || remoteAddress != mServerAddress)
 			{
@@ -62,9 +128,8 @@ public:
 				continue;
 			}
 
-			return true;
+			mDatagramReader.Reset(mDatagram.getData(), mDatagram.getDataSize());
 		}
-		return false;
 	}
 
 	const sf::IpAddress& GetServerAddress() const { return mServerAddress; }
@@ -83,4 +148,9 @@ private:
 	en::U16 mServerPort;
 	bool mRunning;
 	en::U32 mClientID;
+	sf::Packet mDatagram;
+	PacketBatchReader mDatagramReader;
+	ReliableEndpoint mReliable;
+	sf::Packet mReliablePacket;
+	en::Time mTime; // Advanced by SendReliablePackets
 };
\ No newline at end of file
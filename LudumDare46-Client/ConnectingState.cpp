@@ -76,6 +76,7 @@ bool ConnectingState::update(en::Time dt)
 		{
 			ENLIVE_PROFILE_FUNCTION();
 			GameSingleton::HandleIncomingPackets();
+			GameSingleton::mClient.SendReliablePackets(dt);
 			if (GameSingleton::HasTimeout(dt))
 			{
 				clearStates();
@@ -15,7 +15,7 @@ bool GameMap::load()
 
 void GameMap::render(sf::RenderTarget& target)
 {
-	if (mMap.IsValid())
+	if (mMap.IsLoaded())
 	{
 		mMap.Get().Render(target);
 	}
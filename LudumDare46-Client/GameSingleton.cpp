@@ -7,14 +7,23 @@
 
 en::Application* GameSingleton::mApplication;
 ClientSocket GameSingleton::mClient;
+PacketPool GameSingleton::mPacketPool;
+sf::Packet GameSingleton::mReceivedPacket;
 en::Time GameSingleton::mLastPacketTime;
 GameMap GameSingleton::mMap;
 en::View GameSingleton::mView;
 std::vector<Player> GameSingleton::mPlayers;
-std::vector<Seed> GameSingleton::mSeeds;
-std::vector<Item> GameSingleton::mItems;
-std::vector<Bullet> GameSingleton::mBullets;
-std::vector<Blood> GameSingleton::mBloods;
+en::SlotMap<Seed> GameSingleton::mSeeds;
+en::SlotMap<Item> GameSingleton::mItems;
+en::SlotMap<Bullet> GameSingleton::mBullets;
+en::SlotMap<Blood> GameSingleton::mBloods;
+std::unordered_map<en::U32, en::U32> GameSingleton::mSeedHandles;
+std::unordered_map<en::U32, en::U32> GameSingleton::mItemHandles;
+std::unordered_map<en::U32, en::U32> GameSingleton::mBulletHandles;
+SnapshotBuffer GameSingleton::mSnapshots;
+en::U32 GameSingleton::mLastSnapshotSequence;
+en::Time GameSingleton::mRenderTime;
+en::Time GameSingleton::mInterpolationDelay = DefaultInterpolationDelay;
 en::Application::onApplicationStoppedType::ConnectionGuard GameSingleton::mApplicationStoppedSlot; 
 sf::Sprite GameSingleton::mCursor;
 GameSingleton::PlayingState GameSingleton::mPlayingState;
@@ -38,7 +47,7 @@ void GameSingleton::HandleIncomingPackets()
 		return;
 	}
 
-	sf::Packet packet;
+	sf::Packet& packet = mReceivedPacket;
 	while (mClient.PollPacket(packet))
 	{
 		mLastPacketTime = en::Time::Zero;
@@ -62,6 +71,9 @@ void GameSingleton::HandleIncomingPackets()
 			packet >> clientID;
 			LogInfo(en::LogChannel::All, 5, "ConnectionAccepted, ClientID %d", clientID);
 			mClient.SetClientID(clientID);
+			mSnapshots.Clear();
+			mLastSnapshotSequence = 0;
+			mRenderTime = en::Time::Zero;
 		} break;
 		case ServerPacketID::ConnectionRejected:
 		{
@@ -89,6 +101,9 @@ void GameSingleton::HandleIncomingPackets()
 				newPlayer.lastRotation = chicken.rotation;
 				newPlayer.animWalk = en::Time::Zero;
 				newPlayer.animIndex = 0;
+				newPlayer.interpolation.Clear();
+				newPlayer.interpolated = false;
+				newPlayer.relevant = false;
 				newPlayer.sprite.setOrigin({32.0f, 32.0f});
 				mPlayers.push_back(newPlayer);
 			}
@@ -103,6 +118,8 @@ void GameSingleton::HandleIncomingPackets()
 				newPlayer.lastRotation = chicken.rotation;
 				newPlayer.animWalk = en::Time::Zero;
 				newPlayer.animIndex = 0;
+				newPlayer.interpolation.Clear();
+				newPlayer.interpolated = false;
 				newPlayer.sprite.setOrigin({ 32.0f, 32.0f });
 			}
 		} break;
@@ -124,237 +141,77 @@ void GameSingleton::HandleIncomingPackets()
 			mClient.Stop();
 			mPlayingState = PlayingState::Connecting; // Try to kick when in game state
 		} break;
-		case ServerPacketID::PlayerInfo:
+		case ServerPacketID::PlayerList:
 		{
 			en::U32 clientID;
 			std::string nickname;
 			Chicken chicken;
-			packet >> clientID >> nickname >> chicken;
-			LogInfo(en::LogChannel::All, 5, "PlayerInfo for %s (ID: %d)", nickname.c_str(), clientID);
-			const en::I32 playerIndex = GetPlayerIndexFromClientID(clientID);
-			if (playerIndex == -1)
-			{
-				Player newPlayer;
-				newPlayer.clientID = clientID;
-				newPlayer.nickname = nickname;
-				newPlayer.chicken = chicken;
-				newPlayer.lastPos = chicken.position;
-				newPlayer.lastRotation = chicken.rotation;
-				newPlayer.animWalk = en::Time::Zero;
-				newPlayer.animIndex = 0;
-				newPlayer.sprite.setOrigin({ 32.0f, 32.0f });
-				mPlayers.push_back(newPlayer);
-			}
-			else
-			{
-				// Update player
-				Player& newPlayer = mPlayers[playerIndex];
-				newPlayer.clientID = clientID;
-				newPlayer.nickname = nickname;
-				newPlayer.chicken = chicken;
-				newPlayer.lastPos = chicken.position;
-				newPlayer.lastRotation = chicken.rotation;
-				newPlayer.animWalk = en::Time::Zero;
-				newPlayer.animIndex = 0;
-				newPlayer.sprite.setOrigin({ 32.0f, 32.0f });
-			}
-		} break;
-		case ServerPacketID::ItemInfo:
-		{
-			Item item;
-			packet >> item;
-			LogInfo(en::LogChannel::All, 4, "New item %d %f %f", item.itemID, item.position.x, item.position.y);
-			mItems.push_back(item);
-		} break;
-		case ServerPacketID::UpdateChicken:
-		{
-			en::U32 clientID;
-			packet >> clientID;
-			const en::I32 playerIndex = GetPlayerIndexFromClientID(clientID);
-			if (playerIndex >= 0)
-			{
-				packet >> mPlayers[playerIndex].chicken;
-				mPlayers[playerIndex].lastPos = mPlayers[playerIndex].chicken.position;
-				mPlayers[playerIndex].lastRotation = mPlayers[playerIndex].chicken.rotation;
-			}
-			else
-			{
-				LogWarning(en::LogChannel::All, 6, "Unknown player moved %d", packetIDRaw);
-			}
-		} break;
-		case ServerPacketID::AddSeed:
-		{
-			Seed seed;
-			packet >> seed;
-			LogInfo(en::LogChannel::All, 4, "New seed %f %f", seed.position.x, seed.position.y);
-			mSeeds.push_back(seed);
-			if (GameSingleton::IsClient(seed.clientID))
-			{
-				en::SoundPtr sound = en::AudioSystem::GetInstance().PlaySound("seedsSound");
-				if (sound.IsValid())
-				{
-					sound.SetVolume(0.25f);
-				}
-			}
-		} break;
-		case ServerPacketID::RemoveSeed:
-		{
-			en::U32 seedUID;
-			bool eated;
-			en::U32 eaterClientID;
-			packet >> seedUID >> eated >> eaterClientID;
-			LogInfo(en::LogChannel::All, 4, "Remove seed%s", "");
-			bool removed = false;
-			en::U32 size = static_cast<en::U32>(mSeeds.size());
-			for (en::U32 i = 0; i < size && !removed; )
-			{
-				if (mSeeds[i].seedUID == seedUID)
-				{
-					if (eated && IsInView(mSeeds[i].position))
-					{
-						if (IsClient(eaterClientID))
-						{
-							en::SoundPtr sound = en::AudioSystem::GetInstance().PlaySound("eat");
-							if (sound.IsValid())
-							{
-								sound.SetVolume(0.25f);
-							}
-						}
-					}
-					mSeeds.erase(mSeeds.begin() + i);
-					size--;
-					removed = true;
-				}
-				else
-				{
-					++i;
-				}
-			}
-		} break;
-		case ServerPacketID::AddItem:
-		{
-			Item item;
-			packet >> item;
-			LogInfo(en::LogChannel::All, 4, "New item %d %f %f", item.itemID, item.position.x, item.position.y);
-			mItems.push_back(item);
-		} break;
-		case ServerPacketID::RemoveItem:
-		{
-			en::U32 itemUID;
-			bool pickedUp;
-			en::U32 pickerClientID;
-			packet >> itemUID >> pickedUp >> pickerClientID;
-			LogInfo(en::LogChannel::All, 4, "Remove item%s", "");
-			bool removed = false;
-			en::U32 size = static_cast<en::U32>(mItems.size());
-			for (en::U32 i = 0; i < size && !removed; )
+			while (!packet.endOfPacket() && (packet >> clientID >> nickname >> chicken))
 			{
-				if (mItems[i].itemUID == itemUID)
+				LogInfo(en::LogChannel::All, 5, "PlayerList : %s (ID: %d)", nickname.c_str(), clientID);
+				const en::I32 playerIndex = GetPlayerIndexFromClientID(clientID);
+				if (playerIndex == -1)
 				{
-					if (pickedUp && IsInView(mItems[i].position))
-					{
-						en::SoundPtr sound = en::AudioSystem::GetInstance().PlaySound(GetItemSoundLootName(mItems[i].itemID));
-						if (sound.IsValid())
-						{
-							if (mItems[i].itemID == ItemID::Laser || mItems[i].itemID == ItemID::Uzi)
-							{
-								sound.SetVolume(0.4f);
-							}
-							else
-							{
-								sound.SetVolume(0.25f);
-							}
-						}
-
-						// Play music
-						if (IsClient(pickerClientID))
-						{
-							if (mMusic.IsValid())
-							{
-								mMusic.Stop();
-							}
-							mMusic = en::MusicPtr();
-							const char* name = GetItemMusicName(GameSingleton::mItems[i].itemID);
-							if (name != nullptr && strlen(name) > 0)
-							{
-								mMusic = en::AudioSystem::GetInstance().PlayMusic(name);
-								if (mMusic.IsValid())
-								{
-									mMusic.SetLoop(true);
-									if (GameSingleton::mItems[i].itemID == ItemID::Uzi)
-									{
-										mMusic.SetVolume(0.1f);
-									}
-									else
-									{
-										mMusic.SetVolume(0.2f);
-									}
-								}
-							}
-						}
-					}
-					mItems.erase(mItems.begin() + i);
-					size--;
-					removed = true;
+					Player newPlayer;
+					newPlayer.clientID = clientID;
+					newPlayer.nickname = nickname;
+					newPlayer.chicken = chicken;
+					newPlayer.lastPos = chicken.position;
+					newPlayer.lastRotation = chicken.rotation;
+					newPlayer.animWalk = en::Time::Zero;
+					newPlayer.animIndex = 0;
+					newPlayer.interpolation.Clear();
+					newPlayer.interpolated = false;
+					newPlayer.relevant = false;
+					newPlayer.sprite.setOrigin({ 32.0f, 32.0f });
+					mPlayers.push_back(newPlayer);
 				}
 				else
 				{
-					++i;
+					// Update player
+					Player& newPlayer = mPlayers[playerIndex];
+					newPlayer.clientID = clientID;
+					newPlayer.nickname = nickname;
+					newPlayer.chicken = chicken;
+					newPlayer.lastPos = chicken.position;
+					newPlayer.lastRotation = chicken.rotation;
+					newPlayer.animWalk = en::Time::Zero;
+					newPlayer.animIndex = 0;
+					newPlayer.interpolation.Clear();
+					newPlayer.interpolated = false;
+					newPlayer.sprite.setOrigin({ 32.0f, 32.0f });
 				}
 			}
 		} break;
-		case ServerPacketID::ShootBullet:
+		case ServerPacketID::Snapshot:
 		{
-			Bullet bullet;
-			packet >> bullet;
-			LogInfo(en::LogChannel::All, 4, "Bullet%s", "");
-			mBullets.push_back(bullet);
-			
-			// Play fire sound
-			if (IsInView(bullet.position))
-			{
-				en::SoundPtr sound = en::AudioSystem::GetInstance().PlaySound(GetItemSoundFireName(bullet.itemID));
-				if (sound.IsValid())
-				{
-					sound.SetVolume(0.25f);
-				}
-			}
-		} break;
-		case ServerPacketID::HitChicken:
-		{
-			// Computed on client side
-		} break;
-		case ServerPacketID::KillChicken:
-		{
-			en::U32 clientID;
-			en::U32 killerClientID;
-			packet >> clientID >> killerClientID;
-			LogInfo(en::LogChannel::All, 2, "Kill %d", clientID);
+			en::U32 sequence;
+			en::U32 baselineSequence;
+			packet >> sequence >> baselineSequence;
 
-			if (IsClient(clientID))
+			// Drop old or reordered snapshots, and the ones we can't decode anymore
+			const Snapshot* baseline = mSnapshots.GetBaseline(sequence, baselineSequence);
+			if (!packet || sequence <= mLastSnapshotSequence || baseline == nullptr)
 			{
-				// TODO : Die
+				break;
 			}
 
-		} break;
-		case ServerPacketID::RespawnChicken:
-		{
-			en::U32 clientID;
-			en::Vector2f position;
-			packet >> clientID >> position.x >> position.y;
-			LogInfo(en::LogChannel::All, 2, "Respawn %d", clientID, position.x, position.y);
-			const en::I32 playerIndex = GetPlayerIndexFromClientID(clientID);
-			if (playerIndex >= 0)
+			// Get the previous one before Push, it is replaced when the gap is a whole buffer
+			const bool resync = (mLastSnapshotSequence == 0 || sequence - mLastSnapshotSequence >= DefaultSnapshotBufferSize);
+			const Snapshot* previous = resync ? mSnapshots.Get(0) : mSnapshots.Get(mLastSnapshotSequence);
+			Snapshot& current = mSnapshots.Push(sequence);
+			en::BitReader reader(static_cast<const char*>(packet.getData()) + SnapshotHeaderSize, static_cast<en::U32>(packet.getDataSize() - SnapshotHeaderSize));
+			if (previous == nullptr || !ReadSnapshotDelta(reader, *baseline, current))
 			{
-				mPlayers[playerIndex].chicken.position = position;;
-				mPlayers[playerIndex].lastPos = position;
+				LogWarning(en::LogChannel::All, 6, "Invalid snapshot %d", sequence);
+				current.Clear();
+				break;
 			}
 
+			ApplySnapshot(*previous, current, resync);
+			mLastSnapshotSequence = sequence;
+			SendSnapshotAckPacket(sequence);
 		} break;
-		case ServerPacketID::ServerInfo:
-		{
-			packet >> mBestNickname >> mBestKills;
-		}
 
 		default:
 		{
@@ -392,6 +249,310 @@ en::I32 GameSingleton::GetPlayerIndexFromClientID(en::U32 clientID)
 	return -1;
 }
 
+bool GameSingleton::AddSeed(const Seed& seed)
+{
+	const auto itr = mSeedHandles.find(seed.seedUID);
+	if (itr != mSeedHandles.end() && mSeeds.Has(itr->second))
+	{
+		*mSeeds.Get(itr->second) = seed;
+		return false;
+	}
+	else
+	{
+		mSeedHandles[seed.seedUID] = mSeeds.Add(seed);
+		return true;
+	}
+}
+
+void GameSingleton::RemoveSeed(en::U32 seedUID)
+{
+	const auto itr = mSeedHandles.find(seedUID);
+	if (itr != mSeedHandles.end())
+	{
+		mSeeds.Remove(itr->second);
+		mSeedHandles.erase(itr);
+	}
+}
+
+void GameSingleton::AddItem(const Item& item)
+{
+	const auto itr = mItemHandles.find(item.itemUID);
+	if (itr != mItemHandles.end() && mItems.Has(itr->second))
+	{
+		*mItems.Get(itr->second) = item;
+	}
+	else
+	{
+		mItemHandles[item.itemUID] = mItems.Add(item);
+	}
+}
+
+void GameSingleton::RemoveItem(en::U32 itemUID)
+{
+	const auto itr = mItemHandles.find(itemUID);
+	if (itr != mItemHandles.end())
+	{
+		mItems.Remove(itr->second);
+		mItemHandles.erase(itr);
+	}
+}
+
+void GameSingleton::AddBullet(const Bullet& bullet)
+{
+	const auto itr = mBulletHandles.find(bullet.bulletUID);
+	if (itr != mBulletHandles.end() && mBullets.Has(itr->second))
+	{
+		*mBullets.Get(itr->second) = bullet;
+	}
+	else
+	{
+		mBulletHandles[bullet.bulletUID] = mBullets.Add(bullet);
+	}
+}
+
+// Bullets are also removed by the client simulation, then the UID isn't known anymore
+void GameSingleton::RemoveBullet(en::U32 bulletUID)
+{
+	const auto itr = mBulletHandles.find(bulletUID);
+	if (itr != mBulletHandles.end())
+	{
+		mBullets.Remove(itr->second);
+		mBulletHandles.erase(itr);
+	}
+}
+
+void GameSingleton::RemoveBulletAt(en::U32 index)
+{
+	mBulletHandles.erase(mBullets[index].bulletUID);
+	mBullets.RemoveAt(index);
+}
+
+void GameSingleton::ApplySnapshot(const Snapshot& previous, const Snapshot& current, bool resync)
+{
+	if (resync)
+	{
+		for (Player& player : mPlayers)
+		{
+			player.relevant = false;
+			player.interpolation.Clear();
+		}
+		mSeeds.Clear();
+		mSeedHandles.clear();
+		mItems.Clear();
+		mItemHandles.clear();
+		mBullets.Clear();
+		mBulletHandles.clear();
+	}
+
+	// Chickens : like the old UpdateChicken, the client side movement restarts from the server state when it changed
+	const auto getChickenID = [](const SnapshotChicken& chicken) { return chicken.clientID; };
+	const auto applyChicken = [](const SnapshotChicken& chicken)
+	{
+		const en::I32 playerIndex = GetPlayerIndexFromClientID(chicken.clientID);
+		if (playerIndex >= 0)
+		{
+			mPlayers[playerIndex].chicken = chicken.chicken;
+			mPlayers[playerIndex].relevant = true;
+			if (IsClient(chicken.clientID))
+			{
+				mPlayers[playerIndex].lastPos = chicken.chicken.position;
+				mPlayers[playerIndex].lastRotation = chicken.chicken.rotation;
+			}
+		}
+	};
+	ForEachSnapshotDifference(previous.chickens, current.chickens, getChickenID,
+		[](const SnapshotChicken& chicken)
+		{
+			// Left the view : hidden until it comes back, then it restarts from where it is
+			const en::I32 playerIndex = GetPlayerIndexFromClientID(chicken.clientID);
+			if (playerIndex >= 0)
+			{
+				mPlayers[playerIndex].relevant = false;
+				mPlayers[playerIndex].interpolation.Clear();
+			}
+		},
+		applyChicken,
+		[&](const SnapshotChicken& a, const SnapshotChicken& b) { if (!IsSameChicken(a.chicken, b.chicken)) applyChicken(b); });
+
+	// The other chickens get a sample per snapshot even when they didn't move, so a stop isn't extrapolated
+	// Far ones are timestamped with the snapshot their state comes from, Push ignores it while it is repeated
+	for (const SnapshotChicken& chicken : current.chickens)
+	{
+		const en::I32 playerIndex = GetPlayerIndexFromClientID(chicken.clientID);
+		if (playerIndex >= 0 && !IsClient(chicken.clientID))
+		{
+			const en::U32 sequence = chicken.far ? GetFarChickenSequence(current.sequence, chicken.clientID) : current.sequence;
+			mPlayers[playerIndex].interpolation.Push(GetSnapshotTime(sequence), chicken.chicken.position, chicken.chicken.rotation);
+		}
+	}
+
+	// Scores are sent for every player, also the ones outside of the view
+	for (const SnapshotScore& score : current.scores)
+	{
+		const en::I32 playerIndex = GetPlayerIndexFromClientID(score.clientID);
+		if (playerIndex >= 0)
+		{
+			mPlayers[playerIndex].chicken.kills = score.kills;
+		}
+	}
+
+	// Best killer, the first one with the most kills
+	mBestKills = 0;
+	mBestNickname.clear();
+	const en::U32 playerSize = static_cast<en::U32>(mPlayers.size());
+	for (en::U32 i = 0; i < playerSize; ++i)
+	{
+		if (mPlayers[i].chicken.kills > mBestKills)
+		{
+			mBestKills = mPlayers[i].chicken.kills;
+			mBestNickname = mPlayers[i].nickname;
+		}
+	}
+
+	ForEachSnapshotDifference(previous.seeds, current.seeds, [](const Seed& seed) { return seed.seedUID; },
+		[](const Seed& seed) { RemoveSeed(seed.seedUID); },
+		[&](const Seed& seed)
+		{
+			if (AddSeed(seed) && !resync && IsClient(seed.clientID))
+			{
+				en::SoundPtr sound = en::AudioSystem::GetInstance().PlaySound("seedsSound");
+				if (sound.IsValid())
+				{
+					sound.SetVolume(0.25f);
+				}
+			}
+		},
+		[](const Seed&, const Seed&) {});
+
+	ForEachSnapshotDifference(previous.items, current.items, [](const Item& item) { return item.itemUID; },
+		[](const Item& item) { RemoveItem(item.itemUID); },
+		[](const Item& item) { AddItem(item); },
+		[](const Item&, const Item&) {});
+
+	ForEachSnapshotDifference(previous.bullets, current.bullets, [](const Bullet& bullet) { return bullet.bulletUID; },
+		[](const Bullet& bullet) { RemoveBullet(bullet.bulletUID); },
+		[&](const Bullet& bullet)
+		{
+			AddBullet(bullet);
+
+			// Play fire sound
+			if (!resync && IsInView(bullet.position))
+			{
+				en::SoundPtr sound = en::AudioSystem::GetInstance().PlaySound(GetItemSoundFireName(bullet.itemID));
+				if (sound.IsValid())
+				{
+					sound.SetVolume(0.25f);
+				}
+			}
+		},
+		[](const Bullet&, const Bullet&) {});
+
+	// Events are sent until acknowledged, only apply the new ones
+	const en::U32 lastEventSequence = resync ? current.sequence - 1 : previous.sequence;
+	for (const SnapshotEvent& event : current.events)
+	{
+		if (event.sequence > lastEventSequence)
+		{
+			ApplySnapshotEvent(event);
+		}
+	}
+}
+
+void GameSingleton::ApplySnapshotEvent(const SnapshotEvent& event)
+{
+	switch (event.type)
+	{
+	case SnapshotEventType::KillChicken:
+	{
+		LogInfo(en::LogChannel::All, 2, "Kill %d", event.clientID);
+
+		if (IsClient(event.clientID))
+		{
+			// TODO : Die
+		}
+	} break;
+	case SnapshotEventType::EatSeed:
+	{
+		if (IsInView(event.position) && IsClient(event.clientID))
+		{
+			en::SoundPtr sound = en::AudioSystem::GetInstance().PlaySound("eat");
+			if (sound.IsValid())
+			{
+				sound.SetVolume(0.25f);
+			}
+		}
+	} break;
+	case SnapshotEventType::PickUpItem:
+	{
+		if (IsInView(event.position))
+		{
+			en::SoundPtr sound = en::AudioSystem::GetInstance().PlaySound(GetItemSoundLootName(event.itemID));
+			if (sound.IsValid())
+			{
+				if (event.itemID == ItemID::Laser || event.itemID == ItemID::Uzi)
+				{
+					sound.SetVolume(0.4f);
+				}
+				else
+				{
+					sound.SetVolume(0.25f);
+				}
+			}
+
+			// Play music
+			if (IsClient(event.clientID))
+			{
+				if (mMusic.IsValid())
+				{
+					mMusic.Stop();
+				}
+				mMusic = en::MusicPtr();
+				const char* name = GetItemMusicName(event.itemID);
+				if (name != nullptr && strlen(name) > 0)
+				{
+					mMusic = en::AudioSystem::GetInstance().PlayMusic(name);
+					if (mMusic.IsValid())
+					{
+						mMusic.SetLoop(true);
+						if (event.itemID == ItemID::Uzi)
+						{
+							mMusic.SetVolume(0.1f);
+						}
+						else
+						{
+							mMusic.SetVolume(0.2f);
+						}
+					}
+				}
+			}
+		}
+	} break;
+	default: break;
+	}
+}
+
+void GameSingleton::UpdateRenderTime(en::Time dt)
+{
+	if (mLastSnapshotSequence == 0)
+	{
+		return;
+	}
+
+	mRenderTime += dt;
+
+	// Small drifts are absorbed smoothly, a big one (first snapshot, long freeze) jumps
+	const en::Time targetTime = GetSnapshotTime(mLastSnapshotSequence) - mInterpolationDelay;
+	const en::F32 error = (targetTime - mRenderTime).asSeconds();
+	if (en::Math::Abs(error) > DefaultMaxExtrapolation.asSeconds())
+	{
+		mRenderTime = targetTime;
+	}
+	else
+	{
+		mRenderTime += en::seconds(error * en::Math::Min(dt.asSeconds() * 2.0f, 1.0f));
+	}
+}
+
 bool GameSingleton::IsInView(const en::Vector2f& position)
 {
 	return GameSingleton::mView.getBounds().contains(position);
@@ -399,14 +560,14 @@ bool GameSingleton::IsInView(const en::Vector2f& position)
 
 void GameSingleton::SendPingPacket()
 {
-	sf::Packet pingPacket;
+	PooledPacket pingPacket(mPacketPool);
 	pingPacket << static_cast<en::U8>(ClientPacketID::Ping);
 	mClient.SendPacket(pingPacket);
 }
 
 void GameSingleton::SendPongPacket()
 {
-	sf::Packet pongPacket;
+	PooledPacket pongPacket(mPacketPool);
 	pongPacket << static_cast<en::U8>(ClientPacketID::Pong);
 	mClient.SendPacket(pongPacket);
 }
@@ -415,7 +576,7 @@ void GameSingleton::SendJoinPacket()
 {
 	if (mClient.IsRunning() && !mClient.IsConnected())
 	{
-		sf::Packet joinPacket;
+		PooledPacket joinPacket(mPacketPool);
 		joinPacket << static_cast<en::U8>(ClientPacketID::Join);
 		joinPacket << GameSingleton::mInputNickname;
 		mClient.SendPacket(joinPacket);
@@ -426,7 +587,7 @@ void GameSingleton::SendLeavePacket()
 {
 	if (mClient.IsRunning() && mClient.IsConnected())
 	{
-		sf::Packet leavePacket;
+		PooledPacket leavePacket(mPacketPool);
 		leavePacket << static_cast<en::U8>(ClientPacketID::Leave);
 		leavePacket << mClient.GetClientID();
 		mClient.SetBlocking(true);
@@ -439,11 +600,22 @@ void GameSingleton::SendDropSeedPacket(const en::Vector2f& position)
 {
 	if (mClient.IsRunning() && mClient.IsConnected())
 	{
-		sf::Packet positionPacket;
+		PooledPacket positionPacket(mPacketPool);
 		positionPacket << static_cast<en::U8>(ClientPacketID::DropSeed);
 		positionPacket << mClient.GetClientID();
 		positionPacket << position.x;
 		positionPacket << position.y;
-		mClient.SendPacket(positionPacket);
+		mClient.SendReliablePacket(positionPacket, ReliableChannelID::Gameplay);
+	}
+}
+
+void GameSingleton::SendSnapshotAckPacket(en::U32 sequence)
+{
+	if (mClient.IsRunning() && mClient.IsConnected())
+	{
+		PooledPacket ackPacket(mPacketPool);
+		ackPacket << static_cast<en::U8>(ClientPacketID::SnapshotAck);
+		ackPacket << sequence;
+		mClient.SendPacket(ackPacket);
 	}
 }
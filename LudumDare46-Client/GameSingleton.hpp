@@ -2,11 +2,15 @@
 
 #include <Enlivengine/System/PrimitiveTypes.hpp>
 #include <Enlivengine/System/Config.hpp>
+#include <Enlivengine/System/SlotMap.hpp>
 
 #include <Enlivengine/Application/Application.hpp>
 #include <Enlivengine/Graphics/SFMLResources.hpp>
 
+#include <Snapshot.hpp>
+
 #include <entt/entt.hpp>
+#include <unordered_map>
 #include <vector>
 
 #include "ClientSocket.hpp"
@@ -20,14 +24,23 @@ public:
 
 	static en::Application* mApplication;
 	static ClientSocket mClient;
+	static PacketPool mPacketPool;
+	static sf::Packet mReceivedPacket;
 	static en::Time mLastPacketTime;
 	static GameMap mMap;
 	static en::View mView;
 	static std::vector<Player> mPlayers;
-	static std::vector<Seed> mSeeds;
-	static std::vector<Item> mItems;
-	static std::vector<Bullet> mBullets;
-	static std::vector<Blood> mBloods;
+	static en::SlotMap<Seed> mSeeds;
+	static en::SlotMap<Item> mItems;
+	static en::SlotMap<Bullet> mBullets;
+	static en::SlotMap<Blood> mBloods;
+	static std::unordered_map<en::U32, en::U32> mSeedHandles; // seedUID -> mSeeds handle
+	static std::unordered_map<en::U32, en::U32> mItemHandles; // itemUID -> mItems handle
+	static std::unordered_map<en::U32, en::U32> mBulletHandles; // bulletUID -> mBullets handle
+	static SnapshotBuffer mSnapshots;
+	static en::U32 mLastSnapshotSequence;
+	static en::Time mRenderTime; // Server time the remote chickens are shown at
+	static en::Time mInterpolationDelay; // How far behind the newest snapshot mRenderTime stays
 	static en::Application::onApplicationStoppedType::ConnectionGuard mApplicationStoppedSlot;
 	static sf::Sprite mCursor;
 	static PlayingState mPlayingState;
@@ -42,6 +55,21 @@ public:
 	static void HandleIncomingPackets();
 	static bool HasTimeout(en::Time dt);
 	static en::I32 GetPlayerIndexFromClientID(en::U32 clientID);
+	static bool AddSeed(const Seed& seed);
+	static void RemoveSeed(en::U32 seedUID);
+	static void AddItem(const Item& item);
+	static void RemoveItem(en::U32 itemUID);
+	static void AddBullet(const Bullet& bullet);
+	static void RemoveBullet(en::U32 bulletUID);
+	static void RemoveBulletAt(en::U32 index); // When the client simulation ends a bullet before the server does
+
+	// Update the game from the previous applied snapshot to current, resync when previous is unknown
+	static void ApplySnapshot(const Snapshot& previous, const Snapshot& current, bool resync);
+	static void ApplySnapshotEvent(const SnapshotEvent& event);
+	static en::Time GetSnapshotTime(en::U32 sequence) { return en::seconds(sequence * DefaultTickInterval.asSeconds()); }
+
+	// Advance mRenderTime with the frame, and steer it toward the newest snapshot minus mInterpolationDelay
+	static void UpdateRenderTime(en::Time dt);
 
 	static bool IsInView(const en::Vector2f& position);
 	static bool IsPlaying() { return mPlayingState == PlayingState::Playing; }
@@ -54,4 +82,5 @@ public:
 	static void SendJoinPacket();
 	static void SendLeavePacket();
 	static void SendDropSeedPacket(const en::Vector2f& position);
+	static void SendSnapshotAckPacket(en::U32 sequence);
 };
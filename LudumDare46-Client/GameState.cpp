@@ -1,6 +1,8 @@
 
 #include "GameState.hpp"
 
+#include <Enlivengine/Graphics/SpriteBatch.hpp>
+
 #include "ConnectingState.hpp"
 
 GameState::GameState(en::StateManager& manager)
@@ -53,14 +55,16 @@ bool GameState::update(en::Time dt)
 
 	// Network
 	GameSingleton::HandleIncomingPackets();
+	GameSingleton::mClient.SendReliablePackets(dt);
 	if (GameSingleton::HasTimeout(dt) || GameSingleton::IsConnecting())
 	{
 		clearStates();
 	}
+	GameSingleton::UpdateRenderTime(dt);
 
 	// Bullets
 	mShurikenRotation = en::Math::AngleMagnitude(mShurikenRotation + dtSeconds * DefaultShurikenRotDegSpeed);
-	en::U32 bulletSize = static_cast<en::U32>(GameSingleton::mBullets.size());
+	en::U32 bulletSize = GameSingleton::mBullets.Size();
 	for (en::U32 i = 0; i < bulletSize; )
 	{
 		bool remove = GameSingleton::mBullets[i].Update(dtSeconds);
@@ -71,7 +75,7 @@ bool GameState::update(en::Time dt)
 			const en::U32 size = static_cast<en::U32>(GameSingleton::mPlayers.size());
 			for (en::U32 j = 0; j < size && !remove; ++j)
 			{
-				if (GameSingleton::mBullets[i].clientID != GameSingleton::mPlayers[j].clientID && (GameSingleton::mPlayers[j].GetPosition() - GameSingleton::mBullets[i].position).getSquaredLength() < DefaultDetectionRadiusSqr)
+				if (GameSingleton::mPlayers[j].relevant && GameSingleton::mBullets[i].clientID != GameSingleton::mPlayers[j].clientID && (GameSingleton::mPlayers[j].GetPosition() - GameSingleton::mBullets[i].position).getSquaredLength() < DefaultDetectionRadiusSqr)
 				{
 					remove = true;
 					playerHitIndex = j;
@@ -89,7 +93,7 @@ bool GameState::update(en::Time dt)
 			blood.position.x += en::Random::get<en::F32>(-10.0f, +10.0f);
 			blood.position.y += en::Random::get<en::F32>(-10.0f, +10.0f);
 			blood.remainingTime = en::seconds(en::Random::get<en::F32>(2.0f, 4.0f));
-			GameSingleton::mBloods.push_back(blood);
+			GameSingleton::mBloods.Add(blood);
 
 			// Play fire sound
 			if (GameSingleton::IsInView(GameSingleton::mPlayers[playerHitIndex].GetPosition()))
@@ -139,7 +143,7 @@ bool GameState::update(en::Time dt)
 
 		if (remove)
 		{
-			GameSingleton::mBullets.erase(GameSingleton::mBullets.begin() + i);
+			GameSingleton::RemoveBulletAt(i);
 			bulletSize--;
 		}
 		else
@@ -149,13 +153,13 @@ bool GameState::update(en::Time dt)
 	}
 
 	// Bloods
-	en::U32 bloodSize = static_cast<en::U32>(GameSingleton::mBloods.size());
+	en::U32 bloodSize = GameSingleton::mBloods.Size();
 	for (en::U32 i = 0; i < bloodSize; )
 	{
 		GameSingleton::mBloods[i].remainingTime -= dt;
 		if (GameSingleton::mBloods[i].remainingTime < en::Time::Zero)
 		{
-			GameSingleton::mBloods.erase(GameSingleton::mBloods.begin() + i);
+			GameSingleton::mBloods.RemoveAt(i);
 			bloodSize--;
 		}
 		else
@@ -175,10 +179,24 @@ bool GameState::update(en::Time dt)
 		const en::U32 playerSize = static_cast<en::U32>(GameSingleton::mPlayers.size());
 		for (en::U32 i = 0; i < playerSize; ++i)
 		{
-			// Mvt client-side (~same as server)
+			if (!GameSingleton::mPlayers[i].relevant)
+			{
+				continue;
+			}
+
+			// Other chickens are shown where the snapshots had them, mRenderTime in the past
+			GameSingleton::mPlayers[i].interpolated = !GameSingleton::IsClient(GameSingleton::mPlayers[i].clientID) && !GameSingleton::mPlayers[i].interpolation.IsEmpty();
+			if (GameSingleton::mPlayers[i].interpolated)
+			{
+				const en::Vector2f previousPos = GameSingleton::mPlayers[i].lastPos;
+				GameSingleton::mPlayers[i].interpolation.Sample(GameSingleton::mRenderTime, GameSingleton::mPlayers[i].lastPos, GameSingleton::mPlayers[i].lastRotation);
+				GameSingleton::mPlayers[i].UpdateWalkAnimation(dt, (GameSingleton::mPlayers[i].lastPos - previousPos).getSquaredLength() > 0.1f);
+			}
+			else
 			{
+				// Mvt client-side (~same as server)
 				en::Vector2f deltaSeed;
-				en::I32 bestSeedIndex = Seed::GetBestSeedIndex(GameSingleton::mPlayers[i].clientID, GameSingleton::mPlayers[i].lastPos, GameSingleton::mSeeds, deltaSeed);
+				en::I32 bestSeedIndex = Seed::GetBestSeedIndex(GameSingleton::mPlayers[i].clientID, GameSingleton::mPlayers[i].lastPos, GameSingleton::mSeeds.GetValues(), deltaSeed);
 
 				// Rotate
 				if (bestSeedIndex >= 0)
@@ -213,34 +231,11 @@ bool GameState::update(en::Time dt)
 					const en::Vector2f mvt = en::Vector2f::polar(GameSingleton::mPlayers[i].lastRotation) * (dtSeconds * mvtSpeedFactor * GameSingleton::mPlayers[i].chicken.speed * GetItemWeight(GameSingleton::mPlayers[i].chicken.itemID));
 					GameSingleton::mPlayers[i].lastPos += mvt;
 
-					if (mvt.getSquaredLength() <= 0.1f) // Not moving
-					{
-						GameSingleton::mPlayers[i].animWalk = en::Time::Zero;
-						GameSingleton::mPlayers[i].animIndex = 0;
-					}
-					else
-					{
-						GameSingleton::mPlayers[i].animWalk += dt;
-						if (GameSingleton::mPlayers[i].animIndex == 0)
-						{
-							GameSingleton::mPlayers[i].animIndex = 1;
-						}
-						static const en::Time timePerAnim = en::seconds(0.1f);
-						if (GameSingleton::mPlayers[i].animWalk >= timePerAnim)
-						{
-							GameSingleton::mPlayers[i].animWalk -= timePerAnim;
-							GameSingleton::mPlayers[i].animIndex++;
-							if (GameSingleton::mPlayers[i].animIndex > DefaultAnimCount)
-							{
-								GameSingleton::mPlayers[i].animIndex = 1;
-							}
-						}
-					}
+					GameSingleton::mPlayers[i].UpdateWalkAnimation(dt, mvt.getSquaredLength() > 0.1f);
 				}
 				else
 				{
-					GameSingleton::mPlayers[i].animWalk = en::Time::Zero;
-					GameSingleton::mPlayers[i].animIndex = 0;
+					GameSingleton::mPlayers[i].UpdateWalkAnimation(dt, false);
 				}
 			}
 
@@ -327,6 +322,9 @@ void GameState::render(sf::RenderTarget& target)
 	// Maps
 	GameSingleton::mMap.render(target);
 
+	// Sprites of a layer are drawn with one draw call per texture
+	static en::SpriteBatch spriteBatch;
+
 	// Bloods
 	static bool bloodInitialized = false;
 	static sf::Sprite bloodSprite;
@@ -338,14 +336,15 @@ void GameState::render(sf::RenderTarget& target)
 		bloodSprite.setScale(1.5f, 1.5f);
 		bloodInitialized = true;
 	}
-	const en::U32 bloodSize = static_cast<en::U32>(GameSingleton::mBloods.size());
+	const en::U32 bloodSize = GameSingleton::mBloods.Size();
 	for (en::U32 i = 0; i < bloodSize; ++i)
 	{
 		const en::U32 bloodIndex = (GameSingleton::mBloods[i].bloodUID % DefaultBloodCount);
 		bloodSprite.setTextureRect(sf::IntRect(bloodIndex * 16, 0, 16, 16));
 		bloodSprite.setPosition(en::toSF(GameSingleton::mBloods[i].position));
-		target.draw(bloodSprite);
+		spriteBatch.Draw(bloodSprite);
 	}
+	spriteBatch.Flush(target);
 
 	// Items
 	static bool itemInitialized = false;
@@ -357,16 +356,17 @@ void GameState::render(sf::RenderTarget& target)
 		itemSprite.setScale(1.5f, 1.5f);
 		itemInitialized = true;
 	}
-	const en::U32 itemSize = static_cast<en::U32>(GameSingleton::mItems.size());
+	const en::U32 itemSize = GameSingleton::mItems.Size();
 	for (en::U32 i = 0; i < itemSize; ++i)
 	{
 		if (IsValidItemForAttack(GameSingleton::mItems[i].itemID))
 		{
 			itemSprite.setTextureRect(GetItemLootTextureRect(GameSingleton::mItems[i].itemID));
 			itemSprite.setPosition(en::toSF(GameSingleton::mItems[i].position));
-			target.draw(itemSprite);
+			spriteBatch.Draw(itemSprite);
 		}
 	}
+	spriteBatch.Flush(target);
 
 	// Seeds
 	static bool seedInitialized = false;
@@ -378,15 +378,16 @@ void GameState::render(sf::RenderTarget& target)
 		seedSprite.setScale(3.0f, 3.0f);
 		seedInitialized = true;
 	}
-	const en::U32 seedSize = static_cast<en::U32>(GameSingleton::mSeeds.size());
+	const en::U32 seedSize = GameSingleton::mSeeds.Size();
 	for (en::U32 i = 0; i < seedSize; ++i)
 	{
 		if (GameSingleton::IsClient(GameSingleton::mSeeds[i].clientID))
 		{
 			seedSprite.setPosition(en::toSF(GameSingleton::mSeeds[i].position));
-			target.draw(seedSprite);
+			spriteBatch.Draw(seedSprite);
 		}
 	}
+	spriteBatch.Flush(target);
 
 	// Radar
 	static bool radarInitialized = false;
@@ -407,7 +408,7 @@ void GameState::render(sf::RenderTarget& target)
 		const en::U32 playerSize = static_cast<en::U32>(GameSingleton::mPlayers.size());
 		for (en::U32 i = 0; i < playerSize; ++i)
 		{
-			if (i != static_cast<en::U32>(playerIndex))
+			if (i != static_cast<en::U32>(playerIndex) && GameSingleton::mPlayers[i].relevant)
 			{
 				const en::Vector2f& otherPos = GameSingleton::mPlayers[i].GetPosition();
 				const en::Vector2f delta = (otherPos - position);
@@ -438,7 +439,7 @@ void GameState::render(sf::RenderTarget& target)
 		bulletSprite.setOrigin(8.0f, 8.0f);
 		bulletInitialized = true;
 	}
-	const en::U32 bulletSize = static_cast<en::U32>(GameSingleton::mBullets.size());
+	const en::U32 bulletSize = GameSingleton::mBullets.Size();
 	for (en::U32 i = 0; i < bulletSize; ++i)
 	{
 		bulletSprite.setTextureRect(GetItemBulletTextureRect(GameSingleton::mBullets[i].itemID));
@@ -463,8 +464,9 @@ void GameState::render(sf::RenderTarget& target)
 			bulletSprite.setScale(1.0f, 1.0f);
 		}
 		
-		target.draw(bulletSprite);
+		spriteBatch.Draw(bulletSprite);
 	}
+	spriteBatch.Flush(target);
 
 	// Players
 	static bool chickenBodyInitialized = false;
@@ -478,6 +480,11 @@ void GameState::render(sf::RenderTarget& target)
 	const en::U32 playerSize = static_cast<en::U32>(GameSingleton::mPlayers.size());
 	for (en::U32 i = 0; i < playerSize; ++i)
 	{
+		if (!GameSingleton::mPlayers[i].relevant)
+		{
+			continue;
+		}
+
 		en::Color color = en::Color::White;
 		if (GameSingleton::mPlayers[i].chicken.lifeMax >= 0.0f)
 		{
@@ -488,9 +495,19 @@ void GameState::render(sf::RenderTarget& target)
 		}
 		//chickenBodySprite.setColor(en::toSF(color));
 		chickenBodySprite.setPosition(en::toSF(GameSingleton::mPlayers[i].GetPosition()));
-		target.draw(chickenBodySprite);
+		spriteBatch.Draw(chickenBodySprite);
 		GameSingleton::mPlayers[i].UpdateSprite();
-		target.draw(GameSingleton::mPlayers[i].sprite);
+		spriteBatch.Draw(GameSingleton::mPlayers[i].sprite);
+	}
+	spriteBatch.Flush(target);
+
+	// Nicknames above every chicken
+	for (en::U32 i = 0; i < playerSize; ++i)
+	{
+		if (!GameSingleton::mPlayers[i].relevant)
+		{
+			continue;
+		}
 
 		textNickname.setString(GameSingleton::mPlayers[i].nickname);
 		textNickname.setOrigin(textNickname.getGlobalBounds().width * 0.5f, textNickname.getGlobalBounds().height * 0.5f);
@@ -0,0 +1,107 @@
+#include "InterpolationBuffer.hpp"
+
+#include <Enlivengine/Math/Utilities.hpp>
+
+namespace
+{
+
+// Shortest way from a to b, in degrees
+en::F32 LerpAngle(en::F32 a, en::F32 b, en::F32 t)
+{
+	en::F32 delta = en::Math::AngleMagnitude(b - a);
+	if (delta > 180.0f)
+	{
+		delta -= 360.0f;
+	}
+	return en::Math::AngleMagnitude(a + delta * t);
+}
+
+} // namespace
+
+InterpolationBuffer::InterpolationBuffer()
+	: mNewest(0)
+	, mCount(0)
+{
+}
+
+void InterpolationBuffer::Clear()
+{
+	mNewest = 0;
+	mCount = 0;
+}
+
+void InterpolationBuffer::Push(en::Time time, const en::Vector2f& position, en::F32 rotation)
+{
+	if (mCount > 0)
+	{
+		const Entry& newest = GetEntry(0);
+		if (time <= newest.time)
+		{
+			return;
+		}
+		// Respawn : don't slide across the map
+		if ((position - newest.position).getSquaredLength() > DefaultInterpolationSnapDistanceSqr)
+		{
+			Clear();
+		}
+	}
+
+	mNewest = (mCount > 0) ? (mNewest + 1) % DefaultInterpolationBufferSize : 0;
+	mCount = en::Math::Min(mCount + 1, static_cast<en::U32>(DefaultInterpolationBufferSize));
+	Entry& entry = mEntries[mNewest];
+	entry.time = time;
+	entry.position = position;
+	entry.rotation = rotation;
+}
+
+bool InterpolationBuffer::Sample(en::Time time, en::Vector2f& position, en::F32& rotation) const
+{
+	if (mCount == 0)
+	{
+		return false;
+	}
+
+	const Entry& newest = GetEntry(0);
+	if (time >= newest.time)
+	{
+		// Late : dead reckoning from the last two entries
+		position = newest.position;
+		rotation = newest.rotation;
+		if (mCount >= 2)
+		{
+			const Entry& previous = GetEntry(1);
+			const en::F32 interval = (newest.time - previous.time).asSeconds();
+			const en::Time ahead = time - newest.time;
+			const en::F32 aheadSeconds = ((ahead < DefaultMaxExtrapolation) ? ahead : DefaultMaxExtrapolation).asSeconds();
+			if (interval > 0.0f)
+			{
+				position += (newest.position - previous.position) * (aheadSeconds / interval);
+			}
+		}
+		return true;
+	}
+
+	for (en::U32 k = 1; k < mCount; ++k)
+	{
+		const Entry& older = GetEntry(k);
+		if (older.time <= time)
+		{
+			const Entry& newer = GetEntry(k - 1);
+			const en::F32 t = (time - older.time).asSeconds() / (newer.time - older.time).asSeconds();
+			position = older.position + (newer.position - older.position) * t;
+			rotation = LerpAngle(older.rotation, newer.rotation, t);
+			return true;
+		}
+	}
+
+	// Older than everything received, wait on the oldest
+	const Entry& oldest = GetEntry(mCount - 1);
+	position = oldest.position;
+	rotation = oldest.rotation;
+	return true;
+}
+
+en::Time InterpolationBuffer::GetNewestTime() const
+{
+	return (mCount > 0) ? GetEntry(0).time : en::Time::Zero;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <Enlivengine/System/PrimitiveTypes.hpp>
+#include <Enlivengine/System/Time.hpp>
+#include <Enlivengine/Math/Vector2.hpp>
+
+#include <Common.hpp>
+
+// Last positions received for a remote chicken, timestamped with the server time of their snapshot
+// Sampled a bit in the past, so there is almost always a received position on each side to interpolate between
+// When the next one is late, the last known velocity is extrapolated for at most DefaultMaxExtrapolation
+class InterpolationBuffer
+{
+public:
+	InterpolationBuffer();
+
+	void Clear();
+
+	// Older or same time samples are ignored, a jump farther than DefaultInterpolationSnapDistance restarts the buffer
+	void Push(en::Time time, const en::Vector2f& position, en::F32 rotation);
+
+	// False while empty
+	bool Sample(en::Time time, en::Vector2f& position, en::F32& rotation) const;
+
+	bool IsEmpty() const { return mCount == 0; }
+	en::Time GetNewestTime() const;
+
+private:
+	struct Entry
+	{
+		en::Time time;
+		en::Vector2f position;
+		en::F32 rotation;
+	};
+
+	// k = 0 is the newest entry
+	const Entry& GetEntry(en::U32 k) const { return mEntries[(mNewest + DefaultInterpolationBufferSize - k) % DefaultInterpolationBufferSize]; }
+
+private:
+	Entry mEntries[DefaultInterpolationBufferSize];
+	en::U32 mNewest;
+	en::U32 mCount;
+};
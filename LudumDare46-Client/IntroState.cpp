@@ -1,20 +1,66 @@
 #include "IntroState.hpp"
 
+#include <Enlivengine/Application/ResourceManager.hpp>
+#include <Enlivengine/Graphics/SFMLResources.hpp>
+
+#include "MenuState.hpp"
+#include "GameSingleton.hpp"
+
+namespace
+{
+	const sf::Vector2f ProgressBarSize(400.0f, 16.0f);
+	const sf::Vector2f ProgressBarPosition(312.0f, 376.0f);
+}
+
 IntroState::IntroState(en::StateManager& manager)
 	: en::State(manager)
+	, mProgressBackground(ProgressBarSize)
+	, mProgressBar(sf::Vector2f(0.0f, ProgressBarSize.y))
 {
+	mProgressBackground.setPosition(ProgressBarPosition);
+	mProgressBackground.setFillColor(sf::Color(40, 40, 40));
+	mProgressBackground.setOutlineColor(sf::Color(200, 200, 200));
+	mProgressBackground.setOutlineThickness(2.0f);
+	mProgressBar.setPosition(ProgressBarPosition);
+	mProgressBar.setFillColor(sf::Color(200, 200, 200));
 }
 
 bool IntroState::handleEvent(const sf::Event& event)
 {
+	ENLIVE_UNUSED(event);
 	return false;
 }
 
 bool IntroState::update(en::Time dt)
 {
+	ENLIVE_PROFILE_FUNCTION();
+	ENLIVE_UNUSED(dt);
+
+	en::ResourceManager& resourceManager = en::ResourceManager::GetInstance();
+	mProgressBar.setSize(sf::Vector2f(ProgressBarSize.x * resourceManager.GetLoadingProgress(), ProgressBarSize.y));
+
+	if (!resourceManager.IsLoading())
+	{
+		GameSingleton::mMap.load();
+
+		clearStates();
+		pushState<MenuState>();
+	}
 	return false;
 }
 
 void IntroState::render(sf::RenderTarget& target)
 {
+	ENLIVE_PROFILE_FUNCTION();
+
+	target.draw(mProgressBackground);
+	target.draw(mProgressBar);
+
+	// The cursor is one of the first textures loaded
+	if (en::ResourceManager::GetInstance().Get<en::Texture>("cursor").IsLoaded())
+	{
+		GameSingleton::mCursor.setPosition(en::toSF(GameSingleton::mApplication->GetWindow().getCursorPosition()));
+		GameSingleton::mCursor.setTextureRect(sf::IntRect(0, 0, 32, 32));
+		target.draw(GameSingleton::mCursor);
+	}
 }
@@ -1,16 +1,10 @@
 #pragma once
 
 #include <Enlivengine/Application/StateManager.hpp>
-#include <Enlivengine/Math/Vector2.hpp>
-#include <Enlivengine/Graphics/View.hpp>
-#include <Enlivengine/Application/AudioSystem.hpp>
 
-#include <SFML/Graphics/Text.hpp>
-
-#include <Common.hpp>
-
-#include "Player.hpp"
+#include <SFML/Graphics/RectangleShape.hpp>
 
+// Shown while the resources are loaded, then replaced by the MenuState
 class IntroState : public en::State
 {
 public:
@@ -21,4 +15,9 @@ public:
 	bool update(en::Time dt);
 
 	void render(sf::RenderTarget& target);
+
+private:
+	// Doesn't use any resource, they are the ones being loaded
+	sf::RectangleShape mProgressBackground;
+	sf::RectangleShape mProgressBar;
 };
\ No newline at end of file
@@ -10,6 +10,8 @@
 #include <Common.hpp>
 #include <string>
 
+#include "InterpolationBuffer.hpp"
+
 struct Player
 {
 	en::U32 clientID;
@@ -22,17 +24,58 @@ struct Player
 	en::Time animWalk;
 	en::U32 animIndex;
 
+	// Remote chickens : lastPos and lastRotation are sampled from the received snapshots instead of simulated
+	InterpolationBuffer interpolation;
+	bool interpolated;
+
+	// In the last snapshot : the chickens far from ours aren't sent, they are not updated nor shown
+	bool relevant;
+
 	inline en::Vector2f GetPosition() const
 	{
+		if (interpolated)
+		{
+			return lastPos;
+		}
 		return en::Vector2f::lerp(lastPos, chicken.position, 0.1f);
 	}
 
 	inline en::F32 GetRotation() const
 	{
+		if (interpolated)
+		{
+			return lastRotation;
+		}
 		const en::F32 deltaAngle = en::Math::AngleBetween(lastRotation, chicken.rotation);
 		return en::Math::AngleMagnitude(lastRotation + deltaAngle * 0.1f);
 	}
 
+	void UpdateWalkAnimation(en::Time dt, bool moving)
+	{
+		if (!moving)
+		{
+			animWalk = en::Time::Zero;
+			animIndex = 0;
+			return;
+		}
+
+		animWalk += dt;
+		if (animIndex == 0)
+		{
+			animIndex = 1;
+		}
+		static const en::Time timePerAnim = en::seconds(0.1f);
+		if (animWalk >= timePerAnim)
+		{
+			animWalk -= timePerAnim;
+			animIndex++;
+			if (animIndex > DefaultAnimCount)
+			{
+				animIndex = 1;
+			}
+		}
+	}
+
 	void UpdateSprite()
 	{
 		sprite.setTexture(en::ResourceManager::GetInstance().Get<en::Texture>(GetItemTextureName(chicken.itemID)).Get());
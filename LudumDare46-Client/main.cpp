@@ -3,7 +3,7 @@
 #include <Enlivengine/Application/Window.hpp>
 #include <Enlivengine/Graphics/View.hpp>
 
-#include "MenuState.hpp"
+#include "IntroState.hpp"
 #include "GameSingleton.hpp"
 
 int main(int argc, char** argv)
@@ -35,9 +35,8 @@ int main(int argc, char** argv)
 	en::AudioSystem::GetInstance().SetMusicVolume(0.1f);
 
 	GameSingleton::mIntroDone = false;
-	GameSingleton::mMap.load();
 
-	app.Start<MenuState>();
+	app.Start<IntroState>();
 
 	return 0;
 }
\ No newline at end of file
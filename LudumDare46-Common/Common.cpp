@@ -1,4 +1,5 @@
 #include "Common.hpp"
+#include "PacketPool.hpp"
 
 #include <Enlivengine/Math/Random.hpp>
 
@@ -17,6 +18,57 @@ const char* GetRejectReasonString(RejectReason rejectReason)
 	return "<Unknown>";
 }
 
+void WritePosition(en::BitWriter& writer, const en::Vector2f& position)
+{
+	writer.WriteFloat(position.x, en::BitQuantization(DefaultPositionXQuantization));
+	writer.WriteFloat(position.y, en::BitQuantization(DefaultPositionYQuantization));
+}
+
+en::Vector2f ReadPosition(en::BitReader& reader)
+{
+	const en::F32 x = reader.ReadFloat(en::BitQuantization(DefaultPositionXQuantization));
+	const en::F32 y = reader.ReadFloat(en::BitQuantization(DefaultPositionYQuantization));
+	return { x, y };
+}
+
+void WriteRotation(en::BitWriter& writer, en::F32 rotation)
+{
+	writer.WriteFloat(en::Math::AngleMagnitude(rotation), en::BitQuantization(DefaultRotationQuantization));
+}
+
+// Values close to 360 are rounded to the max of the range, wrapped back to 0
+en::F32 ReadRotation(en::BitReader& reader)
+{
+	return en::Math::AngleMagnitude(reader.ReadFloat(en::BitQuantization(DefaultRotationQuantization)));
+}
+
+void WriteItemID(en::BitWriter& writer, en::U32 itemID)
+{
+	writer.WriteBits(itemID, DefaultItemIDBits);
+}
+
+// Out of range IDs would index the item tables, they invalidate the reader like a truncated read
+en::U32 ReadItemID(en::BitReader& reader)
+{
+	const en::U32 itemID = reader.ReadBits(DefaultItemIDBits);
+	if (itemID >= static_cast<en::U32>(ItemID::Count))
+	{
+		reader.Invalidate();
+		return static_cast<en::U32>(ItemID::None);
+	}
+	return itemID;
+}
+
+static ItemID ToItemID(en::U32 itemIDRaw)
+{
+	return (itemIDRaw < static_cast<en::U32>(ItemID::Count)) ? static_cast<ItemID>(itemIDRaw) : ItemID::None;
+}
+
+en::U64 GetEndpointKey(const sf::IpAddress& remoteAddress, en::U16 remotePort)
+{
+	return (static_cast<en::U64>(remoteAddress.toInteger()) << 16) | static_cast<en::U64>(remotePort);
+}
+
 const char* GetItemName(ItemID itemID)
 {
 	switch (itemID)
@@ -97,9 +149,9 @@ en::F32 GetItemAttack(ItemID itemID)
 	return 0.0f;
 }
 
-ItemID GetRandomAttackItem()
+ItemID GetRandomAttackItem(en::RandomEngine& random)
 {
-	return static_cast<ItemID>(en::Random::get<en::U32>(static_cast<en::U32>(ItemID::None) + 1, static_cast<en::U32>(ItemID::Count) - 1));
+	return static_cast<ItemID>(random.get<en::U32>(static_cast<en::U32>(ItemID::None) + 1, static_cast<en::U32>(ItemID::Count) - 1));
 }
 
 const char* GetItemTextureName(ItemID itemID)
@@ -207,7 +259,8 @@ sf::IntRect GetItemBulletTextureRect(ItemID itemID)
 	return sf::IntRect(0, 0, 0, 0);
 }
 
-sf::Packet& operator<<(sf::Packet& packet, const Chicken& chicken)
+template <typename Packet>
+static Packet& WriteChicken(Packet& packet, const Chicken& chicken)
 {
 	packet << chicken.position.x;
 	packet << chicken.position.y;
@@ -221,6 +274,16 @@ sf::Packet& operator<<(sf::Packet& packet, const Chicken& chicken)
 	return packet;
 }
 
+sf::Packet& operator<<(sf::Packet& packet, const Chicken& chicken)
+{
+	return WriteChicken(packet, chicken);
+}
+
+PooledPacket& operator<<(PooledPacket& packet, const Chicken& chicken)
+{
+	return WriteChicken(packet, chicken);
+}
+
 sf::Packet& operator>>(sf::Packet& packet, Chicken& chicken)
 {
 	en::U32 itemIDRaw;
@@ -228,15 +291,41 @@ sf::Packet& operator>>(sf::Packet& packet, Chicken& chicken)
 	packet >> chicken.position.y;
 	packet >> chicken.rotation;
 	packet >> itemIDRaw;
-	packet << chicken.kills;
+	packet >> chicken.kills;
 	packet >> chicken.lifeMax;
 	packet >> chicken.life;
 	packet >> chicken.speed;
 	packet >> chicken.attack;
-	chicken.itemID = static_cast<ItemID>(itemIDRaw);
+	chicken.itemID = ToItemID(itemIDRaw);
 	return packet;
 }
 
+en::BitWriter& operator<<(en::BitWriter& writer, const Chicken& chicken)
+{
+	WritePosition(writer, chicken.position);
+	WriteRotation(writer, chicken.rotation);
+	WriteItemID(writer, static_cast<en::U32>(chicken.itemID));
+	writer.WriteVarU32(chicken.kills);
+	writer.WriteFloat(chicken.lifeMax, en::BitQuantization(DefaultLifeQuantization));
+	writer.WriteFloat(chicken.life, en::BitQuantization(DefaultLifeQuantization));
+	writer.WriteFloat(chicken.speed, en::BitQuantization(DefaultStatQuantization));
+	writer.WriteFloat(chicken.attack, en::BitQuantization(DefaultStatQuantization));
+	return writer;
+}
+
+en::BitReader& operator>>(en::BitReader& reader, Chicken& chicken)
+{
+	chicken.position = ReadPosition(reader);
+	chicken.rotation = ReadRotation(reader);
+	chicken.itemID = static_cast<ItemID>(ReadItemID(reader));
+	chicken.kills = reader.ReadVarU32();
+	chicken.lifeMax = reader.ReadFloat(en::BitQuantization(DefaultLifeQuantization));
+	chicken.life = reader.ReadFloat(en::BitQuantization(DefaultLifeQuantization));
+	chicken.speed = reader.ReadFloat(en::BitQuantization(DefaultStatQuantization));
+	chicken.attack = reader.ReadFloat(en::BitQuantization(DefaultStatQuantization));
+	return reader;
+}
+
 sf::Packet& operator<<(sf::Packet& packet, const Seed& seed)
 {
 	packet << seed.seedUID;
@@ -259,6 +348,24 @@ sf::Packet& operator>>(sf::Packet& packet, Seed& seed)
 	return packet;
 }
 
+en::BitWriter& operator<<(en::BitWriter& writer, const Seed& seed)
+{
+	writer.WriteVarU32(seed.seedUID);
+	WritePosition(writer, seed.position);
+	writer.WriteBits(seed.clientID, 32);
+	writer.WriteFloat(seed.remainingTime.asSeconds(), en::BitQuantization(DefaultSeedTimeQuantization));
+	return writer;
+}
+
+en::BitReader& operator>>(en::BitReader& reader, Seed& seed)
+{
+	seed.seedUID = reader.ReadVarU32();
+	seed.position = ReadPosition(reader);
+	seed.clientID = reader.ReadBits(32);
+	seed.remainingTime = en::seconds(reader.ReadFloat(en::BitQuantization(DefaultSeedTimeQuantization)));
+	return reader;
+}
+
 sf::Packet& operator<<(sf::Packet& packet, const Item& item)
 {
 	packet << item.itemUID;
@@ -275,10 +382,26 @@ sf::Packet& operator>>(sf::Packet& packet, Item& item)
 	packet >> itemIDRaw;
 	packet >> item.position.x;
 	packet >> item.position.y;
-	item.itemID = static_cast<ItemID>(itemIDRaw);
+	item.itemID = ToItemID(itemIDRaw);
 	return packet;
 }
 
+en::BitWriter& operator<<(en::BitWriter& writer, const Item& item)
+{
+	writer.WriteVarU32(item.itemUID);
+	WriteItemID(writer, static_cast<en::U32>(item.itemID));
+	WritePosition(writer, item.position);
+	return writer;
+}
+
+en::BitReader& operator>>(en::BitReader& reader, Item& item)
+{
+	item.itemUID = reader.ReadVarU32();
+	item.itemID = static_cast<ItemID>(ReadItemID(reader));
+	item.position = ReadPosition(reader);
+	return reader;
+}
+
 sf::Packet& operator<<(sf::Packet& packet, const Bullet& bullet)
 {
 	packet << bullet.bulletUID;
@@ -301,10 +424,32 @@ sf::Packet& operator>>(sf::Packet& packet, Bullet& bullet)
 	packet >> bullet.clientID;
 	packet >> itemIDRaw;
 	packet >> bullet.remainingDistance;
-	bullet.itemID = static_cast<ItemID>(itemIDRaw);
+	bullet.itemID = ToItemID(itemIDRaw);
 	return packet;
 }
 
+en::BitWriter& operator<<(en::BitWriter& writer, const Bullet& bullet)
+{
+	writer.WriteVarU32(bullet.bulletUID);
+	WritePosition(writer, bullet.position);
+	WriteRotation(writer, bullet.rotation);
+	writer.WriteBits(bullet.clientID, 32);
+	WriteItemID(writer, static_cast<en::U32>(bullet.itemID));
+	writer.WriteFloat(bullet.remainingDistance, en::BitQuantization(DefaultBulletDistanceQuantization));
+	return writer;
+}
+
+en::BitReader& operator>>(en::BitReader& reader, Bullet& bullet)
+{
+	bullet.bulletUID = reader.ReadVarU32();
+	bullet.position = ReadPosition(reader);
+	bullet.rotation = ReadRotation(reader);
+	bullet.clientID = reader.ReadBits(32);
+	bullet.itemID = static_cast<ItemID>(ReadItemID(reader));
+	bullet.remainingDistance = reader.ReadFloat(en::BitQuantization(DefaultBulletDistanceQuantization));
+	return reader;
+}
+
 sf::Packet& operator<<(sf::Packet& packet, const Blood& blood)
 {
 	packet << blood.bloodUID;
@@ -1,23 +1,73 @@
 #pragma once
 
 #include <Enlivengine/System/PrimitiveTypes.hpp>
+#include <Enlivengine/System/BitStream.hpp>
 #include <Enlivengine/System/Time.hpp>
 #include <Enlivengine/Math/Vector2.hpp>
+#include <SFML/Network/IpAddress.hpp>
 #include <SFML/Network/Packet.hpp>
 #include <SFML/Graphics/Rect.hpp>
 #include <vector>
 
+class PooledPacket;
+namespace en
+{
+class RandomEngine;
+} // namespace en
+
 // Network
 #define DefaultServerAddress "92.222.79.62"
 #define DefaultServerPort 3457
+#define DefaultMaxDatagramSize 1200 // Below the usual MTU, so datagrams are not fragmented
+#define DefaultPacketPoolSize 4 // Outgoing messages being written at the same time
+#define DefaultNetworkQueueSize 256 // Datagrams waiting in each direction between the network thread and the simulation
+#define DefaultPacketBatchReservedSize (3 * DefaultMaxDatagramSize) // Outgoing bytes of an endpoint queued without growing its batch
+#define DefaultNetworkBatchSize 64 // Datagrams moved by one system call, when the platform can
+#define DefaultNetworkWaitTime sf::milliseconds(1) // Network thread wait for incoming datagrams, bounds the send latency
+#define DefaultReliableWindowSize 32 // Reliable messages in flight per channel, what the ack bitfield covers
+#define DefaultReliableQueueSize 256 // Reliable messages waiting for their ack per channel, in flight included
+#define DefaultReliableMinResendDelay en::milliseconds(100) // Before a reliable message is sent again, longer with a slow round trip
+#define DefaultPlayerListMessageSize 1024 // Bytes of a PlayerList message at most, so each one fits in a Reliable datagram with its acks
+
+// Quantization of the compact encodings : min, max, bits
+#define DefaultPositionXQuantization -(DefaultMapBorder), DefaultMapSizeX + DefaultMapBorder, 16
+#define DefaultPositionYQuantization -(DefaultMapBorder), DefaultMapSizeY + DefaultMapBorder, 16
+#define DefaultRotationQuantization 0.0f, 360.0f, 12
+#define DefaultLifeQuantization 0.0f, 256.0f, 12
+#define DefaultStatQuantization 0.0f, 512.0f, 12 // Speed and attack
+#define DefaultSeedTimeQuantization 0.0f, 4.0f, 8
+#define DefaultBulletDistanceQuantization 0.0f, 1024.0f, 12
+#define DefaultItemIDBits 3
 
 // Server
 #define DefaultClientTimeout en::seconds(10.0f)
 #define DefaultServerTimeout en::seconds(10.0f)
 #define DefaultStepInterval en::seconds(1.0f / 60.0f)
 #define DefaultTickInterval en::seconds(1.0f / 20.0f)
+#define DefaultBulletInterval DefaultStepInterval
+#define DefaultLootInterval en::seconds(1.0f / 20.0f) // Item spawn and pick up, slower would let chickens run over items
+#define DefaultMaxCatchUpSteps 4 // Steps run at most per loop, the late ones are dropped after a hitch
+#define DefaultMaxCatchUpTicks 2
 #define DefaultSleepTime sf::seconds(1.0f / 5.0f)
-#define DefaultMaxPlayers 16
+#define DefaultMaxPlayers 16 // Per room
+#define DefaultRoomCount 1 // Worlds hosted by one server process
+#define DefaultMetricsInterval en::seconds(10.0f) // Between two writes of the metrics file
+#define DefaultMetricsScrapeTimeout en::seconds(2.0f) // A scraper of the metrics endpoint is dropped after that
+#define DefaultMetricsMaxRequestSize 4096
+#define DefaultReplayChunkSize 64 * 1024 // Records compressed and written together by a ReplayRecorder
+#define DefaultReplayFlushSteps 600 // A chunk is written at least that often, what a killed server loses
+#define DefaultSnapshotBufferSize 32
+#define DefaultRelevanceRadius (2.0f * DefaultCameraMaxDistance) // Sent at full rate : the camera is at most that far from the chicken, and shows about as much around it
+#define DefaultRelevanceRadiusSqr (DefaultRelevanceRadius * DefaultRelevanceRadius)
+#define DefaultRelevanceFarRadius (4.0f * DefaultCameraMaxDistance) // Chickens are still sent up to there, at a reduced rate
+#define DefaultRelevanceFarRadiusSqr (DefaultRelevanceFarRadius * DefaultRelevanceFarRadius)
+#define DefaultRelevanceFarInterval 4 // Snapshots between two updates of a far chicken
+#define DefaultLagCompensationMaxRewind en::milliseconds(250) // Oldest past a hit is tested in, bounds the position history
+#define DefaultInterpolationDelay en::milliseconds(100) // Clients show the other chickens this far in the past
+#define DefaultInterpolationBufferSize 8 // Snapshots kept per remote chicken on the clients
+#define DefaultMaxExtrapolation en::milliseconds(250) // Clients stop moving a chicken whose snapshots are this late
+#define DefaultInterpolationSnapDistance 200.0f // Farther in one snapshot is a respawn, not a move
+#define DefaultInterpolationSnapDistanceSqr 200.0f * 200.0f
 
 // Movement
 #define DefaultSeedInterval en::seconds(0.3f)
@@ -50,19 +100,22 @@
 #define DefaultItemRange 400.0f
 #define DefaultDetectionRadius 35.0f
 #define DefaultDetectionRadiusSqr 35.0f * 35.0f
+#define DefaultMaxBulletsPerPlayer 8 // Longest flight (range / projectile speed) over the shortest cooldown, rounded up
 
 // MapData
 #define DefaultMaxItemAmount 30
-#define DefaultSpawnItemInterval en::seconds(5.0f)
+#define DefaultSpawnItemInterval en::seconds(15.0f) // Simulated time, items used to spawn every 5s counted on a third of the steps only
 #define DefaultMapSizeX 64.0f * 64.0f
 #define DefaultMapSizeY 64.0f * 48.0f
 #define DefaultMapBorder 64.0f * 10.0f
+#define DefaultSpatialGridCellSize 200.0f
+#define DefaultSpatialGridCellCapacity 32 // Reserved per cell, so usual densities never allocate
 
 // Visuals
 #define DefaultBloodCount 3
 #define DefaultAnimCount 4
 #define DefaultShurikenRotDegSpeed 1440.0f
-#define DefaultServerMapPath "Assets/Maps/map.tmx"
+#define DefaultServerMapPath "Assets/Maps/map.enmap"
 
 
 // Server -> Client
@@ -77,18 +130,10 @@ enum class ServerPacketID : en::U8
 	Stopping,
 
 	// Game specific packets
-	ServerInfo,
-	PlayerInfo,
-	ItemInfo,
-	UpdateChicken,
-	AddSeed,
-	RemoveSeed,
-	AddItem,
-	RemoveItem,
-	ShootBullet,
-	HitChicken,
-	KillChicken,
-	RespawnChicken,
+	PlayerList, // Players already in the game for a joining client : clientID, nickname and chicken until the end of the message
+	Snapshot, // Delta against the last snapshot acknowledged by the client
+
+	Reliable, // Acks and reliable messages, see ReliableEndpoint
 
 	// Last packet ID
 	Count
@@ -106,6 +151,9 @@ enum class ClientPacketID : en::U8
 	// Game specific packet
 	DropSeed,
 	Respawn,
+	SnapshotAck,
+
+	Reliable, // Acks and reliable messages, see ReliableEndpoint
 
 	// Last packet ID
 	Count
@@ -126,6 +174,17 @@ enum class RejectReason : en::U8
 };
 const char* GetRejectReasonString(RejectReason rejectReason);
 
+// Quantized fields shared by the compact encodings
+void WritePosition(en::BitWriter& writer, const en::Vector2f& position);
+en::Vector2f ReadPosition(en::BitReader& reader);
+void WriteRotation(en::BitWriter& writer, en::F32 rotation); // Wrapped to [0, 360)
+en::F32 ReadRotation(en::BitReader& reader); // In [0, 360)
+void WriteItemID(en::BitWriter& writer, en::U32 itemID);
+en::U32 ReadItemID(en::BitReader& reader); // Invalidates the reader if out of range
+
+// Unique key of an address+port
+en::U64 GetEndpointKey(const sf::IpAddress& remoteAddress, en::U16 remotePort);
+
 enum class ItemID : en::U32
 {
 	None,
@@ -137,13 +196,14 @@ enum class ItemID : en::U32
 
 	Count
 };
+static_assert(static_cast<en::U32>(ItemID::Count) - 1 < (1u << DefaultItemIDBits));
 const char* GetItemName(ItemID itemID);
 bool IsValidItemForAttack(ItemID itemID);
 en::Time GetItemCooldown(ItemID itemID);
 en::F32 GetItemRange(ItemID itemID);
 en::F32 GetItemWeight(ItemID itemID);
 en::F32 GetItemAttack(ItemID itemID);
-ItemID GetRandomAttackItem();
+ItemID GetRandomAttackItem(en::RandomEngine& random);
 const char* GetItemTextureName(ItemID itemID);
 const char* GetItemMusicName(ItemID itemID);
 const char* GetItemSoundLootName(ItemID itemID);
@@ -166,6 +226,9 @@ struct Chicken
 };
 sf::Packet& operator<<(sf::Packet& packet, const Chicken& chicken);
 sf::Packet& operator>>(sf::Packet& packet, Chicken& chicken);
+PooledPacket& operator<<(PooledPacket& packet, const Chicken& chicken);
+en::BitWriter& operator<<(en::BitWriter& writer, const Chicken& chicken);
+en::BitReader& operator>>(en::BitReader& reader, Chicken& chicken);
 
 struct Seed
 {
@@ -178,6 +241,8 @@ struct Seed
 };
 sf::Packet& operator<<(sf::Packet& packet, const Seed& seed);
 sf::Packet& operator>>(sf::Packet& packet, Seed& seed);
+en::BitWriter& operator<<(en::BitWriter& writer, const Seed& seed);
+en::BitReader& operator>>(en::BitReader& reader, Seed& seed);
 
 struct Item
 {
@@ -187,6 +252,8 @@ struct Item
 };
 sf::Packet& operator<<(sf::Packet& packet, const Item& item);
 sf::Packet& operator>>(sf::Packet& packet, Item& item);
+en::BitWriter& operator<<(en::BitWriter& writer, const Item& item);
+en::BitReader& operator>>(en::BitReader& reader, Item& item);
 
 struct Bullet
 {
@@ -201,6 +268,8 @@ struct Bullet
 };
 sf::Packet& operator<<(sf::Packet& packet, const Bullet& bullet);
 sf::Packet& operator>>(sf::Packet& packet, Bullet& bullet);
+en::BitWriter& operator<<(en::BitWriter& writer, const Bullet& bullet);
+en::BitReader& operator>>(en::BitReader& reader, Bullet& bullet);
 
 struct Blood
 {
@@ -0,0 +1,69 @@
+#include "PacketBatch.hpp"
+
+#include <Enlivengine/System/Log.hpp>
+
+PacketBatch::PacketBatch()
+	: mData()
+{
+	// What an endpoint usually gets in a tick : a snapshot and a Reliable packet, with room for the small messages
+	mData.reserve(DefaultPacketBatchReservedSize);
+}
+
+bool PacketBatch::Append(const void* data, std::size_t size)
+{
+	if (size > en::U16_Max)
+	{
+		// Its size would be truncated, and the messages after it read from the wrong offset
+		LogError(en::LogChannel::All, 6, "Message of %d bytes too big for a batch, dropped", static_cast<en::I32>(size));
+		return false;
+	}
+	const char* bytes = static_cast<const char*>(data);
+	// Network byte order, like sf::Packet
+	mData.push_back(static_cast<char>((size >> 8) & 0xFF));
+	mData.push_back(static_cast<char>(size & 0xFF));
+	mData.insert(mData.end(), bytes, bytes + size);
+	return true;
+}
+
+bool PacketBatch::Append(const sf::Packet& packet)
+{
+	return Append(packet.getData(), packet.getDataSize());
+}
+
+PacketBatchReader::PacketBatchReader()
+	: mData(nullptr)
+	, mSize(0)
+	, mOffset(0)
+{
+}
+
+void PacketBatchReader::Reset(const void* data, std::size_t size)
+{
+	mData = static_cast<const char*>(data);
+	mSize = size;
+	mOffset = 0;
+}
+
+void PacketBatchReader::Clear()
+{
+	Reset(nullptr, 0);
+}
+
+bool PacketBatchReader::Next(sf::Packet& packet)
+{
+	if (mData == nullptr || mOffset + 2 > mSize)
+	{
+		return false;
+	}
+	const std::size_t messageSize = (static_cast<std::size_t>(static_cast<en::U8>(mData[mOffset])) << 8) | static_cast<en::U8>(mData[mOffset + 1]);
+	if (mOffset + 2 + messageSize > mSize)
+	{
+		// Truncated datagram, drop what is left
+		mOffset = mSize;
+		return false;
+	}
+	packet.clear();
+	packet.append(mData + mOffset + 2, messageSize);
+	mOffset += 2 + messageSize;
+	return true;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <Enlivengine/System/PrimitiveTypes.hpp>
+#include <SFML/Network/Packet.hpp>
+#include <vector>
+
+#include "Common.hpp"
+
+// Outgoing messages of one endpoint, flushed into datagrams of at most DefaultMaxDatagramSize bytes
+// Each message is prefixed by its U16 size, a message bigger than a datagram is sent alone
+// A message too big for its size prefix is dropped : Append returns false
+class PacketBatch
+{
+public:
+	PacketBatch();
+
+	bool Append(const void* data, std::size_t size);
+	bool Append(const sf::Packet& packet);
+
+	// Call sendDatagram(const void* data, std::size_t size) for each datagram, then clear
+	template <typename F>
+	void Flush(F&& sendDatagram);
+
+	bool IsEmpty() const { return mData.empty(); }
+	std::size_t GetSize() const { return mData.size(); }
+
+private:
+	std::vector<char> mData; // Capacity is kept between ticks
+};
+
+// Iterate the messages of a received datagram
+// The datagram must stay alive while the messages are read
+class PacketBatchReader
+{
+public:
+	PacketBatchReader();
+
+	void Reset(const void* data, std::size_t size);
+	void Clear();
+
+	// False when there is no complete message left
+	bool Next(sf::Packet& packet);
+
+private:
+	const char* mData;
+	std::size_t mSize;
+	std::size_t mOffset;
+};
+
+template <typename F>
+void PacketBatch::Flush(F&& sendDatagram)
+{
+	const std::size_t size = mData.size();
+	std::size_t datagramStart = 0;
+	std::size_t offset = 0;
+	while (offset < size)
+	{
+		const std::size_t messageSize = 2 + ((static_cast<std::size_t>(static_cast<en::U8>(mData[offset])) << 8) | static_cast<en::U8>(mData[offset + 1]));
+		if (offset > datagramStart && offset + messageSize - datagramStart > DefaultMaxDatagramSize)
+		{
+			sendDatagram(mData.data() + datagramStart, offset - datagramStart);
+			datagramStart = offset;
+		}
+		offset += messageSize;
+	}
+	if (offset > datagramStart)
+	{
+		sendDatagram(mData.data() + datagramStart, offset - datagramStart);
+	}
+	mData.clear();
+}
@@ -0,0 +1,146 @@
+#include "PacketPool.hpp"
+
+#include <Enlivengine/System/Assert.hpp>
+#include <Enlivengine/System/Endianness.hpp>
+
+#include <cstring>
+
+// Integers are sent big-endian, like sf::Packet does with htons/htonl
+static en::U16 ToNetworkU16(en::U16 value)
+{
+	return (en::GetPlatformEndianness() == en::Endianness::LittleEndian) ? en::swapU16(value) : value;
+}
+
+static en::U32 ToNetworkU32(en::U32 value)
+{
+	return (en::GetPlatformEndianness() == en::Endianness::LittleEndian) ? en::swapU32(value) : value;
+}
+
+PacketPool::PacketPool()
+	: mStorage(static_cast<std::size_t>(DefaultPacketPoolSize) * DefaultMaxDatagramSize)
+	, mFree()
+{
+	mFree.reserve(DefaultPacketPoolSize);
+	for (en::U32 i = DefaultPacketPoolSize; i > 0; --i)
+	{
+		mFree.push_back(mStorage.data() + static_cast<std::size_t>(i - 1) * DefaultMaxDatagramSize);
+	}
+}
+
+char* PacketPool::Acquire()
+{
+	assert(!mFree.empty());
+	if (mFree.empty())
+	{
+		return nullptr;
+	}
+	char* buffer = mFree.back();
+	mFree.pop_back();
+	return buffer;
+}
+
+void PacketPool::Release(char* buffer)
+{
+	if (buffer != nullptr)
+	{
+		// Capacity reserved in the constructor, never allocates
+		mFree.push_back(buffer);
+	}
+}
+
+PooledPacket::PooledPacket(PacketPool& pool)
+	: mPool(pool)
+	, mBuffer(pool.Acquire())
+	, mSize(0)
+	, mValid(mBuffer != nullptr)
+{
+}
+
+PooledPacket::~PooledPacket()
+{
+	mPool.Release(mBuffer);
+}
+
+void PooledPacket::append(const void* data, std::size_t sizeInBytes)
+{
+	if (!mValid || mSize + sizeInBytes > DefaultMaxDatagramSize)
+	{
+		mValid = false;
+		return;
+	}
+	if (sizeInBytes > 0)
+	{
+		std::memcpy(mBuffer + mSize, data, sizeInBytes);
+		mSize += sizeInBytes;
+	}
+}
+
+void PooledPacket::clear()
+{
+	mSize = 0;
+	mValid = (mBuffer != nullptr);
+}
+
+PooledPacket& PooledPacket::operator<<(bool data)
+{
+	return *this << static_cast<en::U8>(data);
+}
+
+PooledPacket& PooledPacket::operator<<(en::I8 data)
+{
+	append(&data, sizeof(data));
+	return *this;
+}
+
+PooledPacket& PooledPacket::operator<<(en::U8 data)
+{
+	append(&data, sizeof(data));
+	return *this;
+}
+
+PooledPacket& PooledPacket::operator<<(en::I16 data)
+{
+	return *this << static_cast<en::U16>(data);
+}
+
+PooledPacket& PooledPacket::operator<<(en::U16 data)
+{
+	const en::U16 toWrite = ToNetworkU16(data);
+	append(&toWrite, sizeof(toWrite));
+	return *this;
+}
+
+PooledPacket& PooledPacket::operator<<(en::I32 data)
+{
+	return *this << static_cast<en::U32>(data);
+}
+
+PooledPacket& PooledPacket::operator<<(en::U32 data)
+{
+	const en::U32 toWrite = ToNetworkU32(data);
+	append(&toWrite, sizeof(toWrite));
+	return *this;
+}
+
+PooledPacket& PooledPacket::operator<<(en::F32 data)
+{
+	// Native order, like sf::Packet
+	append(&data, sizeof(data));
+	return *this;
+}
+
+PooledPacket& PooledPacket::operator<<(const char* data)
+{
+	const en::U32 length = static_cast<en::U32>(std::strlen(data));
+	*this << length;
+	append(data, length);
+	return *this;
+}
+
+PooledPacket& PooledPacket::operator<<(const std::string& data)
+{
+	const en::U32 length = static_cast<en::U32>(data.size());
+	*this << length;
+	append(data.data(), length);
+	return *this;
+}
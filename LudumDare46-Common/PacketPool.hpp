@@ -0,0 +1,65 @@
+#pragma once
+
+#include <Enlivengine/System/PrimitiveTypes.hpp>
+#include <Enlivengine/System/NonCopyable.hpp>
+#include <string>
+#include <vector>
+
+#include "Common.hpp"
+
+// Fixed number of DefaultMaxDatagramSize buffers, allocated once
+class PacketPool : private en::NonCopyable
+{
+public:
+	PacketPool();
+
+	en::U32 GetCapacity() const { return DefaultPacketPoolSize; }
+	en::U32 GetUsedCount() const { return DefaultPacketPoolSize - static_cast<en::U32>(mFree.size()); }
+
+private:
+	friend class PooledPacket;
+
+	// nullptr when every buffer is used
+	char* Acquire();
+	void Release(char* buffer);
+
+private:
+	std::vector<char> mStorage;
+	std::vector<char*> mFree;
+};
+
+// Outgoing message written in place into a buffer of a PacketPool, released when the packet is destroyed
+// Same writing interface and encoding as sf::Packet (network byte order, strings prefixed by their U32 length),
+// so the receiver reads it with a sf::Packet and the templates written for sf::Packet work with it
+// Writing past DefaultMaxDatagramSize invalidates the packet, and invalid packets are not sent
+class PooledPacket : private en::NonCopyable
+{
+public:
+	explicit PooledPacket(PacketPool& pool);
+	~PooledPacket();
+
+	void append(const void* data, std::size_t sizeInBytes);
+	void clear();
+
+	const void* getData() const { return mBuffer; }
+	std::size_t getDataSize() const { return mSize; }
+
+	explicit operator bool() const { return mValid; }
+
+	PooledPacket& operator<<(bool data);
+	PooledPacket& operator<<(en::I8 data);
+	PooledPacket& operator<<(en::U8 data);
+	PooledPacket& operator<<(en::I16 data);
+	PooledPacket& operator<<(en::U16 data);
+	PooledPacket& operator<<(en::I32 data);
+	PooledPacket& operator<<(en::U32 data);
+	PooledPacket& operator<<(en::F32 data);
+	PooledPacket& operator<<(const char* data);
+	PooledPacket& operator<<(const std::string& data);
+
+private:
+	PacketPool& mPool;
+	char* mBuffer;
+	std::size_t mSize;
+	bool mValid;
+};
@@ -0,0 +1,346 @@
+#include "ReliableEndpoint.hpp"
+
+#include <Enlivengine/Math/Utilities.hpp>
+
+static_assert(DefaultReliableWindowSize <= 32, "The ack bitfield covers 32 messages");
+static_assert(65536 % DefaultReliableQueueSize == 0 && 65536 % DefaultReliableWindowSize == 0, "Sequences must wrap on a slot boundary");
+
+static bool IsSequenceBefore(en::U16 a, en::U16 b)
+{
+	return static_cast<en::I16>(a - b) < 0;
+}
+
+// Integers are read big-endian, like sf::Packet writes them
+static bool ReadU8(const char*& data, const char* end, en::U8& value)
+{
+	if (end - data < 1)
+	{
+		return false;
+	}
+	value = static_cast<en::U8>(data[0]);
+	data += 1;
+	return true;
+}
+
+static bool ReadU16(const char*& data, const char* end, en::U16& value)
+{
+	if (end - data < 2)
+	{
+		return false;
+	}
+	value = static_cast<en::U16>((static_cast<en::U8>(data[0]) << 8) | static_cast<en::U8>(data[1]));
+	data += 2;
+	return true;
+}
+
+static bool ReadU32(const char*& data, const char* end, en::U32& value)
+{
+	if (end - data < 4)
+	{
+		return false;
+	}
+	value = (static_cast<en::U32>(static_cast<en::U8>(data[0])) << 24) | (static_cast<en::U32>(static_cast<en::U8>(data[1])) << 16)
+		| (static_cast<en::U32>(static_cast<en::U8>(data[2])) << 8) | static_cast<en::U32>(static_cast<en::U8>(data[3]));
+	data += 4;
+	return true;
+}
+
+ReliableEndpoint::ReliableEndpoint()
+	: mChannels()
+	, mRoundTripTime(en::Time::Zero)
+	, mResendCount(0)
+	, mPollChannel(0)
+{
+}
+
+void ReliableEndpoint::Reset()
+{
+	for (Channel& channel : mChannels)
+	{
+		for (SentMessage& message : channel.sent)
+		{
+			message.data.clear();
+			message.sendCount = 0;
+			message.acked = false;
+		}
+		for (ReceivedMessage& message : channel.received)
+		{
+			message.data.clear();
+			message.received = false;
+		}
+		channel.oldestUnacked = 0;
+		channel.nextSequence = 0;
+		channel.nextExpected = 0;
+		channel.ackPending = false;
+	}
+	mRoundTripTime = en::Time::Zero;
+	mResendCount = 0;
+	mPollChannel = 0;
+}
+
+bool ReliableEndpoint::Send(const void* data, std::size_t size, ReliableChannelID channelID)
+{
+	Initialize();
+	Channel& channel = mChannels[static_cast<en::U32>(channelID)];
+	if (static_cast<en::U16>(channel.nextSequence - channel.oldestUnacked) >= DefaultReliableQueueSize || size > en::U16_Max)
+	{
+		return false;
+	}
+
+	SentMessage& message = channel.sent[channel.nextSequence % DefaultReliableQueueSize];
+	const char* bytes = static_cast<const char*>(data);
+	message.data.assign(bytes, bytes + size);
+	message.sentTime = en::Time::Zero;
+	message.sendCount = 0;
+	message.acked = false;
+	channel.nextSequence++;
+	return true;
+}
+
+bool ReliableEndpoint::WritePacket(sf::Packet& packet, en::Time now)
+{
+	if (mChannels.empty())
+	{
+		return false;
+	}
+
+	// Gather what is due before writing anything, most calls have nothing to send
+	const en::Time resendDelay = GetResendDelay();
+	const auto isDue = [now, resendDelay](const SentMessage& message)
+	{
+		return !message.acked && (message.sendCount == 0 || now - message.sentTime >= resendDelay);
+	};
+	bool hasSomethingToSend = false;
+	for (const Channel& channel : mChannels)
+	{
+		hasSomethingToSend = hasSomethingToSend || channel.ackPending;
+		const en::U16 inFlight = en::Math::Min<en::U16>(static_cast<en::U16>(channel.nextSequence - channel.oldestUnacked), DefaultReliableWindowSize);
+		for (en::U16 i = 0; i < inFlight && !hasSomethingToSend; ++i)
+		{
+			hasSomethingToSend = isDue(channel.sent[static_cast<en::U16>(channel.oldestUnacked + i) % DefaultReliableQueueSize]);
+		}
+	}
+	if (!hasSomethingToSend)
+	{
+		return false;
+	}
+
+	for (Channel& channel : mChannels)
+	{
+		// The messages received but not polled yet are acked too, the ack starts after them
+		en::U16 ackNext = channel.nextExpected;
+		while (static_cast<en::U16>(ackNext - channel.nextExpected) < DefaultReliableWindowSize && channel.received[ackNext % DefaultReliableWindowSize].received)
+		{
+			ackNext++;
+		}
+		en::U32 ackBits = 0;
+		for (en::U32 i = 0; static_cast<en::U16>(ackNext + 1 + i - channel.nextExpected) < DefaultReliableWindowSize; ++i)
+		{
+			if (channel.received[static_cast<en::U16>(ackNext + 1 + i) % DefaultReliableWindowSize].received)
+			{
+				ackBits |= (1u << i);
+			}
+		}
+		packet << ackNext << ackBits;
+		channel.ackPending = false;
+	}
+
+	// Counted first, since sf::Packet can't write it afterwards
+	// A message bigger than what is left waits for the next packet, unless it is the first one
+	const auto forEachMessageToSend = [this, &isDue](std::size_t size, auto&& func)
+	{
+		const std::size_t maxSize = DefaultMaxDatagramSize - 2; // Size prefix of the PacketBatch
+		en::U32 count = 0;
+		for (en::U32 c = 0; c < ChannelCount; ++c)
+		{
+			Channel& channel = mChannels[c];
+			const en::U16 inFlight = en::Math::Min<en::U16>(static_cast<en::U16>(channel.nextSequence - channel.oldestUnacked), DefaultReliableWindowSize);
+			for (en::U16 i = 0; i < inFlight && count < en::U8_Max; ++i)
+			{
+				const en::U16 sequence = static_cast<en::U16>(channel.oldestUnacked + i);
+				SentMessage& message = channel.sent[sequence % DefaultReliableQueueSize];
+				if (!isDue(message))
+				{
+					continue;
+				}
+				size += 5 + message.data.size();
+				if (count > 0 && size > maxSize)
+				{
+					return;
+				}
+				func(c, sequence, message);
+				count++;
+			}
+		}
+	};
+
+	en::U8 count = 0;
+	const std::size_t size = packet.getDataSize() + 1;
+	forEachMessageToSend(size, [&count](en::U32, en::U16, SentMessage&) { count++; });
+	packet << count;
+	forEachMessageToSend(size, [this, &packet, now](en::U32 channel, en::U16 sequence, SentMessage& message)
+	{
+		packet << static_cast<en::U8>(channel) << sequence << static_cast<en::U16>(message.data.size());
+		packet.append(message.data.data(), message.data.size());
+		if (message.sendCount > 0)
+		{
+			mResendCount++;
+		}
+		message.sentTime = now;
+		message.sendCount++;
+	});
+	return true;
+}
+
+bool ReliableEndpoint::ReadPacket(const void* data, std::size_t size, en::Time now)
+{
+	Initialize();
+	const char* bytes = static_cast<const char*>(data);
+	const char* end = bytes + size;
+
+	for (Channel& channel : mChannels)
+	{
+		en::U16 nextExpected;
+		en::U32 ackBits;
+		if (!ReadU16(bytes, end, nextExpected) || !ReadU32(bytes, end, ackBits))
+		{
+			return false;
+		}
+		Acknowledge(channel, nextExpected, ackBits, now);
+	}
+
+	en::U8 count;
+	if (!ReadU8(bytes, end, count))
+	{
+		return false;
+	}
+	for (en::U8 i = 0; i < count; ++i)
+	{
+		en::U8 channelIndex;
+		en::U16 sequence;
+		en::U16 messageSize;
+		if (!ReadU8(bytes, end, channelIndex) || !ReadU16(bytes, end, sequence) || !ReadU16(bytes, end, messageSize)
+			|| channelIndex >= ChannelCount || end - bytes < messageSize)
+		{
+			return false;
+		}
+
+		// Acked even if already received : the sender didn't get the previous ack
+		Channel& channel = mChannels[channelIndex];
+		channel.ackPending = true;
+		if (static_cast<en::U16>(sequence - channel.nextExpected) < DefaultReliableWindowSize)
+		{
+			ReceivedMessage& message = channel.received[sequence % DefaultReliableWindowSize];
+			if (!message.received)
+			{
+				message.data.assign(bytes, bytes + messageSize);
+				message.received = true;
+			}
+		}
+		bytes += messageSize;
+	}
+	return true;
+}
+
+bool ReliableEndpoint::PollMessage(sf::Packet& message)
+{
+	for (en::U32 i = 0; i < static_cast<en::U32>(mChannels.size()); ++i)
+	{
+		const en::U32 channelIndex = (mPollChannel + i) % ChannelCount;
+		Channel& channel = mChannels[channelIndex];
+		ReceivedMessage& received = channel.received[channel.nextExpected % DefaultReliableWindowSize];
+		if (received.received)
+		{
+			message.clear();
+			message.append(received.data.data(), received.data.size());
+			received.received = false;
+			channel.nextExpected++;
+			mPollChannel = (channelIndex + 1) % ChannelCount;
+			return true;
+		}
+	}
+	return false;
+}
+
+en::Time ReliableEndpoint::GetResendDelay() const
+{
+	// A bit more than a round trip, so a late ack doesn't trigger a resend
+	const en::Time delay = en::seconds(1.5f * mRoundTripTime.asSeconds());
+	return (delay > DefaultReliableMinResendDelay) ? delay : DefaultReliableMinResendDelay;
+}
+
+en::U32 ReliableEndpoint::GetQueuedCount(ReliableChannelID channelID) const
+{
+	if (mChannels.empty())
+	{
+		return 0;
+	}
+	const Channel& channel = mChannels[static_cast<en::U32>(channelID)];
+	return static_cast<en::U16>(channel.nextSequence - channel.oldestUnacked);
+}
+
+void ReliableEndpoint::Initialize()
+{
+	if (!mChannels.empty())
+	{
+		return;
+	}
+	mChannels.resize(ChannelCount);
+	for (Channel& channel : mChannels)
+	{
+		channel.sent.resize(DefaultReliableQueueSize);
+		for (SentMessage& message : channel.sent)
+		{
+			message.sentTime = en::Time::Zero;
+			message.sendCount = 0;
+			message.acked = false;
+		}
+		channel.oldestUnacked = 0;
+		channel.nextSequence = 0;
+		channel.received.resize(DefaultReliableWindowSize);
+		for (ReceivedMessage& message : channel.received)
+		{
+			message.received = false;
+		}
+		channel.nextExpected = 0;
+		channel.ackPending = false;
+	}
+}
+
+void ReliableEndpoint::Acknowledge(Channel& channel, en::U16 nextExpected, en::U32 ackBits, en::Time now)
+{
+	const en::U16 inFlight = en::Math::Min<en::U16>(static_cast<en::U16>(channel.nextSequence - channel.oldestUnacked), DefaultReliableWindowSize);
+	for (en::U16 i = 0; i < inFlight; ++i)
+	{
+		const en::U16 sequence = static_cast<en::U16>(channel.oldestUnacked + i);
+		SentMessage& message = channel.sent[sequence % DefaultReliableQueueSize];
+		if (message.acked || message.sendCount == 0)
+		{
+			continue;
+		}
+
+		const en::U16 afterNextExpected = static_cast<en::U16>(sequence - nextExpected - 1);
+		const bool acked = IsSequenceBefore(sequence, nextExpected) || (afterNextExpected < 32 && (ackBits & (1u << afterNextExpected)) != 0);
+		if (acked)
+		{
+			message.acked = true;
+
+			// Only the messages sent once tell when they arrived
+			if (message.sendCount == 1)
+			{
+				const en::Time sample = now - message.sentTime;
+				mRoundTripTime = (mRoundTripTime == en::Time::Zero) ? sample : en::seconds(0.875f * mRoundTripTime.asSeconds() + 0.125f * sample.asSeconds());
+			}
+		}
+	}
+
+	// Free the slots of the acked messages, the window moves past them
+	while (channel.oldestUnacked != channel.nextSequence && channel.sent[channel.oldestUnacked % DefaultReliableQueueSize].acked)
+	{
+		SentMessage& message = channel.sent[channel.oldestUnacked % DefaultReliableQueueSize];
+		message.data.clear();
+		message.acked = false;
+		message.sendCount = 0;
+		channel.oldestUnacked++;
+	}
+}
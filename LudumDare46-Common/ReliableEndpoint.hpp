@@ -0,0 +1,89 @@
+#pragma once
+
+#include <Enlivengine/System/PrimitiveTypes.hpp>
+#include <Enlivengine/System/Time.hpp>
+#include <SFML/Network/Packet.hpp>
+#include <vector>
+
+#include "Common.hpp"
+
+// Each channel is delivered in order, independently of the others : a loss only holds back its own channel
+enum class ReliableChannelID : en::U8
+{
+	Session, // Connection, players joining and leaving
+	Gameplay, // Actions of the client
+
+	Count
+};
+
+// Reliable-ordered messages over the unreliable datagrams, one per remote endpoint on each side
+// Messages are queued by Send, then WritePacket puts the ones due in a Reliable packet with the acks of what was received :
+// - every message has a sequence number per channel, the receiver acks the first one it is missing and a bitfield of the ones after it
+// - only the messages not acked after about a round trip are sent again
+// - the receiver buffers the messages received out of order, PollMessage returns them in order
+// Unreliable messages (snapshots, pings...) keep bypassing it
+class ReliableEndpoint
+{
+public:
+	ReliableEndpoint();
+
+	void Reset();
+
+	// False if too many messages of the channel are waiting for their ack, the message is dropped
+	bool Send(const void* data, std::size_t size, ReliableChannelID channel);
+
+	// Append the acks and the messages due to packet, after its packet ID
+	// False if there is nothing to send : no new message, no resend due and nothing to ack
+	bool WritePacket(sf::Packet& packet, en::Time now);
+
+	// Content of a received Reliable packet, after its packet ID
+	// False if it is malformed, what was read before is kept
+	bool ReadPacket(const void* data, std::size_t size, en::Time now);
+
+	// Next message in order, from any channel
+	bool PollMessage(sf::Packet& message);
+
+	// Smoothed over the acks of the messages sent only once, zero until the first one
+	en::Time GetRoundTripTime() const { return mRoundTripTime; }
+	en::Time GetResendDelay() const;
+	en::U32 GetQueuedCount(ReliableChannelID channel) const;
+	en::U64 GetResendCount() const { return mResendCount; }
+
+private:
+	struct SentMessage
+	{
+		std::vector<char> data; // Capacity is kept when the slot is reused
+		en::Time sentTime;
+		en::U32 sendCount; // 0 until first sent
+		bool acked;
+	};
+
+	struct ReceivedMessage
+	{
+		std::vector<char> data;
+		bool received;
+	};
+
+	struct Channel
+	{
+		std::vector<SentMessage> sent; // DefaultReliableQueueSize, indexed by sequence
+		en::U16 oldestUnacked;
+		en::U16 nextSequence;
+
+		std::vector<ReceivedMessage> received; // DefaultReliableWindowSize, indexed by sequence
+		en::U16 nextExpected;
+		bool ackPending;
+	};
+
+	static constexpr en::U32 ChannelCount = static_cast<en::U32>(ReliableChannelID::Count);
+
+	// Allocated with the first message, so endpoints that never use it (AI players) cost nothing
+	void Initialize();
+	void Acknowledge(Channel& channel, en::U16 nextExpected, en::U32 ackBits, en::Time now);
+
+private:
+	std::vector<Channel> mChannels;
+	en::Time mRoundTripTime;
+	en::U64 mResendCount;
+	en::U32 mPollChannel; // Channel PollMessage starts from, so none is starved
+};
@@ -0,0 +1,499 @@
+#include "Snapshot.hpp"
+
+#include <algorithm>
+
+// Fields of a chicken sent in a delta
+enum ChickenDeltaMask : en::U8
+{
+	ChickenDeltaPosition = 1 << 0,
+	ChickenDeltaRotation = 1 << 1,
+	ChickenDeltaItem = 1 << 2,
+	ChickenDeltaKills = 1 << 3,
+	ChickenDeltaLife = 1 << 4, // life + lifeMax
+	ChickenDeltaStats = 1 << 5, // speed + attack
+	ChickenDeltaFar = 1 << 6,
+	ChickenDeltaAll = 0x7F
+};
+
+#define ChickenDeltaBits 7
+#define SnapshotEventAgeBits 5
+#define SnapshotEventTypeBits 2
+static_assert(DefaultSnapshotBufferSize <= (1 << SnapshotEventAgeBits));
+static_assert(static_cast<en::U32>(SnapshotEventType::Count) <= (1 << SnapshotEventTypeBits));
+static_assert(DefaultRelevanceFarInterval < DefaultSnapshotBufferSize);
+
+static en::U32 GetChickenID(const SnapshotChicken& chicken) { return chicken.clientID; }
+static en::U32 GetScoreID(const SnapshotScore& score) { return score.clientID; }
+static en::U32 GetSeedID(const Seed& seed) { return seed.seedUID; }
+static en::U32 GetItemID(const Item& item) { return item.itemUID; }
+static en::U32 GetBulletID(const Bullet& bullet) { return bullet.bulletUID; }
+
+static const SnapshotChicken* FindSnapshotChicken(const Snapshot& snapshot, en::U32 clientID)
+{
+	const auto itr = std::lower_bound(snapshot.chickens.begin(), snapshot.chickens.end(), clientID, [](const SnapshotChicken& chicken, en::U32 id) { return chicken.clientID < id; });
+	return (itr != snapshot.chickens.end() && itr->clientID == clientID) ? &(*itr) : nullptr;
+}
+
+static bool IsSnapshotEventRelevant(const SnapshotEvent& event, const Snapshot& snapshot, en::U32 clientID)
+{
+	if (clientID == en::U32_Max || event.clientID == clientID || event.otherClientID == clientID)
+	{
+		return true;
+	}
+	const SnapshotChicken* own = FindSnapshotChicken(snapshot, clientID);
+	return own != nullptr && (event.position - own->chicken.position).getSquaredLength() <= DefaultRelevanceRadiusSqr;
+}
+
+static en::U8 GetChickenDeltaMask(const Chicken& baseline, const Chicken& current)
+{
+	en::U8 mask = 0;
+	if (baseline.position != current.position) mask |= ChickenDeltaPosition;
+	if (baseline.rotation != current.rotation) mask |= ChickenDeltaRotation;
+	if (baseline.itemID != current.itemID) mask |= ChickenDeltaItem;
+	if (baseline.kills != current.kills) mask |= ChickenDeltaKills;
+	if (baseline.life != current.life || baseline.lifeMax != current.lifeMax) mask |= ChickenDeltaLife;
+	if (baseline.speed != current.speed || baseline.attack != current.attack) mask |= ChickenDeltaStats;
+	return mask;
+}
+
+static en::U8 GetChickenDeltaMask(const SnapshotChicken& baseline, const SnapshotChicken& current)
+{
+	return GetChickenDeltaMask(baseline.chicken, current.chicken) | ((baseline.far != current.far) ? ChickenDeltaFar : 0);
+}
+
+bool IsSameChicken(const Chicken& a, const Chicken& b)
+{
+	return GetChickenDeltaMask(a, b) == 0;
+}
+
+static void WriteChickenDelta(en::BitWriter& writer, const SnapshotChicken& snapshotChicken, en::U8 mask)
+{
+	const Chicken& chicken = snapshotChicken.chicken;
+	writer.WriteBits(mask, ChickenDeltaBits);
+	if (mask & ChickenDeltaPosition) WritePosition(writer, chicken.position);
+	if (mask & ChickenDeltaRotation) WriteRotation(writer, chicken.rotation);
+	if (mask & ChickenDeltaItem) WriteItemID(writer, static_cast<en::U32>(chicken.itemID));
+	if (mask & ChickenDeltaKills) writer.WriteVarU32(chicken.kills);
+	if (mask & ChickenDeltaLife)
+	{
+		writer.WriteFloat(chicken.life, en::BitQuantization(DefaultLifeQuantization));
+		writer.WriteFloat(chicken.lifeMax, en::BitQuantization(DefaultLifeQuantization));
+	}
+	if (mask & ChickenDeltaStats)
+	{
+		writer.WriteFloat(chicken.speed, en::BitQuantization(DefaultStatQuantization));
+		writer.WriteFloat(chicken.attack, en::BitQuantization(DefaultStatQuantization));
+	}
+	if (mask & ChickenDeltaFar) writer.WriteBool(snapshotChicken.far);
+}
+
+static void ReadChickenDelta(en::BitReader& reader, SnapshotChicken& snapshotChicken)
+{
+	Chicken& chicken = snapshotChicken.chicken;
+	const en::U32 mask = reader.ReadBits(ChickenDeltaBits);
+	if (mask & ChickenDeltaPosition) chicken.position = ReadPosition(reader);
+	if (mask & ChickenDeltaRotation) chicken.rotation = ReadRotation(reader);
+	if (mask & ChickenDeltaItem) chicken.itemID = static_cast<ItemID>(ReadItemID(reader));
+	if (mask & ChickenDeltaKills) chicken.kills = reader.ReadVarU32();
+	if (mask & ChickenDeltaLife)
+	{
+		chicken.life = reader.ReadFloat(en::BitQuantization(DefaultLifeQuantization));
+		chicken.lifeMax = reader.ReadFloat(en::BitQuantization(DefaultLifeQuantization));
+	}
+	if (mask & ChickenDeltaStats)
+	{
+		chicken.speed = reader.ReadFloat(en::BitQuantization(DefaultStatQuantization));
+		chicken.attack = reader.ReadFloat(en::BitQuantization(DefaultStatQuantization));
+	}
+	if (mask & ChickenDeltaFar) snapshotChicken.far = reader.ReadBool();
+}
+
+// Seeds, items and bullets never change once created : only send removed IDs and added values
+template <typename T, typename GetID>
+static void WriteRemovedAndAdded(en::BitWriter& writer, const std::vector<T>& baseline, const std::vector<T>& current, GetID getID)
+{
+	en::U32 removedCount = 0;
+	en::U32 addedCount = 0;
+	ForEachSnapshotDifference(baseline, current, getID, [&](const T&) { removedCount++; }, [&](const T&) { addedCount++; }, [](const T&, const T&) {});
+
+	writer.WriteVarU32(removedCount);
+	ForEachSnapshotDifference(baseline, current, getID, [&](const T& value) { writer.WriteVarU32(getID(value)); }, [](const T&) {}, [](const T&, const T&) {});
+	writer.WriteVarU32(addedCount);
+	ForEachSnapshotDifference(baseline, current, getID, [](const T&) {}, [&](const T& value) { writer << value; }, [](const T&, const T&) {});
+}
+
+template <typename T, typename GetID>
+static bool ReadRemovedAndAdded(en::BitReader& reader, std::vector<T>& values, GetID getID)
+{
+	const auto lessID = [&getID](const T& value, en::U32 id) { return getID(value) < id; };
+
+	const en::U32 removedCount = reader.ReadVarU32();
+	for (en::U32 i = 0; i < removedCount && reader; ++i)
+	{
+		const en::U32 id = reader.ReadVarU32();
+		const auto itr = std::lower_bound(values.begin(), values.end(), id, lessID);
+		if (itr != values.end() && getID(*itr) == id)
+		{
+			values.erase(itr);
+		}
+	}
+
+	const en::U32 addedCount = reader.ReadVarU32();
+	for (en::U32 i = 0; i < addedCount && reader; ++i)
+	{
+		T value;
+		reader >> value;
+		const auto itr = std::lower_bound(values.begin(), values.end(), getID(value), lessID);
+		if (itr != values.end() && getID(*itr) == getID(value))
+		{
+			*itr = value;
+		}
+		else
+		{
+			values.insert(itr, value);
+		}
+	}
+
+	return reader.IsValid();
+}
+
+Snapshot::Snapshot()
+	: sequence(0)
+	, chickens()
+	, scores()
+	, seeds()
+	, items()
+	, bullets()
+	, events()
+{
+}
+
+void Snapshot::Clear()
+{
+	sequence = 0;
+	chickens.clear();
+	scores.clear();
+	seeds.clear();
+	items.clear();
+	bullets.clear();
+	events.clear();
+}
+
+void Snapshot::Sort()
+{
+	std::sort(chickens.begin(), chickens.end(), [](const SnapshotChicken& a, const SnapshotChicken& b) { return a.clientID < b.clientID; });
+	std::sort(scores.begin(), scores.end(), [](const SnapshotScore& a, const SnapshotScore& b) { return a.clientID < b.clientID; });
+	std::sort(seeds.begin(), seeds.end(), [](const Seed& a, const Seed& b) { return a.seedUID < b.seedUID; });
+	std::sort(items.begin(), items.end(), [](const Item& a, const Item& b) { return a.itemUID < b.itemUID; });
+	std::sort(bullets.begin(), bullets.end(), [](const Bullet& a, const Bullet& b) { return a.bulletUID < b.bulletUID; });
+}
+
+SnapshotBuffer::SnapshotBuffer()
+	: mSnapshots(DefaultSnapshotBufferSize)
+	, mEmpty()
+{
+}
+
+Snapshot& SnapshotBuffer::Push(en::U32 sequence)
+{
+	Snapshot& snapshot = mSnapshots[sequence % DefaultSnapshotBufferSize];
+	snapshot.Clear();
+	snapshot.sequence = sequence;
+	return snapshot;
+}
+
+const Snapshot* SnapshotBuffer::Get(en::U32 sequence) const
+{
+	if (sequence == 0)
+	{
+		return &mEmpty;
+	}
+	const Snapshot& snapshot = mSnapshots[sequence % DefaultSnapshotBufferSize];
+	return (snapshot.sequence == sequence) ? &snapshot : nullptr;
+}
+
+const Snapshot* SnapshotBuffer::GetBaseline(en::U32 sequence, en::U32 baselineSequence) const
+{
+	if (baselineSequence != 0 && sequence - baselineSequence >= DefaultSnapshotBufferSize)
+	{
+		return nullptr;
+	}
+	return Get(baselineSequence);
+}
+
+void SnapshotBuffer::Clear()
+{
+	for (Snapshot& snapshot : mSnapshots)
+	{
+		snapshot.Clear();
+	}
+}
+
+void Snapshot::Reserve(en::U32 chickenCount, en::U32 seedCount, en::U32 itemCount, en::U32 bulletCount, en::U32 eventCount)
+{
+	chickens.reserve(chickenCount);
+	scores.reserve(chickenCount);
+	seeds.reserve(seedCount);
+	items.reserve(itemCount);
+	bullets.reserve(bulletCount);
+	events.reserve(eventCount);
+}
+
+void SnapshotBuffer::Reserve(en::U32 chickenCount, en::U32 seedCount, en::U32 itemCount, en::U32 bulletCount, en::U32 eventCount)
+{
+	for (Snapshot& snapshot : mSnapshots)
+	{
+		snapshot.Reserve(chickenCount, seedCount, itemCount, bulletCount, eventCount);
+	}
+}
+
+en::U32 GetFarChickenSequence(en::U32 sequence, en::U32 clientID)
+{
+	const en::U32 age = (sequence + clientID) % DefaultRelevanceFarInterval;
+	return (age < sequence) ? sequence - age : sequence;
+}
+
+void BuildSnapshotView(const Snapshot& snapshot, const SnapshotBuffer& buffer, en::U32 clientID, Snapshot& view)
+{
+	view.Clear();
+	view.sequence = snapshot.sequence;
+	AssignSnapshotValues(view.scores, snapshot.scores.begin(), snapshot.scores.end());
+
+	const SnapshotChicken* own = FindSnapshotChicken(snapshot, clientID);
+	if (own == nullptr)
+	{
+		return;
+	}
+	const en::Vector2f center = own->chicken.position;
+	const auto isRelevant = [&center](const en::Vector2f& position) { return (position - center).getSquaredLength() <= DefaultRelevanceRadiusSqr; };
+
+	// Filtering keeps the arrays sorted
+	for (const SnapshotChicken& chicken : snapshot.chickens)
+	{
+		const en::F32 distanceSqr = (chicken.chicken.position - center).getSquaredLength();
+		if (distanceSqr <= DefaultRelevanceRadiusSqr)
+		{
+			view.chickens.push_back(chicken);
+		}
+		else if (distanceSqr <= DefaultRelevanceFarRadiusSqr)
+		{
+			const Snapshot* older = buffer.Get(GetFarChickenSequence(snapshot.sequence, chicken.clientID));
+			const SnapshotChicken* olderChicken = (older != nullptr) ? FindSnapshotChicken(*older, chicken.clientID) : nullptr;
+			view.chickens.push_back((olderChicken != nullptr) ? *olderChicken : chicken);
+			view.chickens.back().far = true;
+		}
+	}
+	for (const Seed& seed : snapshot.seeds)
+	{
+		if (seed.clientID == clientID || isRelevant(seed.position))
+		{
+			view.seeds.push_back(seed);
+		}
+	}
+	for (const Item& item : snapshot.items)
+	{
+		if (isRelevant(item.position))
+		{
+			view.items.push_back(item);
+		}
+	}
+	for (const Bullet& bullet : snapshot.bullets)
+	{
+		if (isRelevant(bullet.position))
+		{
+			view.bullets.push_back(bullet);
+		}
+	}
+}
+
+void WriteSnapshotDelta(en::BitWriter& writer, const Snapshot& baseline, const Snapshot& current, const SnapshotBuffer& buffer, en::U32 clientID)
+{
+	// Chickens : removed IDs, then only the changed fields
+	en::U32 removedCount = 0;
+	en::U32 changedCount = 0;
+	ForEachSnapshotDifference(baseline.chickens, current.chickens, GetChickenID,
+		[&](const SnapshotChicken&) { removedCount++; },
+		[&](const SnapshotChicken&) { changedCount++; },
+		[&](const SnapshotChicken& a, const SnapshotChicken& b) { if (GetChickenDeltaMask(a, b) != 0) changedCount++; });
+	writer.WriteVarU32(removedCount);
+	ForEachSnapshotDifference(baseline.chickens, current.chickens, GetChickenID,
+		[&](const SnapshotChicken& a) { writer.WriteBits(a.clientID, 32); },
+		[](const SnapshotChicken&) {},
+		[](const SnapshotChicken&, const SnapshotChicken&) {});
+	writer.WriteVarU32(changedCount);
+	ForEachSnapshotDifference(baseline.chickens, current.chickens, GetChickenID,
+		[](const SnapshotChicken&) {},
+		[&](const SnapshotChicken& b)
+		{
+			writer.WriteBits(b.clientID, 32);
+			WriteChickenDelta(writer, b, ChickenDeltaAll);
+		},
+		[&](const SnapshotChicken& a, const SnapshotChicken& b)
+		{
+			const en::U8 mask = GetChickenDeltaMask(a, b);
+			if (mask != 0)
+			{
+				writer.WriteBits(b.clientID, 32);
+				WriteChickenDelta(writer, b, mask);
+			}
+		});
+
+	// Scores : removed IDs, then the added and changed ones
+	removedCount = 0;
+	changedCount = 0;
+	ForEachSnapshotDifference(baseline.scores, current.scores, GetScoreID,
+		[&](const SnapshotScore&) { removedCount++; },
+		[&](const SnapshotScore&) { changedCount++; },
+		[&](const SnapshotScore& a, const SnapshotScore& b) { if (a.kills != b.kills) changedCount++; });
+	writer.WriteVarU32(removedCount);
+	ForEachSnapshotDifference(baseline.scores, current.scores, GetScoreID,
+		[&](const SnapshotScore& a) { writer.WriteBits(a.clientID, 32); },
+		[](const SnapshotScore&) {},
+		[](const SnapshotScore&, const SnapshotScore&) {});
+	writer.WriteVarU32(changedCount);
+	ForEachSnapshotDifference(baseline.scores, current.scores, GetScoreID,
+		[](const SnapshotScore&) {},
+		[&](const SnapshotScore& b)
+		{
+			writer.WriteBits(b.clientID, 32);
+			writer.WriteVarU32(b.kills);
+		},
+		[&](const SnapshotScore& a, const SnapshotScore& b)
+		{
+			if (a.kills != b.kills)
+			{
+				writer.WriteBits(b.clientID, 32);
+				writer.WriteVarU32(b.kills);
+			}
+		});
+
+	WriteRemovedAndAdded(writer, baseline.seeds, current.seeds, GetSeedID);
+	WriteRemovedAndAdded(writer, baseline.items, current.items, GetItemID);
+	WriteRemovedAndAdded(writer, baseline.bullets, current.bullets, GetBulletID);
+
+	// Events still in the buffer since the baseline, the client ignores the ones it already applied
+	const en::U32 firstSequence = en::Math::Max(baseline.sequence + 1, (current.sequence >= DefaultSnapshotBufferSize) ? current.sequence - DefaultSnapshotBufferSize + 1 : 1u);
+	en::U32 eventCount = 0;
+	for (en::U32 sequence = firstSequence; sequence <= current.sequence; ++sequence)
+	{
+		if (const Snapshot* snapshot = buffer.Get(sequence))
+		{
+			for (const SnapshotEvent& event : snapshot->events)
+			{
+				eventCount += IsSnapshotEventRelevant(event, *snapshot, clientID) ? 1 : 0;
+			}
+		}
+	}
+	writer.WriteVarU32(eventCount);
+	for (en::U32 sequence = firstSequence; sequence <= current.sequence; ++sequence)
+	{
+		if (const Snapshot* snapshot = buffer.Get(sequence))
+		{
+			for (const SnapshotEvent& event : snapshot->events)
+			{
+				if (!IsSnapshotEventRelevant(event, *snapshot, clientID))
+				{
+					continue;
+				}
+				writer.WriteBits(current.sequence - event.sequence, SnapshotEventAgeBits);
+				writer.WriteBits(static_cast<en::U32>(event.type), SnapshotEventTypeBits);
+				writer.WriteBits(event.clientID, 32);
+				writer.WriteBits(event.otherClientID, 32);
+				WriteItemID(writer, static_cast<en::U32>(event.itemID));
+				WritePosition(writer, event.position);
+			}
+		}
+	}
+}
+
+bool ReadSnapshotDelta(en::BitReader& reader, const Snapshot& baseline, Snapshot& current)
+{
+	AssignSnapshotValues(current.chickens, baseline.chickens.begin(), baseline.chickens.end());
+	AssignSnapshotValues(current.scores, baseline.scores.begin(), baseline.scores.end());
+	AssignSnapshotValues(current.seeds, baseline.seeds.begin(), baseline.seeds.end());
+	AssignSnapshotValues(current.items, baseline.items.begin(), baseline.items.end());
+	AssignSnapshotValues(current.bullets, baseline.bullets.begin(), baseline.bullets.end());
+	current.events.clear();
+
+	const auto lessClientID = [](const SnapshotChicken& chicken, en::U32 id) { return chicken.clientID < id; };
+	const en::U32 removedCount = reader.ReadVarU32();
+	for (en::U32 i = 0; i < removedCount && reader; ++i)
+	{
+		const en::U32 clientID = reader.ReadBits(32);
+		const auto itr = std::lower_bound(current.chickens.begin(), current.chickens.end(), clientID, lessClientID);
+		if (itr != current.chickens.end() && itr->clientID == clientID)
+		{
+			current.chickens.erase(itr);
+		}
+	}
+
+	const en::U32 changedCount = reader.ReadVarU32();
+	for (en::U32 i = 0; i < changedCount && reader; ++i)
+	{
+		const en::U32 clientID = reader.ReadBits(32);
+		auto itr = std::lower_bound(current.chickens.begin(), current.chickens.end(), clientID, lessClientID);
+		if (itr == current.chickens.end() || itr->clientID != clientID)
+		{
+			SnapshotChicken newChicken;
+			newChicken.clientID = clientID;
+			newChicken.chicken = Chicken();
+			newChicken.far = false;
+			itr = current.chickens.insert(itr, newChicken);
+		}
+		ReadChickenDelta(reader, *itr);
+	}
+
+	const auto lessScoreID = [](const SnapshotScore& score, en::U32 id) { return score.clientID < id; };
+	const en::U32 removedScoreCount = reader.ReadVarU32();
+	for (en::U32 i = 0; i < removedScoreCount && reader; ++i)
+	{
+		const en::U32 clientID = reader.ReadBits(32);
+		const auto itr = std::lower_bound(current.scores.begin(), current.scores.end(), clientID, lessScoreID);
+		if (itr != current.scores.end() && itr->clientID == clientID)
+		{
+			current.scores.erase(itr);
+		}
+	}
+
+	const en::U32 changedScoreCount = reader.ReadVarU32();
+	for (en::U32 i = 0; i < changedScoreCount && reader; ++i)
+	{
+		SnapshotScore score;
+		score.clientID = reader.ReadBits(32);
+		score.kills = reader.ReadVarU32();
+		const auto itr = std::lower_bound(current.scores.begin(), current.scores.end(), score.clientID, lessScoreID);
+		if (itr != current.scores.end() && itr->clientID == score.clientID)
+		{
+			*itr = score;
+		}
+		else
+		{
+			current.scores.insert(itr, score);
+		}
+	}
+
+	if (!ReadRemovedAndAdded(reader, current.seeds, GetSeedID)
+		|| !ReadRemovedAndAdded(reader, current.items, GetItemID)
+		|| !ReadRemovedAndAdded(reader, current.bullets, GetBulletID))
+	{
+		return false;
+	}
+
+	const en::U32 eventCount = reader.ReadVarU32();
+	for (en::U32 i = 0; i < eventCount && reader; ++i)
+	{
+		SnapshotEvent event;
+		event.sequence = current.sequence - reader.ReadBits(SnapshotEventAgeBits);
+		event.type = static_cast<SnapshotEventType>(reader.ReadBits(SnapshotEventTypeBits));
+		event.clientID = reader.ReadBits(32);
+		event.otherClientID = reader.ReadBits(32);
+		event.itemID = static_cast<ItemID>(ReadItemID(reader));
+		event.position = ReadPosition(reader);
+		if (event.type < SnapshotEventType::Count)
+		{
+			current.events.push_back(event);
+		}
+	}
+
+	return reader.IsValid();
+}
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <Enlivengine/System/PrimitiveTypes.hpp>
+#include <Enlivengine/System/BitStream.hpp>
+#include <Enlivengine/Math/Vector2.hpp>
+#include <SFML/Network/Packet.hpp>
+#include <vector>
+
+#include "Common.hpp"
+
+// One-shot gameplay events that can't be deduced from two snapshots
+enum class SnapshotEventType : en::U8
+{
+	KillChicken, // clientID killed by otherClientID
+	EatSeed, // clientID ate a seed at position
+	PickUpItem, // clientID picked up itemID at position
+
+	Count
+};
+
+struct SnapshotEvent
+{
+	en::U32 sequence; // Snapshot in which the event happened
+	SnapshotEventType type;
+	en::U32 clientID;
+	en::U32 otherClientID;
+	ItemID itemID;
+	en::Vector2f position;
+};
+
+struct SnapshotChicken
+{
+	en::U32 clientID;
+	Chicken chicken;
+	bool far; // Only in a view : chicken is as it was in the snapshot of GetFarChickenSequence
+};
+
+// Kills of every player, sent even when the chicken is outside of the view
+struct SnapshotScore
+{
+	en::U32 clientID;
+	en::U32 kills;
+};
+
+// State of the world replicated to the clients at a given tick
+// Every array is sorted by ID, so two snapshots can be compared with a single merge walk
+struct Snapshot
+{
+	Snapshot();
+
+	en::U32 sequence; // 0 is the empty baseline, used to send the full state
+	std::vector<SnapshotChicken> chickens; // Sorted by clientID
+	std::vector<SnapshotScore> scores; // Sorted by clientID
+	std::vector<Seed> seeds; // Sorted by seedUID
+	std::vector<Item> items; // Sorted by itemUID
+	std::vector<Bullet> bullets; // Sorted by bulletUID
+	std::vector<SnapshotEvent> events; // Happened since the previous snapshot
+
+	// Keep the capacity, so snapshots stored in a buffer don't allocate once warm
+	void Clear();
+	void Sort();
+	void Reserve(en::U32 chickenCount, en::U32 seedCount, en::U32 itemCount, en::U32 bulletCount, en::U32 eventCount);
+};
+
+// Last DefaultSnapshotBufferSize snapshots, indexed by sequence
+class SnapshotBuffer
+{
+public:
+	SnapshotBuffer();
+
+	// Cleared snapshot replacing the one DefaultSnapshotBufferSize sequences before
+	Snapshot& Push(en::U32 sequence);
+
+	// Empty snapshot for 0, nullptr if the snapshot is unknown or has been replaced
+	const Snapshot* Get(en::U32 sequence) const;
+
+	// Baseline to decode the snapshot of sequence against, nullptr if it can't be used anymore
+	// The empty baseline 0 of the full state snapshots is always usable, whatever the sequence
+	const Snapshot* GetBaseline(en::U32 sequence, en::U32 baselineSequence) const;
+
+	void Clear();
+
+	// Capacity of every snapshot, so the buffer doesn't allocate while the counts stay below
+	void Reserve(en::U32 chickenCount, en::U32 seedCount, en::U32 itemCount, en::U32 bulletCount, en::U32 eventCount);
+
+private:
+	std::vector<Snapshot> mSnapshots;
+	Snapshot mEmpty;
+};
+
+bool IsSameChicken(const Chicken& a, const Chicken& b);
+
+// Like values.assign(first, last), but the capacity grows geometrically
+// assign() reallocates to the exact size every time the count reaches a new high
+template <typename T, typename Iterator>
+void AssignSnapshotValues(std::vector<T>& values, Iterator first, Iterator last)
+{
+	const std::size_t size = static_cast<std::size_t>(last - first);
+	if (size > values.capacity())
+	{
+		values.reserve(size * 2);
+	}
+	values.assign(first, last);
+}
+
+// Walk two arrays sorted by ID and call onRemoved(old) / onAdded(new) / onBoth(old, new)
+template <typename T, typename GetID, typename OnRemoved, typename OnAdded, typename OnBoth>
+void ForEachSnapshotDifference(const std::vector<T>& baseline, const std::vector<T>& current, GetID&& getID, OnRemoved&& onRemoved, OnAdded&& onAdded, OnBoth&& onBoth)
+{
+	const std::size_t baselineSize = baseline.size();
+	const std::size_t currentSize = current.size();
+	std::size_t b = 0;
+	std::size_t c = 0;
+	while (b < baselineSize || c < currentSize)
+	{
+		if (c >= currentSize || (b < baselineSize && getID(baseline[b]) < getID(current[c])))
+		{
+			onRemoved(baseline[b++]);
+		}
+		else if (b >= baselineSize || getID(current[c]) < getID(baseline[b]))
+		{
+			onAdded(current[c++]);
+		}
+		else
+		{
+			onBoth(baseline[b++], current[c++]);
+		}
+	}
+}
+
+// Part of snapshot relevant to the client of clientID, from the position of its chicken in that snapshot (empty without it)
+// Entities within DefaultRelevanceRadius, and chickens up to DefaultRelevanceFarRadius as they were in an older snapshot,
+// so they only change every DefaultRelevanceFarInterval snapshots. The scores of every player are always kept
+// Only reads the buffered snapshots : the view of a baseline is rebuilt the same as when it was sent,
+// as long as it is at most DefaultSnapshotBufferSize - DefaultRelevanceFarInterval sequences old
+void BuildSnapshotView(const Snapshot& snapshot, const SnapshotBuffer& buffer, en::U32 clientID, Snapshot& view);
+
+// Snapshot the far chicken of clientID is taken from in the view of snapshot sequence
+// Staggered by ID, so the far chickens don't all change in the same snapshot
+en::U32 GetFarChickenSequence(en::U32 sequence, en::U32 clientID);
+
+// ServerPacketID::Snapshot, sequence and baseline sequence are written with sf::Packet, the bit-packed delta follows
+constexpr std::size_t SnapshotHeaderSize = sizeof(en::U8) + sizeof(en::U32) + sizeof(en::U32);
+
+// Write what changed from baseline to current, and the events of every snapshot in (baseline, current]
+// Chickens are sent with a mask of changed fields, seeds/items/bullets never change so only their added and removed ones are sent
+// Scores are sent when they change
+// With a clientID, only its events and the ones within DefaultRelevanceRadius of its chicken are sent
+void WriteSnapshotDelta(en::BitWriter& writer, const Snapshot& baseline, const Snapshot& current, const SnapshotBuffer& buffer, en::U32 clientID = en::U32_Max);
+
+// Rebuild current from baseline and the delta, current.sequence must already be set
+bool ReadSnapshotDelta(en::BitReader& reader, const Snapshot& baseline, Snapshot& current);
@@ -0,0 +1,101 @@
+#include "SpatialGrid.hpp"
+#include "Common.hpp"
+
+#include <algorithm>
+
+SpatialGrid::SpatialGrid()
+	: mCells()
+	, mCellCountX(0)
+	, mCellCountY(0)
+	, mCellSize(1.0f)
+	, mInvCellSize(1.0f)
+	, mSize(0)
+{
+}
+
+void SpatialGrid::Initialize(const en::Vector2f& worldSize, en::F32 cellSize)
+{
+	mCellSize = cellSize;
+	mInvCellSize = 1.0f / cellSize;
+	mCellCountX = en::Math::Max(1u, static_cast<en::U32>(en::Math::Ceil(worldSize.x * mInvCellSize)));
+	mCellCountY = en::Math::Max(1u, static_cast<en::U32>(en::Math::Ceil(worldSize.y * mInvCellSize)));
+	mCells.clear();
+	mCells.resize(static_cast<std::size_t>(mCellCountX) * mCellCountY);
+	for (std::vector<en::U32>& cell : mCells)
+	{
+		cell.reserve(DefaultSpatialGridCellCapacity);
+	}
+	mSize = 0;
+}
+
+void SpatialGrid::Clear()
+{
+	// Keep the capacity of each cell, so rebuilding every step doesn't allocate
+	for (std::vector<en::U32>& cell : mCells)
+	{
+		cell.clear();
+	}
+	mSize = 0;
+}
+
+void SpatialGrid::Insert(en::U32 index, const en::Vector2f& position)
+{
+	mCells[GetCellIndex(position)].push_back(index);
+	mSize++;
+}
+
+void SpatialGrid::Move(en::U32 index, const en::Vector2f& oldPosition, const en::Vector2f& newPosition)
+{
+	const en::U32 oldCell = GetCellIndex(oldPosition);
+	const en::U32 newCell = GetCellIndex(newPosition);
+	if (oldCell != newCell)
+	{
+		std::vector<en::U32>& cell = mCells[oldCell];
+		const auto itr = std::find(cell.begin(), cell.end(), index);
+		if (itr != cell.end())
+		{
+			*itr = cell.back();
+			cell.pop_back();
+			mCells[newCell].push_back(index);
+		}
+	}
+}
+
+void SpatialGrid::Remove(en::U32 index, const en::Vector2f& position)
+{
+	std::vector<en::U32>& cell = mCells[GetCellIndex(position)];
+	const auto itr = std::find(cell.begin(), cell.end(), index);
+	if (itr != cell.end())
+	{
+		*itr = cell.back();
+		cell.pop_back();
+		mSize--;
+	}
+}
+
+void SpatialGrid::Reindex(en::U32 index, en::U32 newIndex, const en::Vector2f& position)
+{
+	std::vector<en::U32>& cell = mCells[GetCellIndex(position)];
+	const auto itr = std::find(cell.begin(), cell.end(), index);
+	if (itr != cell.end())
+	{
+		*itr = newIndex;
+	}
+}
+
+en::I32 SpatialGrid::GetCellX(en::F32 x) const
+{
+	const en::I32 cellX = static_cast<en::I32>(en::Math::Floor(x * mInvCellSize));
+	return en::Math::Max(en::Math::Min(cellX, static_cast<en::I32>(mCellCountX) - 1), 0);
+}
+
+en::I32 SpatialGrid::GetCellY(en::F32 y) const
+{
+	const en::I32 cellY = static_cast<en::I32>(en::Math::Floor(y * mInvCellSize));
+	return en::Math::Max(en::Math::Min(cellY, static_cast<en::I32>(mCellCountY) - 1), 0);
+}
+
+en::U32 SpatialGrid::GetCellIndex(const en::Vector2f& position) const
+{
+	return static_cast<en::U32>(GetCellX(position.x)) + static_cast<en::U32>(GetCellY(position.y)) * mCellCountX;
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <Enlivengine/System/PrimitiveTypes.hpp>
+#include <Enlivengine/Math/Vector2.hpp>
+#include <vector>
+
+// Uniform grid bucketing entity indices by position
+// Positions outside of the grid are clamped to the border cells, so queries stay correct for them
+// Queries only return candidates, the caller still has to check the real distance
+class SpatialGrid
+{
+public:
+	SpatialGrid();
+
+	void Initialize(const en::Vector2f& worldSize, en::F32 cellSize);
+
+	void Clear();
+	void Insert(en::U32 index, const en::Vector2f& position);
+	void Move(en::U32 index, const en::Vector2f& oldPosition, const en::Vector2f& newPosition);
+	void Remove(en::U32 index, const en::Vector2f& position);
+	// The index stored at position becomes newIndex, for swap-and-pop removals
+	void Reindex(en::U32 index, en::U32 newIndex, const en::Vector2f& position);
+
+	// Call func(index) for each index stored in a cell overlapping the circle
+	template <typename F>
+	void Query(const en::Vector2f& position, en::F32 radius, F&& func) const;
+
+	// Search cells ring by ring around position and return the index with the smallest distanceSqr(index)
+	// distanceSqr must return a negative value to reject an index
+	// Returns -1 if nothing has been found in the whole grid
+	template <typename F>
+	en::I32 QueryNearest(const en::Vector2f& position, F&& distanceSqr) const;
+
+	en::U32 GetCellCountX() const { return mCellCountX; }
+	en::U32 GetCellCountY() const { return mCellCountY; }
+	en::F32 GetCellSize() const { return mCellSize; }
+	en::U32 GetSize() const { return mSize; }
+
+private:
+	en::I32 GetCellX(en::F32 x) const;
+	en::I32 GetCellY(en::F32 y) const;
+	en::U32 GetCellIndex(const en::Vector2f& position) const;
+
+private:
+	std::vector<std::vector<en::U32>> mCells;
+	en::U32 mCellCountX;
+	en::U32 mCellCountY;
+	en::F32 mCellSize;
+	en::F32 mInvCellSize;
+	en::U32 mSize;
+};
+
+template <typename F>
+void SpatialGrid::Query(const en::Vector2f& position, en::F32 radius, F&& func) const
+{
+	const en::I32 minX = GetCellX(position.x - radius);
+	const en::I32 maxX = GetCellX(position.x + radius);
+	const en::I32 minY = GetCellY(position.y - radius);
+	const en::I32 maxY = GetCellY(position.y + radius);
+	for (en::I32 y = minY; y <= maxY; ++y)
+	{
+		for (en::I32 x = minX; x <= maxX; ++x)
+		{
+			const std::vector<en::U32>& cell = mCells[static_cast<en::U32>(x) + static_cast<en::U32>(y) * mCellCountX];
+			for (const en::U32 index : cell)
+			{
+				func(index);
+			}
+		}
+	}
+}
+
+template <typename F>
+en::I32 SpatialGrid::QueryNearest(const en::Vector2f& position, F&& distanceSqr) const
+{
+	en::I32 bestIndex = -1;
+	en::F32 bestDistanceSqr = 0.0f;
+	if (mSize == 0)
+	{
+		return bestIndex;
+	}
+
+	const en::I32 centerX = GetCellX(position.x);
+	const en::I32 centerY = GetCellY(position.y);
+	const en::I32 maxRing = static_cast<en::I32>(en::Math::Max(mCellCountX, mCellCountY));
+	for (en::I32 ring = 0; ring <= maxRing; ++ring)
+	{
+		const en::I32 minX = centerX - ring;
+		const en::I32 maxX = centerX + ring;
+		const en::I32 minY = centerY - ring;
+		const en::I32 maxY = centerY + ring;
+		for (en::I32 y = minY; y <= maxY; ++y)
+		{
+			if (y < 0 || y >= static_cast<en::I32>(mCellCountY))
+			{
+				continue;
+			}
+			// Only the border of the ring, inner cells have been visited already
+			const en::I32 step = (y == minY || y == maxY) ? 1 : (maxX - minX);
+			for (en::I32 x = minX; x <= maxX; x += en::Math::Max(step, 1))
+			{
+				if (x < 0 || x >= static_cast<en::I32>(mCellCountX))
+				{
+					continue;
+				}
+				const std::vector<en::U32>& cell = mCells[static_cast<en::U32>(x) + static_cast<en::U32>(y) * mCellCountX];
+				for (const en::U32 index : cell)
+				{
+					const en::F32 dSqr = distanceSqr(index);
+					if (dSqr >= 0.0f && (bestIndex < 0 || dSqr < bestDistanceSqr))
+					{
+						bestDistanceSqr = dSqr;
+						bestIndex = static_cast<en::I32>(index);
+					}
+				}
+			}
+		}
+
+		// Cells of the next ring are at least ring * cellSize away from position
+		if (bestIndex >= 0)
+		{
+			const en::F32 ringDistance = static_cast<en::F32>(ring) * mCellSize;
+			if (bestDistanceSqr <= ringDistance * ringDistance)
+			{
+				break;
+			}
+		}
+	}
+	return bestIndex;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Replaces the global operator new/delete to count every heap allocation of the program
+// Include it in exactly one source file of a benchmark or test executable
+
+// Atomic : the network thread of the server runs meanwhile
+static std::atomic<std::size_t> gAllocationCount(0);
+
+inline std::size_t GetAllocationCount()
+{
+	return gAllocationCount.load();
+}
+
+void* operator new(std::size_t size)
+{
+	gAllocationCount++;
+	if (void* ptr = std::malloc(size > 0 ? size : 1))
+	{
+		return ptr;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+	std::free(ptr);
+}
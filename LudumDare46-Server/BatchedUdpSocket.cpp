@@ -0,0 +1,154 @@
+#include "BatchedUdpSocket.hpp"
+
+#include <cstring>
+
+#ifdef ENLIVE_PLATFORM_LINUX
+#include <arpa/inet.h>
+#endif
+
+BatchedUdpSocket::BatchedUdpSocket()
+	: sf::UdpSocket()
+	, mSystemBatchEnabled(IsSystemBatchSupported())
+	, mSystemCallCount(0)
+{
+#ifdef ENLIVE_PLATFORM_LINUX
+	std::memset(mHeaders, 0, sizeof(mHeaders));
+	std::memset(mBuffers, 0, sizeof(mBuffers));
+	std::memset(mAddresses, 0, sizeof(mAddresses));
+#endif
+}
+
+bool BatchedUdpSocket::IsSystemBatchSupported()
+{
+#ifdef ENLIVE_PLATFORM_LINUX
+	return true;
+#else
+	return false;
+#endif
+}
+
+en::U32 BatchedUdpSocket::ReceiveBatch(ReceivedDatagram* datagrams, en::U32 count)
+{
+	if (!mSystemBatchEnabled)
+	{
+		return ReceiveOneByOne(datagrams, count);
+	}
+
+#ifdef ENLIVE_PLATFORM_LINUX
+	en::U32 received = 0;
+	while (received < count)
+	{
+		const en::U32 batchSize = ((count - received) < DefaultNetworkBatchSize) ? (count - received) : DefaultNetworkBatchSize;
+		for (en::U32 i = 0; i < batchSize; ++i)
+		{
+			mBuffers[i].iov_base = datagrams[received + i].data;
+			mBuffers[i].iov_len = sizeof(datagrams[received + i].data);
+			mHeaders[i].msg_hdr.msg_iov = &mBuffers[i];
+			mHeaders[i].msg_hdr.msg_iovlen = 1;
+			mHeaders[i].msg_hdr.msg_name = &mAddresses[i];
+			mHeaders[i].msg_hdr.msg_namelen = sizeof(mAddresses[i]);
+			mHeaders[i].msg_hdr.msg_control = nullptr;
+			mHeaders[i].msg_hdr.msg_controllen = 0;
+			mHeaders[i].msg_hdr.msg_flags = 0;
+			mHeaders[i].msg_len = 0;
+		}
+
+		const int result = recvmmsg(getHandle(), mHeaders, batchSize, MSG_DONTWAIT, nullptr);
+		mSystemCallCount++;
+		if (result <= 0)
+		{
+			// EAGAIN : nothing left
+			break;
+		}
+
+		for (en::U32 i = 0; i < static_cast<en::U32>(result); ++i)
+		{
+			ReceivedDatagram& datagram = datagrams[received + i];
+			datagram.size = mHeaders[i].msg_len;
+			datagram.remoteAddress = sf::IpAddress(ntohl(mAddresses[i].sin_addr.s_addr));
+			datagram.remotePort = ntohs(mAddresses[i].sin_port);
+		}
+		received += static_cast<en::U32>(result);
+		if (static_cast<en::U32>(result) < batchSize)
+		{
+			break;
+		}
+	}
+	return received;
+#else
+	return ReceiveOneByOne(datagrams, count);
+#endif
+}
+
+void BatchedUdpSocket::SendBatch(const SentDatagram* datagrams, en::U32 count)
+{
+	if (!mSystemBatchEnabled)
+	{
+		SendOneByOne(datagrams, count);
+		return;
+	}
+
+#ifdef ENLIVE_PLATFORM_LINUX
+	en::U32 sent = 0;
+	while (sent < count)
+	{
+		const en::U32 batchSize = ((count - sent) < DefaultNetworkBatchSize) ? (count - sent) : DefaultNetworkBatchSize;
+		for (en::U32 i = 0; i < batchSize; ++i)
+		{
+			const SentDatagram& datagram = datagrams[sent + i];
+			mAddresses[i].sin_family = AF_INET;
+			mAddresses[i].sin_addr.s_addr = htonl(datagram.remoteAddress.toInteger());
+			mAddresses[i].sin_port = htons(datagram.remotePort);
+			mBuffers[i].iov_base = const_cast<char*>(datagram.data.data());
+			mBuffers[i].iov_len = datagram.data.size();
+			mHeaders[i].msg_hdr.msg_iov = &mBuffers[i];
+			mHeaders[i].msg_hdr.msg_iovlen = 1;
+			mHeaders[i].msg_hdr.msg_name = &mAddresses[i];
+			mHeaders[i].msg_hdr.msg_namelen = sizeof(mAddresses[i]);
+			mHeaders[i].msg_hdr.msg_control = nullptr;
+			mHeaders[i].msg_hdr.msg_controllen = 0;
+			mHeaders[i].msg_hdr.msg_flags = 0;
+			mHeaders[i].msg_len = 0;
+		}
+
+		const int result = sendmmsg(getHandle(), mHeaders, batchSize, MSG_DONTWAIT);
+		mSystemCallCount++;
+		if (result < 0)
+		{
+			// The first datagram failed (full buffer, unreachable...), drop it and keep going with the others
+			sent++;
+		}
+		else
+		{
+			sent += static_cast<en::U32>(result);
+		}
+	}
+#else
+	SendOneByOne(datagrams, count);
+#endif
+}
+
+en::U32 BatchedUdpSocket::ReceiveOneByOne(ReceivedDatagram* datagrams, en::U32 count)
+{
+	en::U32 received = 0;
+	while (received < count)
+	{
+		ReceivedDatagram& datagram = datagrams[received];
+		mSystemCallCount++;
+		if (receive(datagram.data, sizeof(datagram.data), datagram.size, datagram.remoteAddress, datagram.remotePort) != sf::Socket::Done)
+		{
+			break;
+		}
+		received++;
+	}
+	return received;
+}
+
+void BatchedUdpSocket::SendOneByOne(const SentDatagram* datagrams, en::U32 count)
+{
+	for (en::U32 i = 0; i < count; ++i)
+	{
+		mSystemCallCount++;
+		send(datagrams[i].data.data(), datagrams[i].data.size(), datagrams[i].remoteAddress, datagrams[i].remotePort);
+	}
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <SFML/Network.hpp>
+#include <Common.hpp>
+
+#include <Enlivengine/System/PlatformDetection.hpp>
+#include <Enlivengine/System/PrimitiveTypes.hpp>
+
+#include <vector>
+
+#ifdef ENLIVE_PLATFORM_LINUX
+#include <netinet/in.h>
+#include <sys/socket.h>
+#endif
+
+struct ReceivedDatagram
+{
+	char data[DefaultMaxDatagramSize];
+	std::size_t size;
+	sf::IpAddress remoteAddress;
+	en::U16 remotePort;
+};
+
+struct SentDatagram
+{
+	std::vector<char> data;
+	sf::IpAddress remoteAddress;
+	en::U16 remotePort;
+};
+
+// Non-blocking UDP socket moving several datagrams per call
+// On Linux, one recvmmsg/sendmmsg moves up to DefaultNetworkBatchSize datagrams, elsewhere it loops on the SFML calls
+class BatchedUdpSocket : public sf::UdpSocket
+{
+public:
+	BatchedUdpSocket();
+
+	// Receive until count datagrams or nothing left to receive, returns the number received
+	en::U32 ReceiveBatch(ReceivedDatagram* datagrams, en::U32 count);
+
+	// Send the count datagrams, the ones the socket can't take are dropped like sf::UdpSocket::send would
+	void SendBatch(const SentDatagram* datagrams, en::U32 count);
+
+	// The SFML calls are used when disabled, to compare both
+	void SetSystemBatchEnabled(bool enabled) { mSystemBatchEnabled = enabled && IsSystemBatchSupported(); }
+	bool IsSystemBatchEnabled() const { return mSystemBatchEnabled; }
+	static bool IsSystemBatchSupported();
+
+	// Receive and send calls made so far, including the ones that moved nothing
+	en::U64 GetSystemCallCount() const { return mSystemCallCount; }
+
+private:
+	en::U32 ReceiveOneByOne(ReceivedDatagram* datagrams, en::U32 count);
+	void SendOneByOne(const SentDatagram* datagrams, en::U32 count);
+
+private:
+	bool mSystemBatchEnabled;
+	en::U64 mSystemCallCount;
+
+#ifdef ENLIVE_PLATFORM_LINUX
+	// Preallocated, pointed to by the headers on each call
+	mmsghdr mHeaders[DefaultNetworkBatchSize];
+	iovec mBuffers[DefaultNetworkBatchSize];
+	sockaddr_in mAddresses[DefaultNetworkBatchSize];
+#endif
+};
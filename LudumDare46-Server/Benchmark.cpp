@@ -0,0 +1,821 @@
+#include "RoomManager.hpp"
+#include "Server.hpp"
+
+#include <Enlivengine/System/Time.hpp>
+
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Headless benchmarks : the socket is never started, so the Server doesn't send anything
+// Except BenchmarkTicks, which needs the send path
+
+// Simulation only, with AI players
+void BenchmarkSimulation()
+{
+	const en::U32 chickenCounts[] = { 16, 32, 64, 128, 256, 512, 1000 };
+	const en::U32 warmupSteps = 60;
+	const en::U32 measuredSteps = 600;
+
+	std::printf("Simulation\n");
+	std::printf("Steps : %u (+%u warmup)\n", measuredSteps, warmupSteps);
+	for (const en::U32 chickenCount : chickenCounts)
+	{
+		Server server;
+		for (en::U32 i = 0; i < chickenCount; ++i)
+		{
+			server.AddAIPlayer("Bot" + std::to_string(i));
+		}
+
+		for (en::U32 i = 0; i < warmupSteps; ++i)
+		{
+			server.UpdateLogic(DefaultStepInterval);
+		}
+
+		en::Clock clock;
+		for (en::U32 i = 0; i < measuredSteps; ++i)
+		{
+			server.UpdateLogic(DefaultStepInterval);
+		}
+		const en::Time elapsed = clock.getElapsedTime();
+
+		std::printf("%5u chickens : %8.4f ms/step\n", chickenCount, elapsed.asSeconds() * 1000.0f / static_cast<en::F32>(measuredSteps));
+	}
+}
+
+struct RecordedPacket
+{
+	std::vector<char> data;
+	sf::IpAddress remoteAddress;
+	en::U16 remotePort;
+};
+
+void RecordPacket(std::vector<RecordedPacket>& stream, const sf::Packet& packet, const sf::IpAddress& remoteAddress, en::U16 remotePort)
+{
+	RecordedPacket recorded;
+	const char* data = static_cast<const char*>(packet.getData());
+	recorded.data.assign(data, data + packet.getDataSize());
+	recorded.remoteAddress = remoteAddress;
+	recorded.remotePort = remotePort;
+	stream.push_back(recorded);
+}
+
+void ReplayPackets(Server& server, const std::vector<RecordedPacket>& stream)
+{
+	sf::Packet packet;
+	for (const RecordedPacket& recorded : stream)
+	{
+		packet.clear();
+		packet.append(recorded.data.data(), recorded.data.size());
+		server.HandlePacket(packet, recorded.remoteAddress, recorded.remotePort);
+	}
+}
+
+// Packet handling only, with a stream recorded from many clients : join, then Ping/Pong/DropSeed from each client in turn
+void BenchmarkPacketReplay()
+{
+	const en::U32 clientCounts[] = { 16, 64, 256, 1000 };
+	const en::U32 rounds = 100;
+
+	std::printf("Packet replay\n");
+	std::printf("Rounds : %u (Ping + Pong + DropSeed per client per round)\n", rounds);
+	for (const en::U32 clientCount : clientCounts)
+	{
+		std::vector<sf::IpAddress> addresses;
+		std::vector<en::U16> ports;
+		std::vector<RecordedPacket> joinStream;
+		for (en::U32 i = 0; i < clientCount; ++i)
+		{
+			addresses.push_back(sf::IpAddress(10, 0, static_cast<en::U8>(i / 250), static_cast<en::U8>(i % 250 + 1)));
+			ports.push_back(static_cast<en::U16>(50000 + i));
+
+			sf::Packet packet;
+			packet << static_cast<en::U8>(ClientPacketID::Join) << std::string("Client" + std::to_string(i));
+			RecordPacket(joinStream, packet, addresses[i], ports[i]);
+		}
+
+		std::vector<RecordedPacket> stream;
+		for (en::U32 round = 0; round < rounds; ++round)
+		{
+			for (en::U32 i = 0; i < clientCount; ++i)
+			{
+				sf::Packet ping;
+				ping << static_cast<en::U8>(ClientPacketID::Ping);
+				RecordPacket(stream, ping, addresses[i], ports[i]);
+
+				sf::Packet pong;
+				pong << static_cast<en::U8>(ClientPacketID::Pong);
+				RecordPacket(stream, pong, addresses[i], ports[i]);
+
+				sf::Packet dropSeed;
+				dropSeed << static_cast<en::U8>(ClientPacketID::DropSeed) << Server::GenerateClientID(addresses[i], ports[i]);
+				dropSeed << 100.0f + static_cast<en::F32>((i * 37 + round * 11) % 3000) << 100.0f + static_cast<en::F32>((i * 53 + round * 7) % 2000);
+				RecordPacket(stream, dropSeed, addresses[i], ports[i]);
+			}
+		}
+
+		Server server;
+		server.SetMaxPlayers(clientCount);
+		ReplayPackets(server, joinStream);
+
+		en::Clock clock;
+		ReplayPackets(server, stream);
+		const en::Time elapsed = clock.getElapsedTime();
+
+		std::printf("%5u clients : %8.1f ns/packet (%u players joined)\n", clientCount, elapsed.asSeconds() * 1e9f / static_cast<en::F32>(stream.size()), server.GetPlayerCount());
+	}
+}
+
+template <typename T>
+void BenchmarkEncoding(const char* name, const std::vector<T>& values)
+{
+	const en::U32 repeats = 100;
+
+	sf::Packet packet;
+	en::Clock packetClock;
+	for (en::U32 r = 0; r < repeats; ++r)
+	{
+		packet.clear();
+		for (const T& value : values)
+		{
+			packet << value;
+		}
+	}
+	const en::Time packetElapsed = packetClock.getElapsedTime();
+
+	en::BitWriter writer;
+	en::Clock writerClock;
+	for (en::U32 r = 0; r < repeats; ++r)
+	{
+		writer.Clear();
+		for (const T& value : values)
+		{
+			writer << value;
+		}
+	}
+	const en::Time writerElapsed = writerClock.getElapsedTime();
+
+	const en::F32 count = static_cast<en::F32>(values.size());
+	const en::F32 packetBytes = static_cast<en::F32>(packet.getDataSize()) / count;
+	const en::F32 writerBytes = static_cast<en::F32>(writer.GetByteCount()) / count;
+	std::printf("%-8s : %5.1f -> %5.1f bytes (%3.0f%%), %5.1f -> %5.1f ns to write\n", name, packetBytes, writerBytes, 100.0f * writerBytes / packetBytes,
+		packetElapsed.asSeconds() * 1e9f / (count * repeats), writerElapsed.asSeconds() * 1e9f / (count * repeats));
+}
+
+// Bytes per value, sf::Packet encoding against the bit-packed one used by the snapshots
+void BenchmarkEncodings()
+{
+	const en::U32 count = 1000;
+
+	en::RandomEngine random;
+	random.setSeed(42);
+	const auto randomPosition = [&random]()
+	{
+		return en::Vector2f(random.get<en::F32>(0.0f, DefaultMapSizeX), random.get<en::F32>(0.0f, DefaultMapSizeY));
+	};
+
+	std::vector<Chicken> chickens(count);
+	std::vector<Seed> seeds(count);
+	std::vector<Item> items(count);
+	std::vector<Bullet> bullets(count);
+	for (en::U32 i = 0; i < count; ++i)
+	{
+		Chicken& chicken = chickens[i];
+		chicken.position = randomPosition();
+		chicken.rotation = random.get<en::F32>(0.0f, 360.0f);
+		chicken.itemID = static_cast<ItemID>(random.get<en::U32>(0, static_cast<en::U32>(ItemID::Count) - 1));
+		chicken.kills = random.get<en::U32>(0, 20);
+		chicken.lifeMax = DefaultChickenLife;
+		chicken.life = random.get<en::F32>(0.0f, DefaultChickenLife);
+		chicken.speed = DefaultChickenSpeed;
+		chicken.attack = DefaultChickenAttack;
+
+		Seed& seed = seeds[i];
+		seed.seedUID = 1 + i * 7;
+		seed.position = randomPosition();
+		seed.clientID = random.get<en::U32>(0, en::U32_Max);
+		seed.remainingTime = en::seconds(random.get<en::F32>(0.0f, DefaultSeedLifetime.asSeconds()));
+
+		Item& item = items[i];
+		item.itemUID = 1 + i * 13;
+		item.itemID = GetRandomAttackItem(random);
+		item.position = randomPosition();
+
+		Bullet& bullet = bullets[i];
+		bullet.bulletUID = 1 + i * 5;
+		bullet.position = randomPosition();
+		bullet.rotation = random.get<en::F32>(0.0f, 360.0f);
+		bullet.clientID = random.get<en::U32>(0, en::U32_Max);
+		bullet.itemID = GetRandomAttackItem(random);
+		bullet.remainingDistance = random.get<en::F32>(0.0f, DefaultItemRange);
+	}
+
+	std::printf("Encodings\n");
+	std::printf("Values : %u of each\n", count);
+	BenchmarkEncoding("Chicken", chickens);
+	BenchmarkEncoding("Seed", seeds);
+	BenchmarkEncoding("Item", items);
+	BenchmarkEncoding("Bullet", bullets);
+}
+
+// Snapshot bytes per client per tick, whole world against the view around each client, on a synthetic world
+// Each client decodes its views against its own buffer, like GameSingleton, and must get what the server built
+void BenchmarkInterest()
+{
+	const en::U32 chickenCounts[] = { 16, 64, 256 };
+	const en::U32 tickCount = 200;
+	const en::F32 moveDistance = DefaultChickenSpeed * DefaultTickInterval.asSeconds();
+
+	std::printf("Interest\n");
+	for (en::U32 chickenCount : chickenCounts)
+	{
+		en::RandomEngine random;
+		random.setSeed(42);
+		const auto randomPosition = [&random]()
+		{
+			return en::Vector2f(random.get<en::F32>(DefaultMapBorder, DefaultMapSizeX - DefaultMapBorder), random.get<en::F32>(DefaultMapBorder, DefaultMapSizeY - DefaultMapBorder));
+		};
+
+		std::vector<SnapshotChicken> chickens(chickenCount);
+		for (en::U32 i = 0; i < chickenCount; ++i)
+		{
+			chickens[i].clientID = 1 + i * 3;
+			chickens[i].chicken.position = randomPosition();
+			chickens[i].chicken.rotation = 0.0f;
+			chickens[i].chicken.itemID = ItemID::None;
+			chickens[i].chicken.kills = 0;
+			chickens[i].chicken.lifeMax = DefaultChickenLife;
+			chickens[i].chicken.life = DefaultChickenLife;
+			chickens[i].chicken.speed = DefaultChickenSpeed;
+			chickens[i].chicken.attack = DefaultChickenAttack;
+		}
+
+		SnapshotBuffer snapshots;
+		std::vector<SnapshotBuffer> clientSnapshots(chickenCount);
+		Snapshot baselineView;
+		Snapshot currentView;
+		en::BitWriter writer;
+		std::size_t worldBytes = 0;
+		std::size_t viewBytes = 0;
+		en::U32 mismatches = 0;
+		en::U32 nextUID = 1;
+		for (en::U32 sequence = 1; sequence <= tickCount; ++sequence)
+		{
+			Snapshot& snapshot = snapshots.Push(sequence);
+			for (SnapshotChicken& chicken : chickens)
+			{
+				chicken.chicken.rotation = en::Math::AngleMagnitude(chicken.chicken.rotation + random.get<en::F32>(-20.0f, 20.0f));
+				chicken.chicken.position += en::Vector2f::polar(chicken.chicken.rotation) * moveDistance;
+				snapshot.chickens.push_back(chicken);
+				snapshot.scores.push_back({ chicken.clientID, chicken.chicken.kills });
+
+				// A bullet from each chicken sometimes
+				if (random.get<en::U32>(0, 9) == 0)
+				{
+					Bullet bullet;
+					bullet.bulletUID = nextUID++;
+					bullet.position = chicken.chicken.position;
+					bullet.rotation = chicken.chicken.rotation;
+					bullet.clientID = chicken.clientID;
+					bullet.itemID = ItemID::Shuriken;
+					bullet.remainingDistance = DefaultItemRange;
+					snapshot.bullets.push_back(bullet);
+				}
+			}
+			snapshot.Sort();
+
+			// Clients acknowledge with some lag, so the views of older baselines are rebuilt too
+			for (en::U32 i = 0; i < chickenCount; ++i)
+			{
+				const en::U32 lag = 1 + (i + sequence) % 4;
+				const en::U32 ackedSequence = (sequence > lag) ? sequence - lag : 0;
+				const Snapshot* baseline = snapshots.Get(ackedSequence);
+
+				writer.Clear();
+				WriteSnapshotDelta(writer, *baseline, snapshot, snapshots);
+				worldBytes += writer.GetByteCount();
+
+				BuildSnapshotView(*baseline, snapshots, chickens[i].clientID, baselineView);
+				BuildSnapshotView(snapshot, snapshots, chickens[i].clientID, currentView);
+				writer.Clear();
+				WriteSnapshotDelta(writer, baselineView, currentView, snapshots, chickens[i].clientID);
+				viewBytes += writer.GetByteCount();
+
+				const Snapshot* clientBaseline = clientSnapshots[i].Get(ackedSequence);
+				Snapshot& decoded = clientSnapshots[i].Push(sequence);
+				en::BitReader reader(writer.GetData(), writer.GetByteCount());
+				if (clientBaseline == nullptr || !ReadSnapshotDelta(reader, *clientBaseline, decoded) || decoded.chickens.size() != currentView.chickens.size() || decoded.scores.size() != currentView.scores.size() || decoded.bullets.size() != currentView.bullets.size())
+				{
+					mismatches++;
+				}
+			}
+		}
+
+		const en::F32 messages = static_cast<en::F32>(chickenCount * tickCount);
+		const en::F32 worldAverage = static_cast<en::F32>(worldBytes) / messages;
+		const en::F32 viewAverage = static_cast<en::F32>(viewBytes) / messages;
+		std::printf("%4u chickens : %8.1f -> %7.1f bytes/client/tick (%3.0f%%), %u mismatches\n", chickenCount, worldAverage, viewAverage, 100.0f * viewAverage / worldAverage, mismatches);
+	}
+}
+
+// Two ReliableEndpoints over a simulated link losing, delaying and reordering datagrams both ways
+// Returns false if a message is lost or delivered out of order
+bool BenchmarkReliable()
+{
+	const en::F32 lossRates[] = { 0.0f, 0.1f, 0.3f };
+	const en::U32 sendSteps = 3000;
+	const en::U32 maxSteps = sendSteps + 3000;
+	const en::Time latency = en::milliseconds(50);
+	const en::Time jitter = en::milliseconds(30);
+
+	struct InFlightDatagram
+	{
+		std::vector<char> data; // Without the packet ID
+		en::Time arrivalTime;
+		bool toServer;
+	};
+
+	std::printf("Reliable\n");
+	std::printf("Steps : %u, latency %dms +-%dms, a message every other step on each channel\n", sendSteps, static_cast<int>(latency.asMilliseconds()), static_cast<int>(jitter.asMilliseconds()));
+	bool success = true;
+	for (en::F32 lossRate : lossRates)
+	{
+		en::RandomEngine random;
+		random.setSeed(42);
+		ReliableEndpoint client;
+		ReliableEndpoint server;
+		std::vector<InFlightDatagram> link;
+		sf::Packet packet;
+		sf::Packet message;
+
+		constexpr en::U32 channelCount = static_cast<en::U32>(ReliableChannelID::Count);
+		en::U32 sentCount[channelCount] = {};
+		en::U32 receivedCount[channelCount] = {};
+		std::vector<en::Time> sendTimes;
+		en::U32 outOfOrder = 0;
+		en::U32 datagrams = 0;
+		en::Time totalDelay = en::Time::Zero;
+
+		const auto sendDatagram = [&](ReliableEndpoint& endpoint, en::Time now, bool toServer)
+		{
+			packet.clear();
+			packet << static_cast<en::U8>(0);
+			if (endpoint.WritePacket(packet, now))
+			{
+				datagrams++;
+				if (random.get<en::F32>(0.0f, 1.0f) >= lossRate)
+				{
+					const char* data = static_cast<const char*>(packet.getData());
+					InFlightDatagram datagram;
+					datagram.data.assign(data + 1, data + packet.getDataSize());
+					datagram.arrivalTime = now + latency + jitter * random.get<en::F32>(-1.0f, 1.0f);
+					datagram.toServer = toServer;
+					link.push_back(std::move(datagram));
+				}
+			}
+		};
+
+		en::U32 step = 0;
+		en::Time now = en::Time::Zero;
+		const en::U32 expectedCount = channelCount * (sendSteps / 2);
+		for (; step < maxSteps; ++step)
+		{
+			now += DefaultStepInterval;
+
+			// Client -> server messages : channel and index, to check the order
+			if (step < sendSteps && step % 2 == 0)
+			{
+				for (en::U32 c = 0; c < channelCount; ++c)
+				{
+					packet.clear();
+					packet << static_cast<en::U8>(c) << sentCount[c]++;
+					client.Send(packet.getData(), packet.getDataSize(), static_cast<ReliableChannelID>(c));
+					if (c == 0)
+					{
+						sendTimes.push_back(now);
+					}
+				}
+			}
+			sendDatagram(client, now, true);
+			sendDatagram(server, now, false);
+
+			for (std::size_t i = 0; i < link.size(); )
+			{
+				if (link[i].arrivalTime <= now)
+				{
+					ReliableEndpoint& endpoint = link[i].toServer ? server : client;
+					endpoint.ReadPacket(link[i].data.data(), link[i].data.size(), now);
+					link[i] = std::move(link.back());
+					link.pop_back();
+				}
+				else
+				{
+					++i;
+				}
+			}
+
+			while (server.PollMessage(message))
+			{
+				en::U8 channel;
+				en::U32 index;
+				message >> channel >> index;
+				if (channel >= channelCount || index != receivedCount[channel])
+				{
+					outOfOrder++;
+				}
+				else
+				{
+					if (channel == 0)
+					{
+						totalDelay += now - sendTimes[index];
+					}
+					receivedCount[channel]++;
+				}
+			}
+
+			if (step >= sendSteps && receivedCount[0] + receivedCount[1] == expectedCount && client.GetQueuedCount(ReliableChannelID::Session) == 0 && client.GetQueuedCount(ReliableChannelID::Gameplay) == 0)
+			{
+				break;
+			}
+		}
+
+		const en::U32 delivered = receivedCount[0] + receivedCount[1];
+		const bool ok = delivered == expectedCount && outOfOrder == 0;
+		success = success && ok;
+		std::printf("%3.0f%% loss : %u/%u delivered, %u out of order, %.3f resends/message, %.1fms average delay, %u datagrams, done in %u steps : %s\n",
+			lossRate * 100.0f, delivered, expectedCount, outOfOrder, static_cast<en::F32>(client.GetResendCount()) / expectedCount,
+			(receivedCount[0] > 0) ? 1000.0f * totalDelay.asSeconds() / static_cast<en::F32>(receivedCount[0]) : 0.0f, datagrams, step, ok ? "OK" : "FAILED");
+	}
+	return success;
+}
+
+// Steady state server ticks over a running socket
+// That they don't allocate is checked by the LudumDare46Tests
+void BenchmarkTicks()
+{
+	const en::U32 clientCount = 32;
+	const en::U32 aiCount = 32;
+	const en::U32 warmupTicks = 2400;
+	const en::U32 measuredTicks = 600;
+	const en::U32 stepsPerTick = static_cast<en::U32>(DefaultTickInterval.asSeconds() / DefaultStepInterval.asSeconds() + 0.5f);
+
+	std::printf("Steady state\n");
+	std::printf("Ticks : %u (+%u warmup), %u clients, %u AI\n", measuredTicks, warmupTicks, clientCount, aiCount);
+
+	// Same simulation every run, recording metrics as a room does
+	en::MetricsRegistry metricsRegistry;
+	ServerMetrics metrics(metricsRegistry);
+	Server server;
+	server.SetRandomSeed(42);
+	server.SetMetrics(&metrics);
+	char programName[] = "Benchmark";
+	char anyPort[] = "0";
+	char* argv[] = { programName, anyPort };
+	if (!server.Start(2, argv))
+	{
+		std::printf("Can't start the socket, skipped\n");
+		return;
+	}
+	server.SetMaxPlayers(clientCount + aiCount + 1);
+	for (en::U32 i = 0; i < aiCount; ++i)
+	{
+		server.AddAIPlayer("Bot" + std::to_string(i));
+	}
+
+	const sf::IpAddress address = sf::IpAddress::LocalHost;
+	sf::Packet packet;
+	for (en::U32 i = 0; i < clientCount; ++i)
+	{
+		packet.clear();
+		packet << static_cast<en::U8>(ClientPacketID::Join) << std::string("Client" + std::to_string(i));
+		server.HandlePacket(packet, address, static_cast<en::U16>(40000 + i));
+	}
+
+	// What the clients send every tick : Ping, SnapshotAck and sometimes DropSeed
+	en::U32 sequence = 0;
+	const auto runTick = [&](en::U32 tick)
+	{
+		for (en::U32 i = 0; i < clientCount; ++i)
+		{
+			const en::U16 port = static_cast<en::U16>(40000 + i);
+			packet.clear();
+			packet << static_cast<en::U8>(ClientPacketID::Ping);
+			server.HandlePacket(packet, address, port);
+
+			packet.clear();
+			packet << static_cast<en::U8>(ClientPacketID::SnapshotAck) << sequence;
+			server.HandlePacket(packet, address, port);
+
+			if ((tick + i) % 4 == 0)
+			{
+				packet.clear();
+				packet << static_cast<en::U8>(ClientPacketID::DropSeed) << Server::GenerateClientID(address, port);
+				packet << 100.0f + static_cast<en::F32>((i * 37 + tick * 11) % 3000) << 100.0f + static_cast<en::F32>((i * 53 + tick * 7) % 2000);
+				server.HandlePacket(packet, address, port);
+			}
+		}
+		server.Simulate(stepsPerTick, 1);
+		sequence++;
+	};
+
+	for (en::U32 tick = 0; tick < warmupTicks; ++tick)
+	{
+		runTick(tick);
+	}
+
+	metrics.stepDuration.Reset();
+	metrics.tickDuration.Reset();
+	for (en::U32 tick = warmupTicks; tick < warmupTicks + measuredTicks; ++tick)
+	{
+		runTick(tick);
+	}
+
+	server.Stop();
+
+	std::printf("Step : p50 %lluus, p99 %lluus, max %lluus\n", static_cast<unsigned long long>(metrics.stepDuration.GetValueAtPercentile(50.0)),
+		static_cast<unsigned long long>(metrics.stepDuration.GetValueAtPercentile(99.0)), static_cast<unsigned long long>(metrics.stepDuration.GetMax()));
+	std::printf("Tick : p50 %lluus, p99 %lluus, max %lluus\n", static_cast<unsigned long long>(metrics.tickDuration.GetValueAtPercentile(50.0)),
+		static_cast<unsigned long long>(metrics.tickDuration.GetValueAtPercentile(99.0)), static_cast<unsigned long long>(metrics.tickDuration.GetMax()));
+	std::printf("%u players\n", server.GetPlayerCount());
+}
+
+// Clients joining a crowded server at once, each one gets the players already there
+void BenchmarkJoinBurst()
+{
+	const en::U32 aiCount = 128;
+	const en::U32 clientCount = 128;
+
+	std::printf("Join burst\n");
+	std::printf("%u clients joining %u AI\n", clientCount, aiCount);
+
+	Server server;
+	server.SetRandomSeed(42);
+	char programName[] = "Benchmark";
+	char anyPort[] = "0";
+	char* argv[] = { programName, anyPort };
+	if (!server.Start(2, argv))
+	{
+		std::printf("Can't start the socket, skipped\n");
+		return;
+	}
+	server.SetMaxPlayers(aiCount + clientCount);
+	for (en::U32 i = 0; i < aiCount; ++i)
+	{
+		server.AddAIPlayer("Bot" + std::to_string(i));
+	}
+
+	const sf::IpAddress address = sf::IpAddress::LocalHost;
+	sf::Packet packet;
+	const auto join = [&](en::U32 i)
+	{
+		packet.clear();
+		packet << static_cast<en::U8>(ClientPacketID::Join) << std::string("Client" + std::to_string(i));
+		server.HandlePacket(packet, address, static_cast<en::U16>(40000 + i));
+	};
+
+	en::Clock clock;
+	for (en::U32 i = 0; i < clientCount / 2; ++i)
+	{
+		join(i);
+	}
+	const en::Time firstHalf = clock.getElapsedTime();
+
+	// A leave in the middle, the list is written again for the next join
+	packet.clear();
+	packet << static_cast<en::U8>(ClientPacketID::Leave);
+	server.HandlePacket(packet, address, 40000);
+
+	clock.restart();
+	for (en::U32 i = clientCount / 2; i < clientCount; ++i)
+	{
+		join(i);
+	}
+	const en::Time secondHalf = clock.getElapsedTime();
+
+	std::printf("  %8.3f us/join, %u PlayerList messages for the last join instead of %u PlayerInfo\n", (firstHalf + secondHalf).asSeconds() * 1000000.0f / clientCount,
+		server.GetPlayerListMessageCount(), server.GetPlayerCount() - 1);
+
+	server.Stop();
+}
+
+// Rooms of AI players stepped by a RoomManager, on its thread pool then on one thread
+void BenchmarkRooms()
+{
+	const en::U32 roomCount = 8;
+	const en::U32 chickensPerRoom = 128;
+	const en::U32 warmupTicks = 20;
+	const en::U32 measuredTicks = 100;
+	const en::U32 stepsPerTick = static_cast<en::U32>(DefaultTickInterval.asSeconds() / DefaultStepInterval.asSeconds() + 0.5f);
+
+	std::printf("Rooms\n");
+	std::printf("Ticks : %u (+%u warmup), %u rooms of %u chickens\n", measuredTicks, warmupTicks, roomCount, chickensPerRoom);
+
+	RoomManager manager;
+	char programName[] = "Benchmark";
+	char anyPort[] = "0";
+	char rooms[] = "8";
+	char* argv[] = { programName, anyPort, rooms };
+	if (!manager.Start(3, argv))
+	{
+		std::printf("Can't start the socket, skipped\n");
+		return;
+	}
+	for (en::U32 roomIndex = 0; roomIndex < manager.GetRoomCount(); ++roomIndex)
+	{
+		Server& room = manager.GetRoom(roomIndex);
+		room.SetRandomSeed(roomIndex);
+		room.SetMaxPlayers(chickensPerRoom);
+		while (room.GetPlayerCount() < chickensPerRoom)
+		{
+			room.AddAIPlayer("Bot" + std::to_string(room.GetPlayerCount()));
+		}
+	}
+
+	for (en::U32 i = 0; i < warmupTicks; ++i)
+	{
+		manager.Update(stepsPerTick, 1);
+	}
+
+	en::Clock clock;
+	for (en::U32 i = 0; i < measuredTicks; ++i)
+	{
+		manager.Update(stepsPerTick, 1);
+	}
+	const en::F32 parallel = clock.getElapsedTime().asSeconds() * 1000.0f / measuredTicks;
+
+	clock.restart();
+	for (en::U32 i = 0; i < measuredTicks; ++i)
+	{
+		for (en::U32 roomIndex = 0; roomIndex < manager.GetRoomCount(); ++roomIndex)
+		{
+			manager.GetRoom(roomIndex).Simulate(stepsPerTick, 1);
+		}
+	}
+	const en::F32 sequential = clock.getElapsedTime().asSeconds() * 1000.0f / measuredTicks;
+
+	std::printf("  one thread : %8.3f ms/tick\n", sequential);
+	std::printf("  %2u threads : %8.3f ms/tick (x%.2f)\n", manager.GetWorkerCount() + 1, parallel, sequential / parallel);
+
+	manager.Stop();
+}
+
+// Datagrams through a real ServerSocket on the loopback, with and without recvmmsg/sendmmsg
+// The other side is a plain sf::UdpSocket on its own thread, kept at most `window` datagrams ahead so the kernel doesn't drop any
+void BenchmarkLoopback(bool systemBatch)
+{
+	const en::U32 datagramCount = 200000;
+	const en::U32 window = 96;
+	const en::Time timeout = en::seconds(10.0f);
+
+	ServerSocket socket;
+	socket.SetSocketPort(0);
+	socket.SetSystemBatchEnabled(systemBatch);
+	if (!socket.Start())
+	{
+		std::printf("Can't start the socket, skipped\n");
+		return;
+	}
+	const sf::IpAddress address = sf::IpAddress::LocalHost;
+	const en::U16 serverPort = socket.GetLocalPort();
+
+	// Receive : client -> ServerSocket::PollPacket
+	{
+		std::atomic<en::U32> polled(0);
+		std::thread client([&]()
+		{
+			sf::UdpSocket clientSocket;
+			char data[64] = {};
+			for (en::U32 i = 0; i < datagramCount; ++i)
+			{
+				while (i - polled.load() >= window)
+				{
+					std::this_thread::yield();
+				}
+				clientSocket.send(data, sizeof(data), address, serverPort);
+			}
+		});
+
+		sf::Packet packet;
+		sf::IpAddress remoteAddress;
+		en::U16 remotePort;
+		en::Clock clock;
+		while (polled.load() < datagramCount && clock.getElapsedTime() < timeout)
+		{
+			if (socket.PollPacket(packet, remoteAddress, remotePort))
+			{
+				polled++;
+			}
+			else
+			{
+				std::this_thread::yield();
+			}
+		}
+		const en::F32 seconds = clock.getElapsedTime().asSeconds();
+		client.join();
+		std::printf("  receive : %8.0f datagrams/s (%u/%u)\n", polled.load() / seconds, polled.load(), datagramCount);
+	}
+
+	// Send : ServerSocket::SendPacket + Flush -> client
+	{
+		sf::UdpSocket clientSocket;
+		clientSocket.bind(sf::Socket::AnyPort);
+		const en::U16 clientPort = clientSocket.getLocalPort();
+		std::atomic<en::U32> received(0);
+		std::atomic<bool> done(false);
+		std::thread client([&]()
+		{
+			clientSocket.setBlocking(false);
+			char data[DefaultMaxDatagramSize];
+			std::size_t size;
+			sf::IpAddress remoteAddress;
+			en::U16 remotePort;
+			while (!done.load())
+			{
+				if (clientSocket.receive(data, sizeof(data), size, remoteAddress, remotePort) == sf::Socket::Done)
+				{
+					received++;
+				}
+				else
+				{
+					std::this_thread::yield();
+				}
+			}
+		});
+
+		// Too big to share a datagram : one message, one datagram
+		sf::Packet packet;
+		packet.append(std::vector<char>(DefaultMaxDatagramSize / 2 + 1).data(), DefaultMaxDatagramSize / 2 + 1);
+		en::Clock clock;
+		en::Clock idleClock;
+		en::U32 sent = 0;
+		en::U32 lastReceived = 0;
+		while (received.load() < datagramCount && clock.getElapsedTime() < timeout)
+		{
+			// Some can be lost, don't wait for them forever
+			const en::U32 currentReceived = received.load();
+			if (currentReceived != lastReceived)
+			{
+				lastReceived = currentReceived;
+				idleClock.restart();
+			}
+			else if (sent == datagramCount && idleClock.getElapsedTime() > en::milliseconds(100))
+			{
+				break;
+			}
+
+			if (sent < datagramCount && sent - currentReceived < window)
+			{
+				for (en::U32 i = 0; i < 16 && sent < datagramCount; ++i, ++sent)
+				{
+					socket.SendPacket(packet, address, clientPort);
+				}
+				socket.Flush();
+			}
+			else
+			{
+				std::this_thread::yield();
+			}
+		}
+		const en::F32 seconds = clock.getElapsedTime().asSeconds();
+		done = true;
+		client.join();
+		std::printf("  send    : %8.0f datagrams/s (%u/%u)\n", received.load() / seconds, received.load(), datagramCount);
+	}
+
+	socket.Stop();
+	std::printf("  %.3f receive/send calls per datagram\n", static_cast<en::F32>(socket.GetSystemCallCount()) / (2.0f * datagramCount));
+}
+
+int main()
+{
+	BenchmarkSimulation();
+	std::printf("\n");
+	BenchmarkPacketReplay();
+	std::printf("\n");
+	BenchmarkEncodings();
+	std::printf("\n");
+	BenchmarkInterest();
+	std::printf("\n");
+	if (!BenchmarkReliable())
+	{
+		return 1;
+	}
+	std::printf("\n");
+	BenchmarkRooms();
+	std::printf("\n");
+	BenchmarkJoinBurst();
+	std::printf("\n");
+	std::printf("Loopback\n");
+	std::printf("SFML, one datagram per call\n");
+	BenchmarkLoopback(false);
+	if (BatchedUdpSocket::IsSystemBatchSupported())
+	{
+		std::printf("recvmmsg/sendmmsg, up to %d datagrams per call\n", DefaultNetworkBatchSize);
+		BenchmarkLoopback(true);
+	}
+	std::printf("\n");
+	BenchmarkTicks();
+	return 0;
+}
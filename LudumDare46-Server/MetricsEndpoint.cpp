@@ -0,0 +1,111 @@
+#include "MetricsEndpoint.hpp"
+
+#include <Enlivengine/System/Log.hpp>
+
+#include <Common.hpp>
+
+MetricsEndpoint::MetricsEndpoint()
+	: mListener()
+	, mClient()
+	, mRequest()
+	, mBody()
+	, mResponse()
+	, mSentSize(0)
+	, mClientTime(en::Time::Zero)
+	, mConnected(false)
+	, mRunning(false)
+{
+}
+
+bool MetricsEndpoint::Start(en::U16 port)
+{
+	if (mListener.listen(port) != sf::Socket::Done)
+	{
+		LogError(en::LogChannel::All, 5, "Can't listen for the metrics on port %d", port);
+		return false;
+	}
+	mListener.setBlocking(false);
+	mRunning = true;
+	return true;
+}
+
+void MetricsEndpoint::Stop()
+{
+	Disconnect();
+	mListener.close();
+	mRunning = false;
+}
+
+void MetricsEndpoint::Update(en::Time dt, const en::MetricsRegistry& registry)
+{
+	if (!mRunning)
+	{
+		return;
+	}
+
+	if (!mConnected)
+	{
+		if (mListener.accept(mClient) != sf::Socket::Done)
+		{
+			return;
+		}
+		mClient.setBlocking(false);
+		mRequest.clear();
+		mResponse.clear();
+		mSentSize = 0;
+		mClientTime = en::Time::Zero;
+		mConnected = true;
+	}
+
+	mClientTime += dt;
+	if (mClientTime >= DefaultMetricsScrapeTimeout)
+	{
+		Disconnect();
+		return;
+	}
+
+	// Whatever the request is, the answer is the metrics once its headers are received
+	if (mResponse.empty())
+	{
+		char buffer[512];
+		std::size_t received = 0;
+		sf::Socket::Status status = mClient.receive(buffer, sizeof(buffer), received);
+		while (status == sf::Socket::Done && mRequest.size() + received <= DefaultMetricsMaxRequestSize)
+		{
+			mRequest.append(buffer, received);
+			status = mClient.receive(buffer, sizeof(buffer), received);
+		}
+		if (status == sf::Socket::Disconnected || status == sf::Socket::Error || received > 0)
+		{
+			Disconnect(); // Gone, or too big for a scrape
+			return;
+		}
+		if (mRequest.find("\r\n\r\n") == std::string::npos)
+		{
+			return;
+		}
+
+		mBody.clear();
+		registry.WritePrometheus(mBody);
+		mResponse = "HTTP/1.1 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: " + std::to_string(mBody.size()) + "\r\nConnection: close\r\n\r\n";
+		mResponse += mBody;
+	}
+
+	std::size_t sent = 0;
+	const sf::Socket::Status status = mClient.send(mResponse.data() + mSentSize, mResponse.size() - mSentSize, sent);
+	mSentSize += sent;
+	if ((status == sf::Socket::Partial || status == sf::Socket::NotReady) && mSentSize < mResponse.size())
+	{
+		return; // The rest on the next Update
+	}
+	Disconnect();
+}
+
+void MetricsEndpoint::Disconnect()
+{
+	if (mConnected)
+	{
+		mClient.disconnect();
+		mConnected = false;
+	}
+}
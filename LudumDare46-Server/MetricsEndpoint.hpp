@@ -0,0 +1,37 @@
+#pragma once
+
+#include <Enlivengine/System/Metrics.hpp>
+#include <Enlivengine/System/PrimitiveTypes.hpp>
+#include <Enlivengine/System/Time.hpp>
+
+#include <SFML/Network.hpp>
+#include <string>
+
+// Serves the metrics of a registry in the Prometheus text format over HTTP, for a scraper to pull them
+// Everything is non-blocking and polled from the main loop : one scrape at a time, a slow scraper is dropped
+class MetricsEndpoint
+{
+public:
+	MetricsEndpoint();
+
+	bool Start(en::U16 port);
+	void Stop();
+	bool IsRunning() const { return mRunning; }
+
+	// Accept a scraper, read its request and send the metrics as they are now
+	void Update(en::Time dt, const en::MetricsRegistry& registry);
+
+private:
+	void Disconnect();
+
+private:
+	sf::TcpListener mListener;
+	sf::TcpSocket mClient;
+	std::string mRequest;
+	std::string mBody;
+	std::string mResponse;
+	std::size_t mSentSize;
+	en::Time mClientTime; // Since the scraper connected
+	bool mConnected;
+	bool mRunning;
+};
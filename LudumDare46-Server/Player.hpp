@@ -4,17 +4,99 @@
 #include <Enlivengine/Math/Vector2.hpp>
 #include <Enlivengine/System/Time.hpp>
 #include <Common.hpp>
+#include <ReliableEndpoint.hpp>
 
+#include <string>
+#include <vector>
+
+// Session and network data of a player, never touched by the simulation loops
 struct Player
 {
 	sf::IpAddress remoteAddress;
 	en::U16 remotePort;
 	en::U32 clientID;
 	en::Time lastPacketTime;
+	en::U32 ackedSnapshot; // Last snapshot received by the client, 0 to send the full state
+	en::Time roundTripTime; // Smoothed over the Ping/Pong, zero until the first Pong
+	en::Time pingSentTime; // Simulation time of the Ping waiting for its Pong, negative if none
+	ReliableEndpoint reliable; // Session messages, in order and without loss
 
 	std::string nickname;
-	Chicken chicken;
+};
+
+// Simulation data of the chickens, stored as structure of arrays so the step loops stay cache-resident
+// Index i of every array refers to the same player as Server::mPlayers[i]
+// Rows are not stable, Remove moves the last one : the clientID is the handle of a chicken
+struct ChickenArrays
+{
+	// Hot : read/written every step
+	std::vector<en::Vector2f> positions;
+	std::vector<en::F32> rotations;
+	std::vector<en::F32> lifes;
+	std::vector<en::F32> cooldowns; // Seconds since last shot
+	std::vector<ItemID> itemIDs;
+	std::vector<en::U32> clientIDs;
+	std::vector<en::U32> seedUIDs; // 0 when the chicken has no seed to follow
+
+	// Warm : only read on movement/hit/network
+	std::vector<en::F32> speeds;
+	std::vector<en::F32> lifeMaxs;
+	std::vector<en::F32> attacks;
+	std::vector<en::U32> kills;
+
+	en::U32 Size() const { return static_cast<en::U32>(positions.size()); }
+
+	void Add(en::U32 clientID, const Chicken& chicken)
+	{
+		positions.push_back(chicken.position);
+		rotations.push_back(chicken.rotation);
+		lifes.push_back(chicken.life);
+		cooldowns.push_back(0.0f);
+		itemIDs.push_back(chicken.itemID);
+		clientIDs.push_back(clientID);
+		seedUIDs.push_back(0);
+		speeds.push_back(chicken.speed);
+		lifeMaxs.push_back(chicken.lifeMax);
+		attacks.push_back(chicken.attack);
+		kills.push_back(chicken.kills);
+	}
+
+	// Swap-and-pop, like Server::RemovePlayer
+	void Remove(en::U32 index)
+	{
+		SwapAndPop(positions, index);
+		SwapAndPop(rotations, index);
+		SwapAndPop(lifes, index);
+		SwapAndPop(cooldowns, index);
+		SwapAndPop(itemIDs, index);
+		SwapAndPop(clientIDs, index);
+		SwapAndPop(seedUIDs, index);
+		SwapAndPop(speeds, index);
+		SwapAndPop(lifeMaxs, index);
+		SwapAndPop(attacks, index);
+		SwapAndPop(kills, index);
+	}
+
+	// Gather the wire representation of a chicken
+	Chicken GetChicken(en::U32 index) const
+	{
+		Chicken chicken;
+		chicken.position = positions[index];
+		chicken.rotation = rotations[index];
+		chicken.itemID = itemIDs[index];
+		chicken.kills = kills[index];
+		chicken.lifeMax = lifeMaxs[index];
+		chicken.life = lifes[index];
+		chicken.speed = speeds[index];
+		chicken.attack = attacks[index];
+		return chicken;
+	}
 
-	en::Time cooldown;
-	bool needUpdate;
-};
\ No newline at end of file
+private:
+	template <typename T>
+	static void SwapAndPop(std::vector<T>& values, en::U32 index)
+	{
+		values[index] = values.back();
+		values.pop_back();
+	}
+};
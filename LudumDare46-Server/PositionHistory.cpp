@@ -0,0 +1,140 @@
+#include "PositionHistory.hpp"
+
+#include <Enlivengine/Math/Utilities.hpp>
+#include <Enlivengine/System/Assert.hpp>
+
+PositionHistory::PositionHistory()
+	: mPositions()
+	, mTimes()
+	, mSpawnTimes()
+	, mMaxDistances()
+	, mSampleCount(1)
+	, mChickenCount(0)
+	, mNewest(0)
+	, mRecordedCount(0)
+{
+	Initialize(1);
+}
+
+void PositionHistory::Initialize(en::U32 sampleCount)
+{
+	assert(sampleCount > 0);
+	mSampleCount = en::Math::Max(sampleCount, 1u);
+	mPositions.clear();
+	mSpawnTimes.clear();
+	mTimes.assign(mSampleCount, en::Time::Zero);
+	mMaxDistances.assign(mSampleCount, 0.0f);
+	mChickenCount = 0;
+	mNewest = 0;
+	mRecordedCount = 0;
+}
+
+void PositionHistory::Reserve(en::U32 chickenCount)
+{
+	mPositions.reserve(static_cast<std::size_t>(chickenCount) * mSampleCount);
+	mSpawnTimes.reserve(chickenCount);
+}
+
+void PositionHistory::Record(en::Time time, const en::Vector2f* positions, en::U32 chickenCount)
+{
+	assert(chickenCount <= mChickenCount);
+	const en::U32 previous = mNewest;
+	mNewest = (mNewest + 1) % mSampleCount;
+	mTimes[mNewest] = time;
+	mRecordedCount = en::Math::Min(mRecordedCount + 1, mSampleCount);
+
+	en::F32 maxDistanceSqr = 0.0f;
+	en::Vector2f* history = mPositions.data();
+	for (en::U32 i = 0; i < chickenCount; ++i, history += mSampleCount)
+	{
+		const en::F32 distanceSqr = (positions[i] - history[previous]).getSquaredLength();
+		maxDistanceSqr = en::Math::Max(maxDistanceSqr, distanceSqr);
+		history[mNewest] = positions[i];
+	}
+	mMaxDistances[mNewest] = en::Math::Sqrt(maxDistanceSqr);
+}
+
+void PositionHistory::Reset(en::U32 index, const en::Vector2f& position, en::Time time)
+{
+	if (index >= mChickenCount)
+	{
+		// Only allocates past the capacity given to Reserve
+		mChickenCount = index + 1;
+		mPositions.resize(static_cast<std::size_t>(mChickenCount) * mSampleCount);
+		mSpawnTimes.resize(mChickenCount);
+	}
+	// The next Record measures the move from there, not from where the chicken died
+	mPositions[static_cast<std::size_t>(index) * mSampleCount + mNewest] = position;
+	mSpawnTimes[index] = time;
+}
+
+void PositionHistory::Remove(en::U32 index, en::U32 lastIndex)
+{
+	assert(index <= lastIndex && lastIndex < mChickenCount);
+	if (index != lastIndex)
+	{
+		en::Vector2f* history = mPositions.data() + static_cast<std::size_t>(index) * mSampleCount;
+		const en::Vector2f* lastHistory = mPositions.data() + static_cast<std::size_t>(lastIndex) * mSampleCount;
+		for (en::U32 sample = 0; sample < mSampleCount; ++sample)
+		{
+			history[sample] = lastHistory[sample];
+		}
+		mSpawnTimes[index] = mSpawnTimes[lastIndex];
+	}
+	mChickenCount = lastIndex;
+	mPositions.resize(static_cast<std::size_t>(mChickenCount) * mSampleCount);
+	mSpawnTimes.resize(mChickenCount);
+}
+
+en::Vector2f PositionHistory::GetPosition(en::U32 index, en::Time time) const
+{
+	assert(index < mChickenCount);
+	const en::Vector2f* history = mPositions.data() + static_cast<std::size_t>(index) * mSampleCount;
+	if (mRecordedCount == 0 || time >= mTimes[mNewest])
+	{
+		return history[mNewest];
+	}
+
+	for (en::U32 k = 1; k < mRecordedCount; ++k)
+	{
+		const en::U32 older = GetSampleIndex(k);
+		if (mTimes[older] <= time)
+		{
+			const en::U32 newer = GetSampleIndex(k - 1);
+			if (mTimes[older] < mSpawnTimes[index])
+			{
+				return history[newer]; // The older sample is from before the spawn
+			}
+			const en::F32 interval = (mTimes[newer] - mTimes[older]).asSeconds();
+			const en::F32 t = (interval > 0.0f) ? (time - mTimes[older]).asSeconds() / interval : 1.0f;
+			return history[older] + (history[newer] - history[older]) * t;
+		}
+	}
+	return history[GetSampleIndex(mRecordedCount - 1)];
+}
+
+en::F32 PositionHistory::GetMaxDistanceSince(en::Time time) const
+{
+	// Each move is counted whole, even if time is in the middle of it
+	en::F32 distance = 0.0f;
+	for (en::U32 k = 0; k + 1 < mRecordedCount; ++k)
+	{
+		const en::U32 sample = GetSampleIndex(k);
+		if (mTimes[sample] <= time)
+		{
+			break;
+		}
+		distance += mMaxDistances[sample];
+	}
+	return distance;
+}
+
+en::Time PositionHistory::GetNewestTime() const
+{
+	return mTimes[mNewest];
+}
+
+en::Time PositionHistory::GetOldestTime() const
+{
+	return (mRecordedCount > 0) ? mTimes[GetSampleIndex(mRecordedCount - 1)] : mTimes[mNewest];
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <Enlivengine/Math/Vector2.hpp>
+#include <Enlivengine/System/PrimitiveTypes.hpp>
+#include <Enlivengine/System/Time.hpp>
+
+#include <vector>
+
+// Positions of every chicken over the last steps, to test hits against where a shooter saw the chickens
+// Each chicken has a ring of sampleCount positions, recorded together once per step
+// Index i refers to the same chicken as ChickenArrays, memory is sampleCount positions per chicken
+class PositionHistory
+{
+public:
+	PositionHistory();
+
+	// Forget everything, the chickens have to be Reset again
+	void Initialize(en::U32 sampleCount);
+	// Chickens the history can hold without allocating
+	void Reserve(en::U32 chickenCount);
+
+	// Once per step, after the chickens moved
+	void Record(en::Time time, const en::Vector2f* positions, en::U32 chickenCount);
+
+	// The chicken appeared at position at time : just added, or respawned
+	// The older samples are not rewritten, GetSpawnTime tells the rewinds that can't see it anymore
+	void Reset(en::U32 index, const en::Vector2f& position, en::Time time);
+	// Same as ChickenArrays::Remove, the last chicken takes the place of the removed one
+	void Remove(en::U32 index, en::U32 lastIndex);
+
+	// Interpolated between the samples around time, clamped to the oldest and newest ones
+	// Only meaningful from the spawn time of the chicken
+	en::Vector2f GetPosition(en::U32 index, en::Time time) const;
+	en::Time GetSpawnTime(en::U32 index) const { return mSpawnTimes[index]; }
+
+	// No chicken moved more than that between time and the newest sample
+	en::F32 GetMaxDistanceSince(en::Time time) const;
+
+	en::U32 GetSampleCount() const { return mSampleCount; }
+	en::U32 GetRecordedCount() const { return mRecordedCount; }
+	en::Time GetNewestTime() const;
+	en::Time GetOldestTime() const;
+
+private:
+	// k = 0 is the newest sample
+	en::U32 GetSampleIndex(en::U32 k) const { return (mNewest + mSampleCount - k) % mSampleCount; }
+
+private:
+	std::vector<en::Vector2f> mPositions; // Chicken-major : [index * mSampleCount + sample]
+	std::vector<en::Time> mTimes;
+	std::vector<en::Time> mSpawnTimes; // Per chicken, when Reset was last called
+	std::vector<en::F32> mMaxDistances; // Biggest move of a chicken from the previous sample to this one
+	en::U32 mSampleCount;
+	en::U32 mChickenCount; // Chickens with a history
+	en::U32 mNewest;
+	en::U32 mRecordedCount;
+};
@@ -0,0 +1,381 @@
+#include "Replay.hpp"
+
+#include <Enlivengine/System/Compression.hpp>
+
+#include <Common.hpp>
+
+#include <cstring>
+
+static const char ReplayMagic[4] = { 'L', 'D', 'R', 'P' };
+static const en::U8 ReplayVersion = 1;
+
+static void AppendU32(std::vector<en::U8>& data, en::U32 value)
+{
+	// Little-endian
+	data.push_back(static_cast<en::U8>(value & 0xFF));
+	data.push_back(static_cast<en::U8>((value >> 8) & 0xFF));
+	data.push_back(static_cast<en::U8>((value >> 16) & 0xFF));
+	data.push_back(static_cast<en::U8>((value >> 24) & 0xFF));
+}
+
+static en::U32 ParseU32(const en::U8* data)
+{
+	return static_cast<en::U32>(data[0]) | (static_cast<en::U32>(data[1]) << 8) | (static_cast<en::U32>(data[2]) << 16) | (static_cast<en::U32>(data[3]) << 24);
+}
+
+ReplayRecorder::ReplayRecorder()
+	: mFile(nullptr)
+	, mChunk()
+	, mCompressed()
+	, mEndpoints()
+	, mStepIndex(0)
+	, mLastPacketStepIndex(0)
+	, mFlushStepIndex(0)
+	, mWrittenSize(0)
+{
+}
+
+ReplayRecorder::~ReplayRecorder()
+{
+	Close();
+}
+
+bool ReplayRecorder::Open(const std::string& path, const ReplaySettings& settings)
+{
+	Close();
+	mFile = std::fopen(path.c_str(), "wb");
+	if (mFile == nullptr)
+	{
+		return false;
+	}
+
+	std::vector<en::U8> header(ReplayMagic, ReplayMagic + 4);
+	header.push_back(ReplayVersion);
+	AppendU32(header, settings.seed);
+	AppendU32(header, settings.maxPlayers);
+	AppendU32(header, settings.lagCompensationWindow);
+	std::fwrite(header.data(), 1, header.size(), mFile);
+	std::fflush(mFile);
+
+	mChunk.clear();
+	mChunk.reserve(DefaultReplayChunkSize + DefaultMaxDatagramSize + 32);
+	mEndpoints.clear();
+	mStepIndex = 0;
+	mLastPacketStepIndex = 0;
+	mFlushStepIndex = 0;
+	mWrittenSize = header.size();
+	return true;
+}
+
+void ReplayRecorder::Close()
+{
+	if (mFile != nullptr)
+	{
+		FlushChunk();
+		std::fclose(mFile);
+		mFile = nullptr;
+	}
+}
+
+void ReplayRecorder::RecordPacket(const sf::Packet& packet, const sf::IpAddress& remoteAddress, en::U16 remotePort)
+{
+	if (mFile == nullptr)
+	{
+		return;
+	}
+
+	mChunk.push_back(static_cast<en::U8>(ReplayRecordType::Packet));
+	WriteVarU32(mStepIndex - mLastPacketStepIndex);
+	mLastPacketStepIndex = mStepIndex;
+
+	// Endpoints are numbered in order of appearance, a new one is followed by its address
+	const en::U32 endpointCount = static_cast<en::U32>(mEndpoints.size());
+	const auto inserted = mEndpoints.insert({ GetEndpointKey(remoteAddress, remotePort), endpointCount });
+	WriteVarU32(inserted.first->second);
+	if (inserted.second)
+	{
+		WriteU32(remoteAddress.toInteger());
+		mChunk.push_back(static_cast<en::U8>(remotePort & 0xFF));
+		mChunk.push_back(static_cast<en::U8>(remotePort >> 8));
+	}
+
+	const en::U8* data = static_cast<const en::U8*>(packet.getData());
+	const en::U32 size = static_cast<en::U32>(packet.getDataSize());
+	WriteVarU32(size);
+	mChunk.insert(mChunk.end(), data, data + size);
+	EndRecord();
+}
+
+void ReplayRecorder::RecordSimulate(en::U32 stepCount, en::U32 tickCount)
+{
+	if (mFile == nullptr || (stepCount == 0 && tickCount == 0))
+	{
+		return;
+	}
+
+	mChunk.push_back(static_cast<en::U8>(ReplayRecordType::Simulate));
+	WriteVarU32(stepCount);
+	WriteVarU32(tickCount);
+	mStepIndex += stepCount;
+	EndRecord();
+}
+
+void ReplayRecorder::RecordStateHash(en::U32 stateHash)
+{
+	if (mFile == nullptr)
+	{
+		return;
+	}
+
+	mChunk.push_back(static_cast<en::U8>(ReplayRecordType::StateHash));
+	WriteU32(stateHash);
+	EndRecord();
+}
+
+void ReplayRecorder::WriteVarU32(en::U32 value)
+{
+	// 7 bits per byte, the high bit tells another byte follows
+	while (value >= 0x80)
+	{
+		mChunk.push_back(static_cast<en::U8>((value & 0x7F) | 0x80));
+		value >>= 7;
+	}
+	mChunk.push_back(static_cast<en::U8>(value));
+}
+
+void ReplayRecorder::WriteU32(en::U32 value)
+{
+	AppendU32(mChunk, value);
+}
+
+void ReplayRecorder::EndRecord()
+{
+	if (mChunk.size() >= DefaultReplayChunkSize || mStepIndex - mFlushStepIndex >= DefaultReplayFlushSteps)
+	{
+		FlushChunk();
+	}
+}
+
+void ReplayRecorder::FlushChunk()
+{
+	if (mChunk.empty())
+	{
+		return;
+	}
+
+	// Worst case of zlib, for data that doesn't compress
+	mCompressed.resize(mChunk.size() + mChunk.size() / 10 + 128);
+	if (en::Compression::CompressZlib(mChunk, mCompressed))
+	{
+		const en::U32 size = static_cast<en::U32>(mChunk.size());
+		const en::U32 compressedSize = static_cast<en::U32>(mCompressed.size());
+		const en::U8 sizes[8] =
+		{
+			static_cast<en::U8>(size), static_cast<en::U8>(size >> 8), static_cast<en::U8>(size >> 16), static_cast<en::U8>(size >> 24),
+			static_cast<en::U8>(compressedSize), static_cast<en::U8>(compressedSize >> 8), static_cast<en::U8>(compressedSize >> 16), static_cast<en::U8>(compressedSize >> 24)
+		};
+		std::fwrite(sizes, 1, sizeof(sizes), mFile);
+		std::fwrite(mCompressed.data(), 1, mCompressed.size(), mFile);
+		std::fflush(mFile);
+		mWrittenSize += sizeof(sizes) + mCompressed.size();
+	}
+	mChunk.clear();
+	mFlushStepIndex = mStepIndex;
+}
+
+ReplayReader::ReplayReader()
+	: mFile(nullptr)
+	, mSettings()
+	, mChunk()
+	, mCompressed()
+	, mOffset(0)
+	, mEndpoints()
+	, mStepIndex(0)
+	, mCorrupted(false)
+{
+}
+
+ReplayReader::~ReplayReader()
+{
+	Close();
+}
+
+bool ReplayReader::Open(const std::string& path)
+{
+	Close();
+	mFile = std::fopen(path.c_str(), "rb");
+	if (mFile == nullptr)
+	{
+		return false;
+	}
+
+	en::U8 header[17];
+	if (std::fread(header, 1, sizeof(header), mFile) != sizeof(header) || std::memcmp(header, ReplayMagic, 4) != 0 || header[4] != ReplayVersion)
+	{
+		Close();
+		return false;
+	}
+	mSettings.seed = ParseU32(header + 5);
+	mSettings.maxPlayers = ParseU32(header + 9);
+	mSettings.lagCompensationWindow = ParseU32(header + 13);
+
+	mChunk.clear();
+	mOffset = 0;
+	mEndpoints.clear();
+	mStepIndex = 0;
+	mCorrupted = false;
+	return true;
+}
+
+void ReplayReader::Close()
+{
+	if (mFile != nullptr)
+	{
+		std::fclose(mFile);
+		mFile = nullptr;
+	}
+}
+
+bool ReplayReader::Next(ReplayRecord& record)
+{
+	if (mFile == nullptr || mCorrupted)
+	{
+		return false;
+	}
+	if (mOffset >= mChunk.size() && !ReadChunk())
+	{
+		return false;
+	}
+
+	en::U8 type;
+	ReadU8(type);
+	record.type = static_cast<ReplayRecordType>(type);
+	switch (record.type)
+	{
+	case ReplayRecordType::Packet:
+	{
+		en::U32 stepDelta;
+		en::U32 endpointIndex;
+		if (!ReadVarU32(stepDelta) || !ReadVarU32(endpointIndex) || endpointIndex > mEndpoints.size())
+		{
+			mCorrupted = true;
+			return false;
+		}
+		mStepIndex += stepDelta;
+		if (endpointIndex == mEndpoints.size())
+		{
+			en::U32 address;
+			en::U8 portLow;
+			en::U8 portHigh;
+			if (!ReadU32(address) || !ReadU8(portLow) || !ReadU8(portHigh))
+			{
+				mCorrupted = true;
+				return false;
+			}
+			mEndpoints.emplace_back(sf::IpAddress(address), static_cast<en::U16>(portLow | (portHigh << 8)));
+		}
+		record.remoteAddress = mEndpoints[endpointIndex].first;
+		record.remotePort = mEndpoints[endpointIndex].second;
+
+		en::U32 size;
+		if (!ReadVarU32(size) || mOffset + size > mChunk.size())
+		{
+			mCorrupted = true;
+			return false;
+		}
+		record.packet.clear();
+		record.packet.append(mChunk.data() + mOffset, size);
+		mOffset += size;
+	} break;
+	case ReplayRecordType::Simulate:
+	{
+		if (!ReadVarU32(record.stepCount) || !ReadVarU32(record.tickCount))
+		{
+			mCorrupted = true;
+			return false;
+		}
+	} break;
+	case ReplayRecordType::StateHash:
+	{
+		if (!ReadU32(record.stateHash))
+		{
+			mCorrupted = true;
+			return false;
+		}
+	} break;
+	default:
+	{
+		mCorrupted = true;
+		return false;
+	}
+	}
+
+	record.stepIndex = mStepIndex;
+	if (record.type == ReplayRecordType::Simulate)
+	{
+		mStepIndex += record.stepCount;
+	}
+	return true;
+}
+
+bool ReplayReader::ReadChunk()
+{
+	en::U8 sizes[8];
+	const std::size_t read = std::fread(sizes, 1, sizeof(sizes), mFile);
+	if (read != sizeof(sizes))
+	{
+		// A partial chunk header is the end of a session cut short
+		return false;
+	}
+	const en::U32 size = ParseU32(sizes);
+	const en::U32 compressedSize = ParseU32(sizes + 4);
+	mCompressed.resize(compressedSize);
+	mChunk.resize(size);
+	if (std::fread(mCompressed.data(), 1, compressedSize, mFile) != compressedSize || !en::Compression::DecompressZlib(mCompressed, mChunk) || mChunk.size() != size || size == 0)
+	{
+		mCorrupted = true;
+		return false;
+	}
+	mOffset = 0;
+	return true;
+}
+
+bool ReplayReader::ReadU8(en::U8& value)
+{
+	if (mOffset + 1 > mChunk.size())
+	{
+		return false;
+	}
+	value = mChunk[mOffset++];
+	return true;
+}
+
+bool ReplayReader::ReadU32(en::U32& value)
+{
+	if (mOffset + 4 > mChunk.size())
+	{
+		return false;
+	}
+	value = ParseU32(mChunk.data() + mOffset);
+	mOffset += 4;
+	return true;
+}
+
+bool ReplayReader::ReadVarU32(en::U32& value)
+{
+	value = 0;
+	for (en::U32 shift = 0; shift < 35; shift += 7)
+	{
+		en::U8 byte;
+		if (!ReadU8(byte))
+		{
+			return false;
+		}
+		value |= static_cast<en::U32>(byte & 0x7F) << shift;
+		if ((byte & 0x80) == 0)
+		{
+			return true;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <Enlivengine/System/PrimitiveTypes.hpp>
+
+#include <SFML/Network.hpp>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// A Server only depends on its seed, its settings, and the packets and Simulate calls it gets, in order
+// A replay records them, so a session can be played again exactly, offline and at full speed
+//
+// File : header, then chunks of records compressed with en::Compression::CompressZlib
+// Records never span two chunks, so a session cut short only loses its last chunk, at most DefaultReplayFlushSteps
+// - Packet : step index (delta), endpoint (index, its address and port the first time), data
+// - Simulate : step and tick counts
+// - StateHash : Server::ComputeStateHash, checked by the playback
+
+enum class ReplayRecordType : en::U8
+{
+	Packet,
+	Simulate,
+	StateHash,
+
+	Count
+};
+
+struct ReplaySettings
+{
+	en::U32 seed;
+	en::U32 maxPlayers;
+	en::U32 lagCompensationWindow; // Milliseconds
+};
+
+struct ReplayRecord
+{
+	ReplayRecordType type;
+	en::U32 stepIndex; // Steps simulated before the record
+
+	// Packet
+	sf::Packet packet;
+	sf::IpAddress remoteAddress;
+	en::U16 remotePort;
+
+	// Simulate
+	en::U32 stepCount;
+	en::U32 tickCount;
+
+	// StateHash
+	en::U32 stateHash;
+};
+
+class ReplayRecorder
+{
+public:
+	ReplayRecorder();
+	~ReplayRecorder();
+
+	bool Open(const std::string& path, const ReplaySettings& settings);
+	// Write what is left of the current chunk
+	void Close();
+	bool IsOpen() const { return mFile != nullptr; }
+
+	void RecordPacket(const sf::Packet& packet, const sf::IpAddress& remoteAddress, en::U16 remotePort);
+	void RecordSimulate(en::U32 stepCount, en::U32 tickCount);
+	void RecordStateHash(en::U32 stateHash);
+
+	// Compressed bytes written so far, current chunk excluded
+	en::U64 GetWrittenSize() const { return mWrittenSize; }
+
+private:
+	void WriteVarU32(en::U32 value);
+	void WriteU32(en::U32 value);
+	void EndRecord();
+	void FlushChunk();
+
+private:
+	std::FILE* mFile;
+	std::vector<en::U8> mChunk; // Reserved once, flushed when DefaultReplayChunkSize is reached
+	std::vector<en::U8> mCompressed;
+	std::unordered_map<en::U64, en::U32> mEndpoints; // Address+port -> endpoint index
+	en::U32 mStepIndex;
+	en::U32 mLastPacketStepIndex;
+	en::U32 mFlushStepIndex;
+	en::U64 mWrittenSize;
+};
+
+class ReplayReader
+{
+public:
+	ReplayReader();
+	~ReplayReader();
+
+	bool Open(const std::string& path);
+	void Close();
+
+	const ReplaySettings& GetSettings() const { return mSettings; }
+
+	// False at the end, or if the file is corrupted (see IsCorrupted)
+	bool Next(ReplayRecord& record);
+	bool IsCorrupted() const { return mCorrupted; }
+
+private:
+	bool ReadChunk();
+	bool ReadU8(en::U8& value);
+	bool ReadU32(en::U32& value);
+	bool ReadVarU32(en::U32& value);
+
+private:
+	std::FILE* mFile;
+	ReplaySettings mSettings;
+	std::vector<en::U8> mChunk;
+	std::vector<en::U8> mCompressed;
+	std::size_t mOffset;
+	std::vector<std::pair<sf::IpAddress, en::U16>> mEndpoints;
+	en::U32 mStepIndex;
+	bool mCorrupted;
+};
@@ -0,0 +1,98 @@
+#include "Replay.hpp"
+#include "Server.hpp"
+
+#include <Enlivengine/System/Time.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+
+// Play a session recorded by a Server (see RoomManager::Start) again, as fast as possible
+// Same seed, same packets, same Simulate calls : the state hash at the end must match the recorded one
+// The sends go through a socket that was never started, so they cost what they cost live, without leaving the process
+// Usage : LudumDare46ServerReplay <replayPath>
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		std::printf("Usage : %s <replayPath>\n", argv[0]);
+		return 1;
+	}
+
+	ReplayReader reader;
+	if (!reader.Open(argv[1]))
+	{
+		std::printf("Can't open the replay %s\n", argv[1]);
+		return 1;
+	}
+	const ReplaySettings& settings = reader.GetSettings();
+	std::printf("Replay %s : seed %u, %u max players, %ums lag compensation\n", argv[1], settings.seed, settings.maxPlayers, settings.lagCompensationWindow);
+
+	ServerSocket network;
+	Server server;
+	server.SetRandomSeed(settings.seed);
+	server.SetMaxPlayers(settings.maxPlayers);
+	server.SetLagCompensationWindow(en::milliseconds(static_cast<en::I32>(settings.lagCompensationWindow)));
+	server.Start(network);
+
+	ServerProfile profile;
+	server.SetProfile(&profile);
+
+	ReplayRecord record;
+	en::U32 packetCount = 0;
+	en::U32 stepCount = 0;
+	en::U32 tickCount = 0;
+	en::U32 hashCount = 0;
+	en::U32 mismatchCount = 0;
+	en::Clock clock;
+	while (reader.Next(record))
+	{
+		switch (record.type)
+		{
+		case ReplayRecordType::Packet:
+		{
+			server.HandlePacket(record.packet, record.remoteAddress, record.remotePort);
+			packetCount++;
+		} break;
+		case ReplayRecordType::Simulate:
+		{
+			// Like RoomManager::Update
+			server.Simulate(record.stepCount, record.tickCount);
+			server.SendQueuedPackets();
+			stepCount += record.stepCount;
+			tickCount += record.tickCount;
+		} break;
+		case ReplayRecordType::StateHash:
+		{
+			const en::U32 stateHash = server.ComputeStateHash();
+			hashCount++;
+			if (stateHash != record.stateHash)
+			{
+				std::printf("State hash mismatch at step %u : %08x instead of %08x\n", record.stepIndex, stateHash, record.stateHash);
+				mismatchCount++;
+			}
+		} break;
+		default: break;
+		}
+	}
+	const en::Time elapsed = clock.getElapsedTime();
+	server.SetProfile(nullptr);
+
+	if (reader.IsCorrupted())
+	{
+		std::printf("Corrupted replay, stopped after step %u\n", stepCount);
+	}
+
+	std::printf("%u packets, %u steps, %u ticks, %u players left\n", packetCount, stepCount, tickCount, server.GetPlayerCount());
+	std::printf("%-8s %10s %8s %10s\n", "Phase", "total ms", "calls", "us/call");
+	for (en::U32 i = 0; i < ServerProfile::PhaseCount; ++i)
+	{
+		const en::F32 totalMs = profile.times[i].asSeconds() * 1000.0f;
+		const en::F32 perCallUs = (profile.calls[i] > 0) ? totalMs * 1000.0f / static_cast<en::F32>(profile.calls[i]) : 0.0f;
+		std::printf("%-8s %10.3f %8u %10.3f\n", GetServerPhaseName(static_cast<ServerPhase>(i)), totalMs, profile.calls[i], perCallUs);
+	}
+	std::printf("Total : %.3f ms, %.4f ms/step, x%.0f real time\n", elapsed.asSeconds() * 1000.0f, (stepCount > 0) ? elapsed.asSeconds() * 1000.0f / static_cast<en::F32>(stepCount) : 0.0f,
+		(elapsed > en::Time::Zero) ? stepCount * DefaultStepInterval.asSeconds() / elapsed.asSeconds() : 0.0f);
+	std::printf("State hash : %08x, %u/%u recorded hashes matched\n", server.ComputeStateHash(), hashCount - mismatchCount, hashCount);
+
+	return (mismatchCount == 0 && !reader.IsCorrupted()) ? 0 : 1;
+}
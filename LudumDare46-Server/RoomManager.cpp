@@ -0,0 +1,268 @@
+#include "RoomManager.hpp"
+
+#include <cstdlib>
+
+RoomManager::RoomManager()
+	: mMetricsRegistry()
+	, mMetrics(mMetricsRegistry)
+	, mMetricsPath()
+	, mMetricsEndpoint()
+	, mSocket()
+	, mRooms()
+	, mEndpointToRoom()
+	, mPool()
+	, mReceivedPacket()
+	, mStepTimestep(DefaultStepInterval, DefaultMaxCatchUpSteps)
+	, mTickTimestep(DefaultTickInterval, DefaultMaxCatchUpTicks)
+	, mRunning(false)
+{
+}
+
+RoomManager::~RoomManager()
+{
+	if (mRunning)
+	{
+		Stop();
+	}
+}
+
+bool RoomManager::Start(int argc, char** argv)
+{
+#ifdef ENLIVE_ENABLE_LOG
+	en::LogManager::GetInstance().Initialize();
+#endif
+
+	mSocket.SetSocketPort((argc >= 2) ? static_cast<en::U16>(std::atoi(argv[1])) : DefaultServerPort);
+	const en::U32 roomCount = (argc >= 3) ? static_cast<en::U32>(std::atoi(argv[2])) : DefaultRoomCount;
+	mMetricsPath = (argc >= 4) ? argv[3] : "";
+	if (!mMetricsPath.empty() && mMetricsPath[0] == ':')
+	{
+		const en::U16 metricsPort = static_cast<en::U16>(std::atoi(mMetricsPath.c_str() + 1));
+		mMetricsPath.clear();
+		if (!mMetricsEndpoint.Start(metricsPort))
+		{
+			return false;
+		}
+		LogInfo(en::LogChannel::All, 5, "Metrics served on port %d", metricsPort);
+	}
+	const std::string replayPath = (argc >= 5) ? argv[4] : "";
+	const en::U32 baseSeed = (argc >= 6) ? static_cast<en::U32>(std::strtoul(argv[5], nullptr, 10)) : static_cast<en::U32>(en::Time::now().asMilliseconds());
+	mSocket.SetMetrics(&mMetrics);
+	if (roomCount == 0 || !mSocket.Start())
+	{
+		return false;
+	}
+
+	mRooms.reserve(roomCount);
+	for (en::U32 i = 0; i < roomCount; ++i)
+	{
+		mRooms.emplace_back(new Server());
+		mRooms.back()->SetMetrics(&mMetrics);
+		// Before recording, so the replay settings keep this seed
+		mRooms.back()->SetRandomSeed(baseSeed + i);
+		if (!replayPath.empty() && !mRooms.back()->StartRecording(replayPath + "." + std::to_string(i)))
+		{
+			LogWarning(en::LogChannel::All, 6, "Can't record room %d to %s.%d", i, replayPath.c_str(), i);
+		}
+		mRooms.back()->Start(mSocket);
+	}
+	mMetrics.rooms.Set(static_cast<en::I64>(roomCount));
+	mEndpointToRoom.reserve(roomCount * DefaultMaxPlayers);
+
+	// The calling thread takes part too
+	const en::U32 workerCount = en::ThreadPool::GetDefaultWorkerCount();
+	mPool.reset(new en::ThreadPool((workerCount < roomCount - 1) ? workerCount : roomCount - 1));
+
+	LogInfo(en::LogChannel::All, 5, "%d rooms, %d workers, seed %u", roomCount, mPool->GetWorkerCount(), baseSeed);
+	if (!mMetricsPath.empty())
+	{
+		LogInfo(en::LogChannel::All, 5, "Metrics written to %s", mMetricsPath.c_str());
+	}
+
+	mRunning = true;
+	return true;
+}
+
+void RoomManager::Stop()
+{
+	mRunning = false;
+
+	// Each room sends its Stopping packet through the socket before it is stopped
+	for (std::unique_ptr<Server>& room : mRooms)
+	{
+		room->Stop();
+	}
+	mSocket.Stop();
+
+	mMetricsEndpoint.Stop();
+	if (!mMetricsPath.empty())
+	{
+		WriteMetrics();
+	}
+}
+
+bool RoomManager::Run()
+{
+	en::Clock clock;
+	mStepTimestep.Reset();
+	mTickTimestep.Reset();
+	en::Time metricsTime = en::Time::Zero;
+	while (IsRunning())
+	{
+		const en::Time dt = clock.restart();
+
+		// Every room advances by the same amount, the ones without players just don't simulate
+		// After a hitch, only a few steps are run to catch up, see en::FixedTimestep
+		const en::U32 droppedSteps = mStepTimestep.GetDroppedStepCount();
+		const en::U32 droppedTicks = mTickTimestep.GetDroppedStepCount();
+		const en::U32 stepCount = mStepTimestep.Advance(dt);
+		const en::U32 tickCount = mTickTimestep.Advance(dt);
+		if (mStepTimestep.GetDroppedStepCount() != droppedSteps || mTickTimestep.GetDroppedStepCount() != droppedTicks)
+		{
+			LogWarning(en::LogChannel::All, 6, "Overrun : %d steps and %d ticks dropped", mStepTimestep.GetDroppedStepCount() - droppedSteps, mTickTimestep.GetDroppedStepCount() - droppedTicks);
+			mMetrics.overruns.Add();
+			mMetrics.droppedSteps.Add(mStepTimestep.GetDroppedStepCount() - droppedSteps);
+			mMetrics.droppedTicks.Add(mTickTimestep.GetDroppedStepCount() - droppedTicks);
+		}
+
+		Update(stepCount, tickCount);
+
+		mMetricsEndpoint.Update(dt, mMetricsRegistry);
+		if (!mMetricsPath.empty())
+		{
+			metricsTime += dt;
+			if (metricsTime >= DefaultMetricsInterval)
+			{
+				if (!WriteMetrics())
+				{
+					LogWarning(en::LogChannel::All, 6, "Can't write the metrics to %s", mMetricsPath.c_str());
+				}
+				metricsTime = en::Time::Zero;
+			}
+		}
+
+		// The network thread keeps receiving while we sleep, so a join waits at most one step
+		const en::Time untilNextStep = mStepTimestep.GetRemainingTime();
+		if (untilNextStep > en::Time::Zero)
+		{
+			sf::sleep(sf::microseconds(untilNextStep.asMicroseconds()));
+		}
+	}
+	return true;
+}
+
+bool RoomManager::WriteMetrics() const
+{
+	return mMetricsRegistry.WritePrometheusFile(mMetricsPath);
+}
+
+bool RoomManager::IsRunning() const
+{
+	return mRunning;
+}
+
+void RoomManager::Update(en::U32 stepCount, en::U32 tickCount)
+{
+	// Packets are handled here, on one thread, while no room is being simulated
+	HandleIncomingPackets();
+
+	if (stepCount > 0 || tickCount > 0)
+	{
+		mPool->ParallelFor(GetRoomCount(), [this, stepCount, tickCount](en::U32 roomIndex)
+		{
+			Server& room = *mRooms[roomIndex];
+			if (room.GetPlayerCount() > 1)
+			{
+				room.Simulate(stepCount, tickCount);
+			}
+		});
+	}
+
+	SendQueuedPackets();
+
+	if (tickCount > 0)
+	{
+		ForgetLeftPlayers();
+	}
+}
+
+en::I32 RoomManager::GetRoomIndex(const sf::IpAddress& remoteAddress, en::U16 remotePort) const
+{
+	const auto itr = mEndpointToRoom.find(GetEndpointKey(remoteAddress, remotePort));
+	return (itr != mEndpointToRoom.end()) ? static_cast<en::I32>(itr->second) : -1;
+}
+
+void RoomManager::HandleIncomingPackets()
+{
+	sf::IpAddress remoteAddress;
+	en::U16 remotePort;
+	while (mSocket.PollPacket(mReceivedPacket, remoteAddress, remotePort))
+	{
+		const en::I32 roomIndex = GetRoomIndexForPacket(mReceivedPacket, remoteAddress, remotePort);
+		if (roomIndex >= 0)
+		{
+			mRooms[roomIndex]->HandlePacket(mReceivedPacket, remoteAddress, remotePort);
+		}
+	}
+}
+
+en::I32 RoomManager::GetRoomIndexForPacket(const sf::Packet& packet, const sf::IpAddress& remoteAddress, en::U16 remotePort)
+{
+	const en::U64 endpointKey = GetEndpointKey(remoteAddress, remotePort);
+	const auto itr = mEndpointToRoom.find(endpointKey);
+	if (itr != mEndpointToRoom.end())
+	{
+		return static_cast<en::I32>(itr->second);
+	}
+
+	// Unknown endpoints can only join
+	const bool isJoin = packet.getDataSize() > 0 && static_cast<const en::U8*>(packet.getData())[0] == static_cast<en::U8>(ClientPacketID::Join);
+	if (!isJoin)
+	{
+		return -1;
+	}
+
+	// Every room is full : the first one rejects the player
+	const en::I32 roomIndex = FindRoomToJoin();
+	const en::U32 joinedRoom = (roomIndex >= 0) ? static_cast<en::U32>(roomIndex) : 0;
+	mEndpointToRoom[endpointKey] = joinedRoom;
+	return static_cast<en::I32>(joinedRoom);
+}
+
+en::I32 RoomManager::FindRoomToJoin() const
+{
+	// Fill the rooms in order, so players find someone to play with
+	const en::U32 roomCount = GetRoomCount();
+	for (en::U32 i = 0; i < roomCount; ++i)
+	{
+		if (mRooms[i]->GetPlayerCount() < mRooms[i]->GetMaxPlayers())
+		{
+			return static_cast<en::I32>(i);
+		}
+	}
+	return -1;
+}
+
+void RoomManager::SendQueuedPackets()
+{
+	for (std::unique_ptr<Server>& room : mRooms)
+	{
+		room->SendQueuedPackets();
+	}
+}
+
+void RoomManager::ForgetLeftPlayers()
+{
+	// Players who left, timed out or were rejected, their next Join picks a room again
+	for (auto itr = mEndpointToRoom.begin(); itr != mEndpointToRoom.end(); )
+	{
+		if (!mRooms[itr->second]->HasPlayer(itr->first))
+		{
+			itr = mEndpointToRoom.erase(itr);
+		}
+		else
+		{
+			++itr;
+		}
+	}
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <Enlivengine/System/FixedTimestep.hpp>
+#include <Enlivengine/System/Metrics.hpp>
+#include <Enlivengine/System/ThreadPool.hpp>
+#include <Enlivengine/System/Time.hpp>
+
+#include <SFML/Network.hpp>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <Common.hpp>
+#include "MetricsEndpoint.hpp"
+#include "Server.hpp"
+#include "ServerMetrics.hpp"
+#include "ServerSocket.hpp"
+
+// Independent worlds (rooms) sharing one socket, stepped in parallel on a thread pool
+// Packets go to the room of their endpoint, a new player joins the first room with a free slot
+class RoomManager
+{
+public:
+	RoomManager();
+	~RoomManager();
+
+	// [port] [roomCount] [metricsPath] [replayPath] [seed]
+	// With a path, the metrics are written there every DefaultMetricsInterval in the Prometheus text format
+	// With :port instead, they are served over HTTP on that port for a Prometheus scraper
+	// With a replay path, room i records its session to replayPath.i, see LudumDare46ServerReplay
+	// Room i is seeded with seed + i, the seed is taken from the clock when not given
+	bool Start(int argc, char** argv);
+	void Stop();
+
+	bool Run();
+	bool IsRunning() const;
+
+	// One loop of Run : dispatch the received packets, advance every room in parallel, send what they queued
+	void Update(en::U32 stepCount, en::U32 tickCount);
+
+	en::U32 GetRoomCount() const { return static_cast<en::U32>(mRooms.size()); }
+	Server& GetRoom(en::U32 roomIndex) { return *mRooms[roomIndex]; }
+	en::U32 GetWorkerCount() const { return (mPool != nullptr) ? mPool->GetWorkerCount() : 0; }
+
+	// Schedulers of Run, shared by every room
+	const en::FixedTimestep& GetStepTimestep() const { return mStepTimestep; }
+	const en::FixedTimestep& GetTickTimestep() const { return mTickTimestep; }
+
+	// Recorded by the rooms and the socket
+	const en::MetricsRegistry& GetMetricsRegistry() const { return mMetricsRegistry; }
+	const ServerMetrics& GetMetrics() const { return mMetrics; }
+	bool WriteMetrics() const;
+
+	// -1 if the endpoint isn't in any room
+	en::I32 GetRoomIndex(const sf::IpAddress& remoteAddress, en::U16 remotePort) const;
+
+private:
+	void HandleIncomingPackets();
+	en::I32 GetRoomIndexForPacket(const sf::Packet& packet, const sf::IpAddress& remoteAddress, en::U16 remotePort);
+	en::I32 FindRoomToJoin() const;
+	void SendQueuedPackets();
+	void ForgetLeftPlayers();
+
+private:
+	en::MetricsRegistry mMetricsRegistry; // Before the socket and the rooms, which record in it
+	ServerMetrics mMetrics;
+	std::string mMetricsPath; // Empty to not write them
+	MetricsEndpoint mMetricsEndpoint;
+	ServerSocket mSocket; // Before the rooms, which send through it until they are destroyed
+	std::vector<std::unique_ptr<Server>> mRooms;
+	std::unordered_map<en::U64, en::U32> mEndpointToRoom; // Address+port -> room index
+	std::unique_ptr<en::ThreadPool> mPool; // Sized from the room count
+	sf::Packet mReceivedPacket;
+	en::FixedTimestep mStepTimestep;
+	en::FixedTimestep mTickTimestep;
+	bool mRunning;
+};
@@ -8,6 +8,7 @@
 #include <Enlivengine/Application/PathManager.hpp>
 
 #include <SFML/Network.hpp>
+#include <algorithm>
 #include <vector>
 
 #include <Common.hpp>
@@ -19,10 +20,54 @@ Server::Server()
 	, mRunning(false)
 	, mMapSize(DefaultMapSizeX, DefaultMapSizeY)
 	, mPlayers()
+	, mChickens()
+	, mEndpointToPlayer()
+	, mClientIDToPlayer()
 	, mSeeds()
 	, mItems()
+	, mItemSpawnOrder()
 	, mBullets()
+	, mChickenGrid()
+	, mSnapshots()
+	, mSnapshotSequence(0)
+	, mPendingEvents()
+	, mSnapshotPacket()
+	, mSnapshotWriter()
+	, mBaselineView()
+	, mCurrentView()
+	, mPacketPool()
+	, mReceivedPacket()
+	, mReliablePacket()
+	, mReliableMessage()
+	, mPlayerListMessages()
+	, mPlayerListEntry()
+	, mPlayerListCount(0)
+	, mPlayerListVersion(0)
+	, mPlayersVersion(0)
+	, mMaxPlayers(DefaultMaxPlayers)
+	, mTime(en::Time::Zero)
+	, mNetworkClock()
+	, mPositionHistory()
+	, mMaxRewind(en::Time::Zero)
+	, mRandom()
+	, mStepTimestep(DefaultStepInterval, DefaultMaxCatchUpSteps)
+	, mTickTimestep(DefaultTickInterval, DefaultMaxCatchUpTicks)
+	, mBulletTimestep(DefaultBulletInterval, 1)
+	, mLootTimestep(DefaultLootInterval, 1)
+	, mPingPlayerIndex(0)
+	, mPingTime(en::Time::Zero)
+	, mItemSpawnTime(en::Time::Zero)
+	, mProfile(nullptr)
+	, mReplayRecorder()
+	, mMetrics(nullptr)
+	, mReportedPlayers(0)
+	, mReportedSeeds(0)
+	, mReportedItems(0)
+	, mReportedBullets(0)
 {
+	mChickenGrid.Initialize(mMapSize, DefaultSpatialGridCellSize);
+	SetLagCompensationWindow(DefaultLagCompensationMaxRewind);
+	ReserveCapacity();
 }
 
 bool Server::Start(int argc, char** argv)
@@ -37,38 +82,34 @@ bool Server::Start(int argc, char** argv)
 		return false;
 	}
 
+	StartWorld();
+	return true;
+}
+
+void Server::Start(ServerSocket& network)
+{
+	mSocket.Attach(network);
+	StartWorld();
+}
+
+void Server::StartWorld()
+{
 	mMapSize.x = DefaultMapSizeX;
 	mMapSize.y = DefaultMapSizeY;
 
 	mRunning = true;
 
 	// Yes, it's an IA player, just to ensure you're not alone
-	Player newPlayer;
-	newPlayer.remoteAddress = sf::IpAddress::LocalHost;
-	newPlayer.remotePort = 0;
-	newPlayer.clientID = GenerateClientID(newPlayer.remoteAddress, newPlayer.remotePort);
-	newPlayer.lastPacketTime = en::Time::Zero;
-	newPlayer.nickname = "xXx_B0T_xXx";
-	newPlayer.chicken.position = GetRandomPositionSpawn();
-	newPlayer.chicken.rotation = 0.0f;
-	newPlayer.chicken.itemID = ItemID::None;
-	newPlayer.chicken.lifeMax = DefaultChickenLife;
-	newPlayer.chicken.life = DefaultChickenLife;
-	newPlayer.chicken.speed = DefaultChickenSpeed;
-	newPlayer.chicken.attack = DefaultChickenAttack;
-	newPlayer.chicken.kills = 0;// DefaultChickenAttack;
-	newPlayer.cooldown = en::Time::Zero;
-	mPlayers.push_back(newPlayer);
-
-	return true;
+	AddAIPlayer("xXx_B0T_xXx");
 }
 
 void Server::Stop()
 {
 	mRunning = false;
 
-	mSocket.SetBlocking(true);
-	sf::Packet stoppingPacket;
+	StopRecording();
+
+	PooledPacket stoppingPacket(mPacketPool);
 	stoppingPacket << static_cast<en::U8>(ServerPacketID::Stopping);
 	SendToAllPlayers(stoppingPacket);
 
@@ -78,114 +119,279 @@ void Server::Stop()
 bool Server::Run()
 {
 	en::Clock clock;
-	en::Time stepTime = en::Time::Zero;
-	en::Time tickTime = en::Time::Zero;
-
-	const en::Time stepInterval = DefaultStepInterval;
-	const en::Time tickInterval = DefaultTickInterval;
+	mStepTimestep.Reset();
+	mTickTimestep.Reset();
 	while (IsRunning())
 	{
 		const en::Time dt = clock.restart();
-		stepTime += dt;
-		tickTime += dt;
 
 		HandleIncomingPackets();
 
+		// Answers (join, ping...) leave now rather than with the next tick
+		SendReliablePackets();
+		mSocket.Flush();
+
 		if (mPlayers.size() <= 1)
 		{
-			sf::sleep(sf::seconds(0.2f));
-			continue;
+			// Nobody to play with, don't accumulate time meanwhile
+			mStepTimestep.Reset();
+			mTickTimestep.Reset();
 		}
-
-		while (stepTime >= stepInterval)
+		else
 		{
-			UpdateLogic(stepInterval);
-			stepTime -= stepInterval;
+			// After a hitch, only a few steps are run to catch up : the world slows down instead of spiraling
+			const en::U32 droppedSteps = mStepTimestep.GetDroppedStepCount();
+			const en::U32 droppedTicks = mTickTimestep.GetDroppedStepCount();
+			const en::U32 stepCount = mStepTimestep.Advance(dt);
+			const en::U32 tickCount = mTickTimestep.Advance(dt);
+			if (mStepTimestep.GetDroppedStepCount() != droppedSteps || mTickTimestep.GetDroppedStepCount() != droppedTicks)
+			{
+				LogWarning(en::LogChannel::All, 6, "Overrun : %d steps and %d ticks dropped", mStepTimestep.GetDroppedStepCount() - droppedSteps, mTickTimestep.GetDroppedStepCount() - droppedTicks);
+				if (mMetrics != nullptr)
+				{
+					mMetrics->overruns.Add();
+					mMetrics->droppedSteps.Add(mStepTimestep.GetDroppedStepCount() - droppedSteps);
+					mMetrics->droppedTicks.Add(mTickTimestep.GetDroppedStepCount() - droppedTicks);
+				}
+				if (mProfile != nullptr)
+				{
+					mProfile->overruns++;
+					mProfile->droppedSteps += mStepTimestep.GetDroppedStepCount() - droppedSteps;
+					mProfile->droppedTicks += mTickTimestep.GetDroppedStepCount() - droppedTicks;
+				}
+			}
+
+			Simulate(stepCount, tickCount);
 		}
 
-		while (tickTime >= tickInterval)
+		// The network thread keeps receiving while we sleep, so a join waits at most one step
+		const en::Time untilNextStep = mStepTimestep.GetRemainingTime();
+		if (untilNextStep > en::Time::Zero)
 		{
-			Tick(tickInterval);
-			tickTime -= tickInterval;
+			sf::sleep(sf::microseconds(untilNextStep.asMicroseconds()));
 		}
 	}
 	return true;
 }
 
+void Server::Simulate(en::U32 stepCount, en::U32 tickCount)
+{
+	mReplayRecorder.RecordSimulate(stepCount, tickCount);
+
+	if (mMetrics == nullptr)
+	{
+		for (en::U32 i = 0; i < stepCount; ++i)
+		{
+			UpdateLogic(DefaultStepInterval);
+		}
+		for (en::U32 i = 0; i < tickCount; ++i)
+		{
+			Tick(DefaultTickInterval);
+		}
+		return;
+	}
+
+	for (en::U32 i = 0; i < stepCount; ++i)
+	{
+		const en::Time start = en::Time::now();
+		UpdateLogic(DefaultStepInterval);
+		mMetrics->stepDuration.Record(static_cast<en::U64>((en::Time::now() - start).asMicroseconds()));
+	}
+	for (en::U32 i = 0; i < tickCount; ++i)
+	{
+		const en::Time start = en::Time::now();
+		Tick(DefaultTickInterval);
+		mMetrics->tickDuration.Record(static_cast<en::U64>((en::Time::now() - start).asMicroseconds()));
+	}
+}
+
+void Server::SetMetrics(ServerMetrics* metrics)
+{
+	// Take back what was added to the previous ones
+	if (mMetrics != nullptr)
+	{
+		mMetrics->players.Add(-mReportedPlayers);
+		mMetrics->seeds.Add(-mReportedSeeds);
+		mMetrics->items.Add(-mReportedItems);
+		mMetrics->bullets.Add(-mReportedBullets);
+	}
+	mMetrics = metrics;
+	mReportedPlayers = 0;
+	mReportedSeeds = 0;
+	mReportedItems = 0;
+	mReportedBullets = 0;
+	ReportMetrics();
+}
+
+void Server::ReportMetrics()
+{
+	if (mMetrics == nullptr)
+	{
+		return;
+	}
+	const auto report = [](en::MetricGauge& gauge, en::I64& reported, std::size_t count)
+	{
+		const en::I64 current = static_cast<en::I64>(count);
+		if (current != reported)
+		{
+			gauge.Add(current - reported);
+			reported = current;
+		}
+	};
+	report(mMetrics->players, mReportedPlayers, mPlayers.size());
+	report(mMetrics->seeds, mReportedSeeds, mSeeds.Size());
+	report(mMetrics->items, mReportedItems, mItems.Size());
+	report(mMetrics->bullets, mReportedBullets, mBullets.Size());
+}
+
+en::U32 Server::ComputeStateHash() const
+{
+	// FNV-1a over the simulated values
+	en::U32 hash = 2166136261u;
+	const auto combine = [&hash](const void* data, std::size_t size)
+	{
+		const en::U8* bytes = static_cast<const en::U8*>(data);
+		for (std::size_t i = 0; i < size; ++i)
+		{
+			hash = (hash ^ bytes[i]) * 16777619u;
+		}
+	};
+
+	const en::U32 playerCount = GetPlayerCount();
+	combine(&playerCount, sizeof(playerCount));
+	combine(mChickens.positions.data(), mChickens.positions.size() * sizeof(en::Vector2f));
+	combine(mChickens.rotations.data(), mChickens.rotations.size() * sizeof(en::F32));
+	combine(mChickens.lifes.data(), mChickens.lifes.size() * sizeof(en::F32));
+	combine(mChickens.itemIDs.data(), mChickens.itemIDs.size() * sizeof(ItemID));
+	combine(mChickens.kills.data(), mChickens.kills.size() * sizeof(en::U32));
+	for (const Seed& seed : mSeeds.GetValues())
+	{
+		combine(&seed.position, sizeof(seed.position));
+	}
+	for (const Item& item : mItems.GetValues())
+	{
+		combine(&item.position, sizeof(item.position));
+		combine(&item.itemID, sizeof(item.itemID));
+	}
+	for (const Bullet& bullet : mBullets.GetValues())
+	{
+		combine(&bullet.position, sizeof(bullet.position));
+	}
+	return hash;
+}
+
 bool Server::IsRunning() const
 {
 	return mRunning;
 }
 
+void Server::AddAIPlayer(const std::string& nickname)
+{
+	// AI players are identified by their remotePort 0, so the port is only used to get unique ClientIDs
+	const en::U16 aiIndex = static_cast<en::U16>(mPlayers.size());
+
+	Player newPlayer;
+	newPlayer.remoteAddress = sf::IpAddress::LocalHost;
+	newPlayer.remotePort = 0;
+	newPlayer.clientID = GenerateClientID(newPlayer.remoteAddress, aiIndex);
+	newPlayer.lastPacketTime = en::Time::Zero;
+	newPlayer.ackedSnapshot = 0;
+	newPlayer.roundTripTime = en::Time::Zero;
+	newPlayer.pingSentTime = -en::seconds(1.0f);
+	newPlayer.nickname = nickname;
+	AddPlayer(newPlayer, CreateChicken());
+}
+
 void Server::UpdateLogic(en::Time dt)
 {
 	const en::F32 dtSeconds = dt.asSeconds();
 
-	static en::U32 optim = 0;
-	optim++;
-	en::U32 c = optim % 3;
+	mTime += dt;
 
-	const en::U32 playerSize = static_cast<en::U32>(mPlayers.size());
-	for (en::U32 i = 0; i < playerSize; ++i)
 	{
-		mPlayers[i].lastPacketTime += dt;
-		if (mPlayers[i].remotePort == 0)
+		ServerProfileScope profileScope(mProfile, ServerPhase::Players);
+
+		UpdateChickenGrid();
+
+		const en::U32 playerSize = static_cast<en::U32>(mPlayers.size());
+		for (en::U32 i = 0; i < playerSize; ++i)
+		{
+			mPlayers[i].lastPacketTime += dt;
+			if (mPlayers[i].remotePort == 0)
+			{
+				mPlayers[i].lastPacketTime = en::Time::Zero;
+				UpdateAIPlayer(dtSeconds, i);
+			}
+		}
+
+		en::F32* cooldowns = mChickens.cooldowns.data();
+		for (en::U32 i = 0; i < playerSize; ++i)
 		{
-			mPlayers[i].lastPacketTime = en::Time::Zero;
-			UpdateAIPlayer(dtSeconds, mPlayers[i]);
+			cooldowns[i] += dtSeconds;
 		}
 
-		UpdatePlayer(dtSeconds, mPlayers[i]);
+		for (en::U32 i = 0; i < playerSize; ++i)
+		{
+			UpdatePlayer(dtSeconds, i);
+		}
+
+		mPositionHistory.Record(mTime, mChickens.positions.data(), playerSize);
 	}
 
-	if (c == 0)
+	// Each subsystem at its own rate, in simulated time so it doesn't depend on how the steps are scheduled
+	const en::U32 bulletSteps = mBulletTimestep.Advance(dt);
+	for (en::U32 i = 0; i < bulletSteps; ++i)
 	{
-		UpdateBullets(dt);
+		ServerProfileScope profileScope(mProfile, ServerPhase::Bullets);
+		UpdateBullets(mBulletTimestep.GetInterval());
 	}
-	else if (c == 1)
+	const en::U32 lootSteps = mLootTimestep.Advance(dt);
+	for (en::U32 i = 0; i < lootSteps; ++i)
 	{
-		UpdateLoots(dt);
-	}
-	else
-	{
-		// See abovve
+		ServerProfileScope profileScope(mProfile, ServerPhase::Loots);
+		UpdateLoots(mLootTimestep.GetInterval());
 	}
 }
 
 void Server::Tick(en::Time dt)
 {
+	ServerProfileScope profileScope(mProfile, ServerPhase::Tick);
+
+	ReportMetrics();
+
+	BuildSnapshot();
+
+	// The cached PlayerList has the chickens as they were, a joiner would see the far ones there until they come into view
+	mPlayersVersion++;
+
 	en::U32 size = static_cast<en::U32>(mPlayers.size());
 	if (size <= 1)
 	{
+		mSocket.Flush();
 		return;
 	}
 
-	static en::U32 playerPingPacket;
-	static en::Time antiTimeout; 
-	antiTimeout += dt;
+	mPingTime += dt;
 	en::Time pingPacketTime = en::seconds(1.0f / mPlayers.size());
-	if (antiTimeout >= pingPacketTime)
+	if (mPingTime >= pingPacketTime)
 	{
-		playerPingPacket = static_cast<en::U32>(playerPingPacket + 1) % static_cast<en::U32>(mPlayers.size());
-		SendPingPacket(mPlayers[playerPingPacket].remoteAddress, mPlayers[playerPingPacket].remotePort);
-		antiTimeout = en::Time::Zero;
+		mPingPlayerIndex = static_cast<en::U32>(mPingPlayerIndex + 1) % static_cast<en::U32>(mPlayers.size());
+		SendPingPacket(mPlayers[mPingPlayerIndex].remoteAddress, mPlayers[mPingPlayerIndex].remotePort);
+		mPlayers[mPingPlayerIndex].pingSentTime = mTime;
+		mPingTime = en::Time::Zero;
 	}
 
+	SendSnapshots();
+
 	for (en::U32 i = 0; i < size; )
 	{
-		if (mPlayers[i].needUpdate)
-		{
-			SendUpdateChickenPacket(mPlayers[i].clientID, mPlayers[i].chicken);
-			mPlayers[i].needUpdate = false;
-		}
-
 		// Timeout detection
 		if (mPlayers[i].lastPacketTime > DefaultServerTimeout && mPlayers[i].remotePort != 0)
 		{
 			LogInfo(en::LogChannel::All, 2, "Player %d timeouted", mPlayers[i].clientID);
 			SendConnectionRejectedPacket(mPlayers[i].remoteAddress, mPlayers[i].remotePort, RejectReason::Timeout);
 			SendClientLeftPacket(mPlayers[i].clientID);
-			mPlayers.erase(mPlayers.begin() + i);
+			RemovePlayer(i);
 			size--;
 		}
 		else
@@ -193,179 +399,264 @@ void Server::Tick(en::Time dt)
 			i++;
 		}
 	}
+
+	// Everything sent during this tick, batched per client
+	SendReliablePackets();
+	mSocket.Flush();
 }
 
 void Server::HandleIncomingPackets()
 {
-	sf::Packet receivedPacket;
 	sf::IpAddress remoteAddress;
 	en::U16 remotePort;
-	while (mSocket.PollPacket(receivedPacket, remoteAddress, remotePort))
+	while (mSocket.PollPacket(mReceivedPacket, remoteAddress, remotePort))
 	{
-		bool ignorePacket = false;
+		HandlePacket(mReceivedPacket, remoteAddress, remotePort);
+	}
+}
 
-		en::U8 packetIDRaw;
-		receivedPacket >> packetIDRaw;
-		if (packetIDRaw >= static_cast<en::U8>(ClientPacketID::Count))
-		{
-			ignorePacket = true;
-		}
+void Server::HandlePacket(sf::Packet& receivedPacket, const sf::IpAddress& remoteAddress, en::U16 remotePort)
+{
+	mReplayRecorder.RecordPacket(receivedPacket, remoteAddress, remotePort);
+	ProcessPacket(receivedPacket, remoteAddress, remotePort);
+}
 
-		UpdateLastPacketTime(remoteAddress, remotePort);
+bool Server::StartRecording(const std::string& path)
+{
+	return mReplayRecorder.Open(path, GetReplaySettings());
+}
 
-		const ClientPacketID packetID = static_cast<ClientPacketID>(packetIDRaw);
-		switch (packetID)
-		{
-		case ClientPacketID::Ping:
-		{
-			SendPongPacket(remoteAddress, remotePort);
-		} break;
-		case ClientPacketID::Pong:
-		{
-		} break;
-		case ClientPacketID::Join:
-		{
-			std::string nickname = "";
-			receivedPacket >> nickname;
-			const en::U32 clientID = GenerateClientID(remoteAddress, remotePort);
-			const en::I32 playerIndex = GetPlayerIndexFromClientID(clientID);
-			const bool slotAvailable = (mPlayers.size() < DefaultMaxPlayers);
-			const bool blacklisted = IsBlacklisted(remoteAddress);
-			if (slotAvailable && !blacklisted && playerIndex == -1)
-			{
-				LogInfo(en::LogChannel::All, 5, "Player joined ClientID %d from %s:%d", clientID, remoteAddress.toString().c_str(), remotePort);
-
-				Player newPlayer;
-				newPlayer.remoteAddress = remoteAddress;
-				newPlayer.remotePort = remotePort;
-				newPlayer.clientID = clientID;
-				newPlayer.lastPacketTime = -DefaultServerTimeout;
-				if (nickname.size() == 0)
-				{
-					newPlayer.nickname = "Player" + std::to_string(clientID % 6678);
-				}
-				else
-				{
-					newPlayer.nickname = nickname;
-				}
-				newPlayer.chicken.position = GetRandomPositionSpawn();
-				newPlayer.chicken.rotation = 0.0f;
-				newPlayer.chicken.kills = 0;// DefaultChickenAttack;
-				newPlayer.chicken.itemID = ItemID::None;
-				newPlayer.chicken.lifeMax = DefaultChickenLife;
-				newPlayer.chicken.life = DefaultChickenLife;
-				newPlayer.chicken.speed = DefaultChickenSpeed;
-				newPlayer.chicken.attack = DefaultChickenAttack;
-				newPlayer.cooldown = en::Time::Zero;
-
-				SendConnectionAcceptedPacket(remoteAddress, remotePort, clientID);
-
-				const en::U32 playerSize = static_cast<en::U32>(mPlayers.size());
-				for (en::U32 i = 0; i < playerSize; ++i)
-				{
-					SendPlayerInfo(remoteAddress, remotePort, mPlayers[i]);
-				}
-				const en::U32 itemSize = static_cast<en::U32>(mItems.size());
-				for (en::U32 i = 0; i < itemSize; ++i)
-				{
-					SendItemInfo(remoteAddress, remotePort, mItems[i]);
-				}
+void Server::StopRecording()
+{
+	if (mReplayRecorder.IsOpen())
+	{
+		// Checked at the end of the playback
+		mReplayRecorder.RecordStateHash(ComputeStateHash());
+		mReplayRecorder.Close();
+	}
+}
 
-				mPlayers.push_back(newPlayer);
+ReplaySettings Server::GetReplaySettings() const
+{
+	ReplaySettings settings;
+	settings.seed = GetRandomSeed();
+	settings.maxPlayers = mMaxPlayers;
+	settings.lagCompensationWindow = static_cast<en::U32>(mMaxRewind.asMilliseconds());
+	return settings;
+}
 
-				SendClientJoinedPacket(clientID, newPlayer.nickname, newPlayer.chicken);
-			}
-			else if (playerIndex == -1)
-			{
-				if (!slotAvailable)
-				{
-					LogInfo(en::LogChannel::All, 5, "Player can't join because maximum reached %s:%d", remoteAddress.toString().c_str(), remotePort);
-					SendConnectionRejectedPacket(remoteAddress, remotePort, RejectReason::TooManyPlayers);
-				}
-				else if (blacklisted)
-				{
-					LogInfo(en::LogChannel::All, 5, "Player can't join because banned %s:%d", remoteAddress.toString().c_str(), remotePort);
-					SendConnectionRejectedPacket(remoteAddress, remotePort, RejectReason::Blacklisted);
-				}
-				else
-				{
-					// Might be :
-					// - Already connected
-					LogInfo(en::LogChannel::All, 5, "Player can't join for unknown reason %s:%d", remoteAddress.toString().c_str(), remotePort);
-					SendConnectionRejectedPacket(remoteAddress, remotePort, RejectReason::UnknownError);
-				}
-			}
+void Server::ProcessPacket(sf::Packet& receivedPacket, const sf::IpAddress& remoteAddress, en::U16 remotePort)
+{
+	bool ignorePacket = false;
 
-			LogInfo(en::LogChannel::All, 5, "%d players connected", mPlayers.size());
+	en::U8 packetIDRaw;
+	receivedPacket >> packetIDRaw;
+	if (packetIDRaw >= static_cast<en::U8>(ClientPacketID::Count))
+	{
+		ignorePacket = true;
+	}
 
+	// Only one lookup per packet, Join is the only packet that adds a player
+	en::I32 senderIndex = -1;
+	const en::U32 senderClientID = GetClientIDFromIpAddress(remoteAddress, remotePort, &senderIndex);
+	if (senderIndex >= 0)
+	{
+		mPlayers[senderIndex].lastPacketTime = en::Time::Zero;
+	}
 
-		} break;
-		case ClientPacketID::Leave:
+	const ClientPacketID packetID = static_cast<ClientPacketID>(packetIDRaw);
+	switch (packetID)
+	{
+	case ClientPacketID::Ping:
+	{
+		SendPongPacket(remoteAddress, remotePort);
+	} break;
+	case ClientPacketID::Pong:
+	{
+		// Measured in steps, like the rewind it is used for
+		if (senderIndex >= 0 && mPlayers[senderIndex].pingSentTime >= en::Time::Zero)
+		{
+			Player& player = mPlayers[senderIndex];
+			const en::Time sample = mTime - player.pingSentTime;
+			player.roundTripTime = (player.roundTripTime == en::Time::Zero) ? sample : en::seconds(0.875f * player.roundTripTime.asSeconds() + 0.125f * sample.asSeconds());
+			player.pingSentTime = -en::seconds(1.0f);
+		}
+	} break;
+	case ClientPacketID::Join:
+	{
+		std::string nickname = "";
+		receivedPacket >> nickname;
+		const en::U32 clientID = GenerateClientID(remoteAddress, remotePort);
+		const en::I32 playerIndex = (senderIndex >= 0) ? senderIndex : GetPlayerIndexFromClientID(clientID);
+		const bool slotAvailable = (mPlayers.size() < mMaxPlayers);
+		const bool blacklisted = IsBlacklisted(remoteAddress);
+		if (slotAvailable && !blacklisted && playerIndex == -1)
 		{
-			en::I32 playerIndex = -1;
-			const en::U32 clientID = GetClientIDFromIpAddress(remoteAddress, remotePort, &playerIndex);
-			if (clientID != en::U32_Max)
+			LogInfo(en::LogChannel::All, 5, "Player joined ClientID %d from %s:%d", clientID, remoteAddress.toString().c_str(), remotePort);
+
+			Player newPlayer;
+			newPlayer.remoteAddress = remoteAddress;
+			newPlayer.remotePort = remotePort;
+			newPlayer.clientID = clientID;
+			newPlayer.lastPacketTime = -DefaultServerTimeout;
+			newPlayer.ackedSnapshot = 0;
+			newPlayer.roundTripTime = en::Time::Zero;
+			newPlayer.pingSentTime = -en::seconds(1.0f);
+			if (nickname.size() == 0)
 			{
-				LogInfo(en::LogChannel::All, 5, "Player left ClientID %d from %s:%d", clientID, remoteAddress.toString().c_str(), remotePort);
-				SendClientLeftPacket(clientID);
-				if (playerIndex >= 0)
-				{
-					mPlayers.erase(mPlayers.begin() + playerIndex);
-				}
+				newPlayer.nickname = "Player" + std::to_string(clientID % 6678);
 			}
 			else
 			{
-				LogInfo(en::LogChannel::All, 5, "Unknown player left from %s:%d", remoteAddress.toString().c_str(), remotePort);
-				ignorePacket = true;
+				newPlayer.nickname = nickname;
 			}
-		} break;
+			const Chicken newChicken = CreateChicken();
+
+			// Added first for its ReliableEndpoint, the client gets the messages in this order
+			const en::U32 newPlayerIndex = static_cast<en::U32>(mPlayers.size());
+			AddPlayer(newPlayer, newChicken);
 
-		case ClientPacketID::DropSeed:
+			SendConnectionAcceptedPacket(newPlayerIndex);
+			SendPlayerList(newPlayerIndex);
+
+			SendClientJoinedPacket(clientID, newPlayer.nickname, newChicken);
+		}
+		else if (playerIndex == -1)
 		{
-			en::U32 clientID;
-			en::Vector2f position;
-			receivedPacket >> clientID >> position.x >> position.y;
-			if (IsClientIDAssignedToThisPlayer(clientID, remoteAddress, remotePort))
+			if (!slotAvailable)
 			{
-				const en::I32 playerIndex = GetPlayerIndexFromClientID(clientID);
-				if (playerIndex >= 0 && IsInMap(position))
-				{
-					//LogInfo(en::LogChannel::All, 2, "Player %d dropped seed at %f %f", mPlayers[playerIndex].clientID, position.x, position.y);
-					AddNewSeed(position, clientID);
-				}
-				else
-				{
-					ignorePacket = true;
-				}
+				LogInfo(en::LogChannel::All, 5, "Player can't join because maximum reached %s:%d", remoteAddress.toString().c_str(), remotePort);
+				SendConnectionRejectedPacket(remoteAddress, remotePort, RejectReason::TooManyPlayers);
+			}
+			else if (blacklisted)
+			{
+				LogInfo(en::LogChannel::All, 5, "Player can't join because banned %s:%d", remoteAddress.toString().c_str(), remotePort);
+				SendConnectionRejectedPacket(remoteAddress, remotePort, RejectReason::Blacklisted);
 			}
 			else
 			{
-				ignorePacket = true;
+				// Might be :
+				// - Already connected
+				LogInfo(en::LogChannel::All, 5, "Player can't join for unknown reason %s:%d", remoteAddress.toString().c_str(), remotePort);
+				SendConnectionRejectedPacket(remoteAddress, remotePort, RejectReason::UnknownError);
 			}
-		} break;
+		}
+
+		LogInfo(en::LogChannel::All, 5, "%d players connected", mPlayers.size());
 
-		default:
+
+	} break;
+	case ClientPacketID::Leave:
+	{
+		if (senderIndex >= 0)
+		{
+			LogInfo(en::LogChannel::All, 5, "Player left ClientID %d from %s:%d", senderClientID, remoteAddress.toString().c_str(), remotePort);
+			SendClientLeftPacket(senderClientID);
+			RemovePlayer(static_cast<en::U32>(senderIndex));
+		}
+		else
 		{
-			LogWarning(en::LogChannel::All, 6, "Unknown ClientPacketID %d received from %s:%d", packetIDRaw, remoteAddress.toString().c_str(), remotePort);
+			LogInfo(en::LogChannel::All, 5, "Unknown player left from %s:%d", remoteAddress.toString().c_str(), remotePort);
 			ignorePacket = true;
-		} break;
 		}
+	} break;
 
-		if (ignorePacket)
+	case ClientPacketID::DropSeed:
+	{
+		en::U32 clientID;
+		en::Vector2f position;
+		receivedPacket >> clientID >> position.x >> position.y;
+		if (senderIndex >= 0 && senderClientID == clientID && IsInMap(position))
 		{
-			LogWarning(en::LogChannel::All, 4, "Ignore packet %d from %s:%d", packetIDRaw, remoteAddress.toString().c_str(), remotePort);
+			//LogInfo(en::LogChannel::All, 2, "Player %d dropped seed at %f %f", mPlayers[senderIndex].clientID, position.x, position.y);
+			AddNewSeed(position, static_cast<en::U32>(senderIndex));
+		}
+		else
+		{
+			ignorePacket = true;
 		}
+	} break;
+
+	case ClientPacketID::Reliable:
+	{
+		if (senderIndex >= 0 && mPlayers[senderIndex].reliable.ReadPacket(static_cast<const char*>(receivedPacket.getData()) + 1, receivedPacket.getDataSize() - 1, mNetworkClock.getElapsedTime()))
+		{
+			HandleReliableMessages(remoteAddress, remotePort);
+		}
+		else
+		{
+			ignorePacket = true;
+		}
+	} break;
+
+	case ClientPacketID::SnapshotAck:
+	{
+		en::U32 sequence;
+		receivedPacket >> sequence;
+		if (senderIndex >= 0 && sequence <= mSnapshotSequence && sequence > mPlayers[senderIndex].ackedSnapshot)
+		{
+			mPlayers[senderIndex].ackedSnapshot = sequence;
+		}
+		else
+		{
+			ignorePacket = true;
+		}
+	} break;
+
+	default:
+	{
+		LogWarning(en::LogChannel::All, 6, "Unknown ClientPacketID %d received from %s:%d", packetIDRaw, remoteAddress.toString().c_str(), remotePort);
+		ignorePacket = true;
+	} break;
+	}
+
+	if (ignorePacket)
+	{
+		LogWarning(en::LogChannel::All, 4, "Ignore packet %d from %s:%d", packetIDRaw, remoteAddress.toString().c_str(), remotePort);
+	}
+}
+
+void Server::HandleReliableMessages(const sf::IpAddress& remoteAddress, en::U16 remotePort)
+{
+	// A message can remove the player (Leave), or move it (another one left), so it is looked up for each message
+	const en::U64 endpointKey = GetEndpointKey(remoteAddress, remotePort);
+	for (auto itr = mEndpointToPlayer.find(endpointKey); itr != mEndpointToPlayer.end() && mPlayers[itr->second].reliable.PollMessage(mReliableMessage); itr = mEndpointToPlayer.find(endpointKey))
+	{
+		const bool nested = mReliableMessage.getDataSize() > 0 && static_cast<const en::U8*>(mReliableMessage.getData())[0] == static_cast<en::U8>(ClientPacketID::Reliable);
+		if (!nested)
+		{
+			// Already recorded with the Reliable packet
+			ProcessPacket(mReliableMessage, remoteAddress, remotePort);
+		}
+	}
+}
+
+void Server::UpdateChickenGrid()
+{
+	mChickenGrid.Clear();
+	const en::U32 chickenSize = mChickens.Size();
+	const en::Vector2f* positions = mChickens.positions.data();
+	for (en::U32 i = 0; i < chickenSize; ++i)
+	{
+		mChickenGrid.Insert(i, positions[i]);
 	}
 }
 
-void Server::UpdatePlayer(en::F32 dtSeconds, Player& player)
+void Server::UpdatePlayer(en::F32 dtSeconds, en::U32 playerIndex)
 {
-	en::Vector2f deltaSeed;
-	en::I32 bestSeedIndex = Seed::GetBestSeedIndex(player.clientID, player.chicken.position, mSeeds, deltaSeed);
+	ChickenArrays& chickens = mChickens;
+	const en::U32 clientID = chickens.clientIDs[playerIndex];
+	en::Vector2f& position = chickens.positions[playerIndex];
+	en::F32& rotation = chickens.rotations[playerIndex];
+	const ItemID itemID = chickens.itemIDs[playerIndex];
+
+	// Each chicken follows at most its own seed, AddNewSeed replaces the previous one
+	const Seed* seed = mSeeds.Get(chickens.seedUIDs[playerIndex]);
 
 	// Rotate
-	if (bestSeedIndex >= 0)
+	if (seed != nullptr)
 	{
+		en::Vector2f deltaSeed = seed->position - position;
 		const bool tooClose = (deltaSeed.getSquaredLength() < DefaultTooCloseDistanceSqr);
 
 		if (deltaSeed.x == 0.0f)
@@ -373,7 +664,7 @@ void Server::UpdatePlayer(en::F32 dtSeconds, Player& player)
 			deltaSeed.x += 0.001f;
 		}
 		en::F32 targetAngle = en::Math::AngleMagnitude(deltaSeed.getPolarAngle());
-		const en::F32 currentAngle = en::Math::AngleMagnitude(player.chicken.rotation);
+		const en::F32 currentAngle = en::Math::AngleMagnitude(rotation);
 		const en::F32 angleWithTarget = en::Math::AngleBetween(currentAngle, targetAngle);
 		if (angleWithTarget > DefaultIgnoreRotDeg)
 		{
@@ -387,22 +678,24 @@ void Server::UpdatePlayer(en::F32 dtSeconds, Player& player)
 			// Rotation speed factor
 			const en::F32 rotSpeedFactor = tooClose ? 2.0f : 1.0f;
 
-			player.chicken.rotation = en::Math::AngleMagnitude(player.chicken.rotation + sign * rotSpeedFactor * DefaultRotDegPerSecond * dtSeconds);
+			rotation = en::Math::AngleMagnitude(rotation + sign * rotSpeedFactor * DefaultRotDegPerSecond * dtSeconds);
 		}
 
 		// Mvt speed factor
 		const en::F32 mvtSpeedFactor = tooClose ? 1.0f : 0.75f;
 
-		player.chicken.position += en::Vector2f::polar(player.chicken.rotation) * (dtSeconds * mvtSpeedFactor * player.chicken.speed * GetItemWeight(player.chicken.itemID));
-		player.needUpdate = true;
+		const en::Vector2f oldPosition = position;
+		position += en::Vector2f::polar(rotation) * (dtSeconds * mvtSpeedFactor * chickens.speeds[playerIndex] * GetItemWeight(itemID));
+		mChickenGrid.Move(playerIndex, oldPosition, position);
 
 		// Eat seed
-		const en::Vector2f deltaSeed2 = mSeeds[bestSeedIndex].position - player.chicken.position;
+		const en::Vector2f deltaSeed2 = seed->position - position;
 		const en::F32 distanceSqr = deltaSeed2.getSquaredLength();
 		if (distanceSqr < DefaultItemPickUpDistanceSqr)
 		{
-			SendRemoveSeedPacket(mSeeds[bestSeedIndex].seedUID, true, player.clientID);
-			mSeeds.erase(mSeeds.begin() + bestSeedIndex);
+			AddEvent(SnapshotEventType::EatSeed, clientID, 0, ItemID::None, seed->position);
+			mSeeds.Remove(chickens.seedUIDs[playerIndex]);
+			chickens.seedUIDs[playerIndex] = 0;
 		}
 	}
 
@@ -410,13 +703,13 @@ void Server::UpdatePlayer(en::F32 dtSeconds, Player& player)
 	en::I32 bestTargetIndex = -1;
 	en::F32 bestTargetDistanceSqr = 999999.0f;
 	en::Vector2f bestDeltaTarget;
-	const en::U32 playerSize = static_cast<en::U32>(mPlayers.size());
-	for (en::U32 i = 0; i < playerSize; ++i)
+	const en::Vector2f* positions = chickens.positions.data();
+	const en::U32* clientIDs = chickens.clientIDs.data();
+	mChickenGrid.Query(position, DefaultTargetDetectionMaxDistance, [&](en::U32 i)
 	{
-		const Player& otherPlayer = mPlayers[i];
-		if (otherPlayer.clientID != player.clientID)
+		if (clientIDs[i] != clientID)
 		{
-			const en::Vector2f deltaTarget = otherPlayer.chicken.position - player.chicken.position;
+			const en::Vector2f deltaTarget = positions[i] - position;
 			const en::F32 distanceSqr = deltaTarget.getSquaredLength();
 			if (distanceSqr < bestTargetDistanceSqr && distanceSqr < DefaultTargetDetectionMaxDistanceSqr)
 			{
@@ -425,75 +718,54 @@ void Server::UpdatePlayer(en::F32 dtSeconds, Player& player)
 				bestDeltaTarget = deltaTarget;
 			}
 		}
-	}
+	});
 	// Try to shoot bullet
-	player.cooldown += en::seconds(dtSeconds);
 	if (bestTargetIndex >= 0)
 	{
-		en::Time cooldown = GetItemCooldown(player.chicken.itemID);
-		if (IsValidItemForAttack(player.chicken.itemID) && player.cooldown >= cooldown)
+		const en::F32 cooldown = GetItemCooldown(itemID).asSeconds();
+		if (IsValidItemForAttack(itemID) && chickens.cooldowns[playerIndex] >= cooldown)
 		{
-			en::F32 range = GetItemRange(player.chicken.itemID);
+			en::F32 range = GetItemRange(itemID);
 			const en::F32 rangeSqr = (range + 15.0f) * (range + 15.0f); // Hack because we don't care exactly the offset in fact
 			if (bestTargetDistanceSqr < rangeSqr)
 			{
 				static const en::F32 cos = en::Math::Cos(30.0f);
-				const en::Vector2f forward = en::Vector2f::polar(player.chicken.rotation);
+				const en::Vector2f forward = en::Vector2f::polar(rotation);
 				const en::F32 distance = en::Math::Sqrt(bestTargetDistanceSqr);
 				const en::Vector2f normalizedDelta = en::Vector2f(bestDeltaTarget.x / distance, bestDeltaTarget.y / distance);
 				const en::F32 dotProduct = forward.dotProduct(normalizedDelta);
 				if (dotProduct > cos)
 				{
-					en::Vector2f rotatedWeaponOffset = en::Vector2f(DefaultWeaponOffset).rotated(player.chicken.rotation);
-					player.cooldown = en::Time::Zero;
-					AddNewBullet(player.chicken.position + rotatedWeaponOffset, bestDeltaTarget.getPolarAngle(), player.clientID, player.chicken.itemID, range);
+					en::Vector2f rotatedWeaponOffset = en::Vector2f(DefaultWeaponOffset).rotated(rotation);
+					chickens.cooldowns[playerIndex] = 0.0f;
+					AddNewBullet(position + rotatedWeaponOffset, bestDeltaTarget.getPolarAngle(), clientID, itemID, range);
 				}
 			}
 		}
 	}
 }
 
-void Server::UpdateAIPlayer(en::F32 dtSeconds, Player& player)
+void Server::UpdateAIPlayer(en::F32 dtSeconds, en::U32 playerIndex)
 {
-	en::I32 aiSeedIndex = -1;
-	en::U32 seedSize = static_cast<en::U32>(mSeeds.size());
-	for (en::U32 i = 0; i < seedSize; ++i)
-	{
-		if (mSeeds[i].clientID == player.clientID)
-		{
-			aiSeedIndex = static_cast<en::I32>(i);
-			break;
-		}
-	}
-	if (aiSeedIndex < 0)
+	if (mChickens.seedUIDs[playerIndex] == 0)
 	{
-		if (player.chicken.itemID == ItemID::None && mItems.size() > 0)
+		if (mChickens.itemIDs[playerIndex] == ItemID::None && !mItems.Empty())
 		{
-			AddNewSeed(mItems[0].position, player.clientID); // Find random item
+			AddNewSeed(mItems[0].position, playerIndex); // Find random item
 		}
 		else
 		{
-			en::F32 bestDistanceSqr = 999999999999.0f;
-			en::Vector2f bestPlayerPos;
-			en::U32 playerSize = static_cast<en::U32>(mPlayers.size());
-			for (en::U32 i = 0; i < playerSize; ++i)
+			const en::U32 clientID = mChickens.clientIDs[playerIndex];
+			const en::Vector2f position = mChickens.positions[playerIndex];
+			const en::I32 bestPlayerIndex = mChickenGrid.QueryNearest(position, [&](en::U32 i)
 			{
-				if (mPlayers[i].clientID != player.clientID)
-				{
-					const en::Vector2f delta = (mPlayers[i].chicken.position - player.chicken.position);
-					const en::F32 distanceSqr = delta.getSquaredLength();
-					if (distanceSqr < bestDistanceSqr)
-					{
-						bestDistanceSqr = distanceSqr;
-						bestPlayerPos = mPlayers[i].chicken.position;
-					}
-				}
-			}
-			if (bestDistanceSqr < 99999999999.0f)
+				return (mChickens.clientIDs[i] != clientID) ? (mChickens.positions[i] - position).getSquaredLength() : -1.0f;
+			});
+			if (bestPlayerIndex >= 0)
 			{
-				const en::F32 rX = en::Random::get<en::F32>(-300.0f, 300.0f);
-				const en::F32 rY = en::Random::get<en::F32>(-300.0f, 300.0f);
-				AddNewSeed(bestPlayerPos + en::Vector2f(rX, rY), player.clientID); // Go near the enemy
+				const en::F32 rX = mRandom.get<en::F32>(-300.0f, 300.0f);
+				const en::F32 rY = mRandom.get<en::F32>(-300.0f, 300.0f);
+				AddNewSeed(mChickens.positions[bestPlayerIndex] + en::Vector2f(rX, rY), playerIndex); // Go near the enemy
 			}
 		}
 	}
@@ -506,7 +778,7 @@ void Server::UpdateAIPlayer(en::F32 dtSeconds, Player& player)
 void Server::UpdateBullets(en::Time dt)
 {
 	const en::F32 dtSeconds = dt.asSeconds();
-	en::U32 bulletSize = static_cast<en::U32>(mBullets.size());
+	en::U32 bulletSize = mBullets.Size();
 	for (en::U32 i = 0; i < bulletSize; )
 	{
 		bool remove = mBullets[i].Update(dtSeconds);
@@ -514,56 +786,35 @@ void Server::UpdateBullets(en::Time dt)
 
 		if (!remove)
 		{
-			const en::U32 size = static_cast<en::U32>(mPlayers.size());
-			for (en::U32 j = 0; j < size && !remove; ++j)
-			{
-				if (mBullets[i].clientID != mPlayers[j].clientID && (mPlayers[j].chicken.position - mBullets[i].position).getSquaredLength() < DefaultDetectionRadiusSqr)
-				{
-					remove = true;
-					playerHitIndex = j;
-				}
-			}
+			const Bullet& bullet = mBullets[i];
+			playerHitIndex = FindBulletHit(bullet.position, bullet.clientID, mTime - GetRewindTime(bullet.clientID));
+			remove = (playerHitIndex != en::U32_Max);
 		}
 
+		// Hits, respawns and kills are replicated by the snapshots, the clients find the best killer from the kills
 		if (playerHitIndex != en::U32_Max)
 		{
-			SendHitChickenPacket(mPlayers[playerHitIndex].clientID, mBullets[i].clientID);
-			mPlayers[playerHitIndex].chicken.life -= DefaultChickenAttack * GetItemAttack(mBullets[i].itemID);
-			mPlayers[playerHitIndex].needUpdate = true;
-			if (mPlayers[playerHitIndex].chicken.life <= 0.0f)
+			mChickens.lifes[playerHitIndex] -= DefaultChickenAttack * GetItemAttack(mBullets[i].itemID);
+			if (mChickens.lifes[playerHitIndex] <= 0.0f)
 			{
-				SendKillChickenPacket(mPlayers[playerHitIndex].clientID, mBullets[i].clientID);
-				mPlayers[playerHitIndex].chicken.life = DefaultChickenLife;
-				mPlayers[playerHitIndex].chicken.position = GetRandomPositionSpawn();
-				mPlayers[playerHitIndex].needUpdate = true; 
-				SendRespawnChickenPacket(mPlayers[playerHitIndex].clientID, mPlayers[playerHitIndex].chicken.position);
-
-				en::U32 bestKills = 0;
-				en::I32 bestKillerIndex = -1;
-				const en::U32 size = static_cast<en::U32>(mPlayers.size());
-				for (en::U32 j = 0; j < size; ++j)
-				{
-					if (mPlayers[j].clientID == mBullets[i].clientID)
-					{
-						mPlayers[j].chicken.kills++;
-						mPlayers[j].needUpdate = true;
- 					}
-					if (mPlayers[j].chicken.kills > bestKills)
-					{
-						bestKills = mPlayers[j].chicken.kills;
-						bestKillerIndex = static_cast<en::I32>(j);
-					}
-				}
-				if (bestKillerIndex >= 0)
+				AddEvent(SnapshotEventType::KillChicken, mChickens.clientIDs[playerHitIndex], mBullets[i].clientID, ItemID::None, mChickens.positions[playerHitIndex]);
+				const en::Vector2f oldPosition = mChickens.positions[playerHitIndex];
+				mChickens.lifes[playerHitIndex] = DefaultChickenLife;
+				mChickens.positions[playerHitIndex] = GetRandomPositionSpawn();
+				mChickenGrid.Move(playerHitIndex, oldPosition, mChickens.positions[playerHitIndex]);
+				mPositionHistory.Reset(playerHitIndex, mChickens.positions[playerHitIndex], mTime);
+
+				const en::I32 killerIndex = GetPlayerIndexFromClientID(mBullets[i].clientID);
+				if (killerIndex >= 0)
 				{
-					SendServerInfo(mPlayers[bestKillerIndex].nickname, bestKills);
+					mChickens.kills[killerIndex]++;
 				}
 			}
 		}
 
 		if (remove)
 		{
-			mBullets.erase(mBullets.begin() + i);
+			mBullets.RemoveAt(i);
 			bulletSize--;
 		}
 		else
@@ -573,88 +824,140 @@ void Server::UpdateBullets(en::Time dt)
 	}
 }
 
+en::U32 Server::FindBulletHit(const en::Vector2f& position, en::U32 shooterClientID, en::Time time) const
+{
+	// Keep the lowest index to hit the same chicken as a linear scan would
+	const en::U32* clientIDs = mChickens.clientIDs.data();
+	en::U32 playerHitIndex = en::U32_Max;
+	if (time >= mTime)
+	{
+		const en::Vector2f* positions = mChickens.positions.data();
+		mChickenGrid.Query(position, DefaultDetectionRadius, [&](en::U32 j)
+		{
+			if (j < playerHitIndex && shooterClientID != clientIDs[j] && (positions[j] - position).getSquaredLength() < DefaultDetectionRadiusSqr)
+			{
+				playerHitIndex = j;
+			}
+		});
+	}
+	else
+	{
+		// The grid has the current positions : widen the query by how far any chicken moved since time
+		// Chickens that respawned after time were somewhere else, and dead, when the shooter saw them
+		const en::F32 radius = DefaultDetectionRadius + mPositionHistory.GetMaxDistanceSince(time);
+		mChickenGrid.Query(position, radius, [&](en::U32 j)
+		{
+			if (j < playerHitIndex && shooterClientID != clientIDs[j] && time >= mPositionHistory.GetSpawnTime(j) && (mPositionHistory.GetPosition(j, time) - position).getSquaredLength() < DefaultDetectionRadiusSqr)
+			{
+				playerHitIndex = j;
+			}
+		});
+	}
+	return playerHitIndex;
+}
+
+// Half the round trip for the shot to arrive, plus the interpolation delay the shooter sees the others with
+en::Time Server::GetRewindTime(en::U32 shooterClientID) const
+{
+	const en::I32 shooterIndex = GetPlayerIndexFromClientID(shooterClientID);
+	if (shooterIndex < 0 || mPlayers[shooterIndex].remotePort == 0)
+	{
+		return en::Time::Zero; // AI players see the current positions, left players don't matter anymore
+	}
+	const en::Time rewind = en::seconds(mPlayers[shooterIndex].roundTripTime.asSeconds() * 0.5f) + DefaultInterpolationDelay;
+	return (rewind < mMaxRewind) ? rewind : mMaxRewind;
+}
+
+void Server::SetLagCompensationWindow(en::Time maxRewind)
+{
+	mMaxRewind = (maxRewind > en::Time::Zero) ? maxRewind : en::Time::Zero;
+	const en::U32 sampleCount = 1 + static_cast<en::U32>(mMaxRewind.asSeconds() / DefaultStepInterval.asSeconds() + 0.999f);
+	mPositionHistory.Initialize(sampleCount);
+	mPositionHistory.Reserve(mMaxPlayers);
+	const en::U32 playerSize = static_cast<en::U32>(mPlayers.size());
+	for (en::U32 i = 0; i < playerSize; ++i)
+	{
+		mPositionHistory.Reset(i, mChickens.positions[i], en::Time::Zero);
+	}
+}
+
 void Server::UpdateLoots(en::Time dt)
 {
-	static en::Time spawnTimeCounter = en::Time::Zero;
-	spawnTimeCounter += dt;
-	if (spawnTimeCounter >= DefaultSpawnItemInterval)
+	mItemSpawnTime += dt;
+	if (mItemSpawnTime >= DefaultSpawnItemInterval)
 	{
-		if (mItems.size() >= DefaultMaxItemAmount)
+		if (mItems.Size() >= DefaultMaxItemAmount)
 		{
-			SendRemoveItemPacket(mItems[0].itemUID, false, en::U32_Max);
-			mItems.erase(mItems.begin());
+			// Remove the oldest item still on the map
+			while (!mItems.Has(mItemSpawnOrder.front()))
+			{
+				mItemSpawnOrder.pop_front();
+			}
+			const en::U32 itemUID = mItemSpawnOrder.front();
+			mItemSpawnOrder.pop_front();
+			mItems.Remove(itemUID);
 		}
 		else
 		{
-			spawnTimeCounter = en::Time::Zero;
-			AddNewItem(GetRandomPositionItem(), GetRandomAttackItem());
+			mItemSpawnTime = en::Time::Zero;
+			AddNewItem(GetRandomPositionItem(), GetRandomAttackItem(mRandom));
 		}
 	}
 
 	// Item pick up
 	{
-		en::U32 itemSize = static_cast<en::U32>(mItems.size());
-		const en::U32 playerSize = static_cast<en::U32>(mPlayers.size());
-		for (en::U32 i = 0; i < playerSize; ++i)
+		// There are far less items than chickens, so query the chickens around each item
+		const en::Vector2f* positions = mChickens.positions.data();
+		en::U32 itemSize = mItems.Size();
+		for (en::U32 j = 0; j < itemSize; )
 		{
-			const en::Vector2f pPos = mPlayers[i].chicken.position;
-			for (en::U32 j = 0; j < itemSize; )
+			const en::Vector2f iPos = mItems[j].position;
+			en::U32 pickerIndex = en::U32_Max;
+			mChickenGrid.Query(iPos, DefaultItemPickUpDistance, [&](en::U32 i)
 			{
-				const en::Vector2f delta = pPos - mItems[j].position;
-				if (delta.getSquaredLength() < DefaultItemPickUpDistanceSqr)
+				const en::Vector2f delta = positions[i] - iPos;
+				if (i < pickerIndex && delta.getSquaredLength() < DefaultItemPickUpDistanceSqr)
 				{
-					mPlayers[i].chicken.itemID = mItems[j].itemID;
-					mPlayers[i].needUpdate = true;
-
-					SendRemoveItemPacket(mItems[j].itemUID, true, mPlayers[i].clientID);
-					mItems.erase(mItems.begin() + j);
-					itemSize--;
-				}
-				else
-				{
-					j++;
+					pickerIndex = i;
 				}
+			});
+
+			if (pickerIndex != en::U32_Max)
+			{
+				mChickens.itemIDs[pickerIndex] = mItems[j].itemID;
+				AddEvent(SnapshotEventType::PickUpItem, mChickens.clientIDs[pickerIndex], 0, mItems[j].itemID, mItems[j].position);
+				mItems.RemoveAt(j);
+				itemSize--;
+			}
+			else
+			{
+				j++;
 			}
 		}
 	}
 }
 
-void Server::UpdateLastPacketTime(const sf::IpAddress& remoteAddress, en::U16 remotePort)
+void Server::SetMaxPlayers(en::U32 maxPlayers)
 {
-	const en::U32 size = static_cast<en::U32>(mPlayers.size());
-	for (en::U32 i = 0; i < size; ++i)
-	{
-		if (mPlayers[i].remotePort == remotePort && mPlayers[i].remoteAddress == remoteAddress)
-		{
-			mPlayers[i].lastPacketTime = en::Time::Zero;
-			return;
-		}
-	}
+	mMaxPlayers = maxPlayers;
+	ReserveCapacity();
 }
 
-en::U32 Server::GenerateClientID(const sf::IpAddress& remoteAddress, en::U16 remotePort) const
+en::U32 Server::GenerateClientID(const sf::IpAddress& remoteAddress, en::U16 remotePort)
 {
 	return en::Hash::CombineHash(en::Hash::CRC32(remoteAddress.toString().c_str()), static_cast<en::U32>(remotePort));
 }
 
-bool Server::IsClientIDAssignedToThisPlayer(en::U32 clientID, const sf::IpAddress& remoteAddress, en::U16 remotePort) const
-{
-	return clientID == GenerateClientID(remoteAddress, remotePort);
-}
-
 en::U32 Server::GetClientIDFromIpAddress(const sf::IpAddress& remoteAddress, en::U16 remotePort, en::I32* playerIndex) const
 {
-	const en::U32 size = static_cast<en::U32>(mPlayers.size());
-	for (en::U32 i = 0; i < size; ++i)
+	const auto itr = mEndpointToPlayer.find(GetEndpointKey(remoteAddress, remotePort));
+	if (itr != mEndpointToPlayer.end())
 	{
-		if (mPlayers[i].remotePort == remotePort && mPlayers[i].remoteAddress == remoteAddress)
+		if (playerIndex != nullptr)
 		{
-			if (playerIndex != nullptr)
-			{
-				*playerIndex = static_cast<en::I32>(i);
-			}
-			return mPlayers[i].clientID;
+			*playerIndex = static_cast<en::I32>(itr->second);
 		}
+		return mPlayers[itr->second].clientID;
 	}
 	if (playerIndex != nullptr)
 	{
@@ -665,15 +968,8 @@ en::U32 Server::GetClientIDFromIpAddress(const sf::IpAddress& remoteAddress, en:
 
 en::I32 Server::GetPlayerIndexFromClientID(en::U32 clientID) const
 {
-	const en::U32 size = static_cast<en::U32>(mPlayers.size());
-	for (en::U32 i = 0; i < size; ++i)
-	{
-		if (mPlayers[i].clientID == clientID)
-		{
-			return static_cast<en::I32>(i);
-		}
-	}
-	return -1;
+	const auto itr = mClientIDToPlayer.find(clientID);
+	return (itr != mClientIDToPlayer.end()) ? static_cast<en::I32>(itr->second) : -1;
 }
 
 bool Server::IsInMap(const en::Vector2f& position) const
@@ -683,292 +979,381 @@ bool Server::IsInMap(const en::Vector2f& position) const
 
 en::Vector2f Server::GetRandomPositionSpawn()
 {
-	return { en::Random::get<en::F32>(DefaultMapBorder, mMapSize.x - DefaultMapBorder), en::Random::get<en::F32>(DefaultMapBorder, mMapSize.y - DefaultMapBorder) };
+	return { mRandom.get<en::F32>(DefaultMapBorder, mMapSize.x - DefaultMapBorder), mRandom.get<en::F32>(DefaultMapBorder, mMapSize.y - DefaultMapBorder) };
 }
 
-en::Vector2f Server::GetRandomPositionItem()
+void Server::AddPlayer(const Player& player, const Chicken& chicken)
 {
-	return { en::Random::get<en::F32>(DefaultMapBorder, mMapSize.x - DefaultMapBorder), en::Random::get<en::F32>(DefaultMapBorder, mMapSize.y - DefaultMapBorder) };
+	const en::U32 playerIndex = static_cast<en::U32>(mPlayers.size());
+	mPlayers.push_back(player);
+	mChickens.Add(player.clientID, chicken);
+	mClientIDToPlayer[player.clientID] = playerIndex;
+	if (player.remotePort != 0)
+	{
+		mEndpointToPlayer[GetEndpointKey(player.remoteAddress, player.remotePort)] = playerIndex;
+	}
+	mChickenGrid.Insert(playerIndex, chicken.position);
+	mPositionHistory.Reset(playerIndex, chicken.position, mTime);
+	ReportMetrics();
 }
 
-void Server::AddNewSeed(const en::Vector2f& position, en::U32 clientID)
+// Swap-and-pop, so only the last player has to be reindexed
+void Server::RemovePlayer(en::U32 playerIndex)
 {
-	const en::U32 seedSize = static_cast<en::U32>(mSeeds.size());
-	for (en::U32 i = 0; i < seedSize; ++i)
+	const Player& removedPlayer = mPlayers[playerIndex];
+	mClientIDToPlayer.erase(removedPlayer.clientID);
+	if (removedPlayer.remotePort != 0)
 	{
-		if (mSeeds[i].clientID == clientID)
+		mEndpointToPlayer.erase(GetEndpointKey(removedPlayer.remoteAddress, removedPlayer.remotePort));
+	}
+
+	const en::U32 lastIndex = static_cast<en::U32>(mPlayers.size()) - 1;
+	mChickenGrid.Remove(playerIndex, mChickens.positions[playerIndex]);
+	if (playerIndex != lastIndex)
+	{
+		mChickenGrid.Reindex(lastIndex, playerIndex, mChickens.positions[lastIndex]);
+		mPlayers[playerIndex] = std::move(mPlayers[lastIndex]);
+		const Player& movedPlayer = mPlayers[playerIndex];
+		mClientIDToPlayer[movedPlayer.clientID] = playerIndex;
+		if (movedPlayer.remotePort != 0)
 		{
-			SendRemoveSeedPacket(mSeeds[i].seedUID, false, en::U32_Max);
-			mSeeds.erase(mSeeds.begin() + i);
-			break;
+			mEndpointToPlayer[GetEndpointKey(movedPlayer.remoteAddress, movedPlayer.remotePort)] = playerIndex;
 		}
 	}
+	mPlayers.pop_back();
+	mPlayersVersion++;
+	mChickens.Remove(playerIndex);
+	mPositionHistory.Remove(playerIndex, lastIndex);
+	ReportMetrics();
+}
+
+Chicken Server::CreateChicken()
+{
+	Chicken chicken;
+	chicken.position = GetRandomPositionSpawn();
+	chicken.rotation = 0.0f;
+	chicken.itemID = ItemID::None;
+	chicken.kills = 0;// DefaultChickenAttack;
+	chicken.lifeMax = DefaultChickenLife;
+	chicken.life = DefaultChickenLife;
+	chicken.speed = DefaultChickenSpeed;
+	chicken.attack = DefaultChickenAttack;
+	return chicken;
+}
+
+en::Vector2f Server::GetRandomPositionItem()
+{
+	return { mRandom.get<en::F32>(DefaultMapBorder, mMapSize.x - DefaultMapBorder), mRandom.get<en::F32>(DefaultMapBorder, mMapSize.y - DefaultMapBorder) };
+}
+
+void Server::AddNewSeed(const en::Vector2f& position, en::U32 playerIndex)
+{
+	en::U32& seedUID = mChickens.seedUIDs[playerIndex];
+	mSeeds.Remove(seedUID);
 
-	static en::U32 seedUIDGenerator = 1;
 	Seed seed;
-	seed.seedUID = seedUIDGenerator++;
 	seed.position = position;
-	seed.clientID = clientID;
+	seed.clientID = mChickens.clientIDs[playerIndex];
 	seed.remainingTime = DefaultSeedLifetime;
-	mSeeds.push_back(seed);
-	SendAddSeedPacket(seed);
+	seed.seedUID = mSeeds.Add(seed);
+	mSeeds.Get(seed.seedUID)->seedUID = seed.seedUID;
+	seedUID = seed.seedUID;
 }
 
 void Server::AddNewItem(const en::Vector2f& position, ItemID itemID) 
 {
-	static en::U32 itemUIDGenerator = 1;
 	Item item;
-	item.itemUID = itemUIDGenerator++;
 	item.itemID = itemID;
 	item.position = position;
-	mItems.push_back(item);
-	SendAddItemPacket(item);
+	item.itemUID = mItems.Add(item);
+	mItems.Get(item.itemUID)->itemUID = item.itemUID;
+
+	// Drop the picked up items from the spawn order once in a while, so it doesn't grow forever
+	if (mItemSpawnOrder.size() >= 2 * DefaultMaxItemAmount)
+	{
+		mItemSpawnOrder.erase(std::remove_if(mItemSpawnOrder.begin(), mItemSpawnOrder.end(), [this](en::U32 itemUID) { return !mItems.Has(itemUID); }), mItemSpawnOrder.end());
+	}
+	mItemSpawnOrder.push_back(item.itemUID);
 }
 
 void Server::AddNewBullet(const en::Vector2f& position, en::F32 rotation, en::U32 clientID, ItemID itemID, en::F32 remainingDistance)
 {
-	static en::U32 bulletUIDGenerator = 1;
 	Bullet bullet;
-	bullet.bulletUID = bulletUIDGenerator++;
 	bullet.position = position;
 	bullet.rotation = rotation;
 	bullet.clientID = clientID;
 	bullet.itemID = itemID;
 	bullet.remainingDistance = remainingDistance;
-	mBullets.push_back(bullet);
-	SendShootBulletPacket(bullet);
+	bullet.bulletUID = mBullets.Add(bullet);
+	mBullets.Get(bullet.bulletUID)->bulletUID = bullet.bulletUID;
 }
 
-void Server::SendToAllPlayers(sf::Packet& packet)
+void Server::ReserveCapacity()
 {
-	const en::U32 size = static_cast<en::U32>(mPlayers.size());
-	for (en::U32 i = 0; i < size; ++i)
-	{
-		if (mPlayers[i].remotePort != 0)
-		{
-			mSocket.SendPacket(packet, mPlayers[i].remoteAddress, mPlayers[i].remotePort);
-		}
-	}
+	const en::U32 seedCount = mMaxPlayers; // One seed per player
+	const en::U32 itemCount = DefaultMaxItemAmount;
+	const en::U32 bulletCount = mMaxPlayers * DefaultMaxBulletsPerPlayer;
+	const en::U32 eventCount = mMaxPlayers * static_cast<en::U32>(SnapshotEventType::Count);
+	mSeeds.Reserve(seedCount);
+	mItems.Reserve(itemCount);
+	mBullets.Reserve(bulletCount);
+	mPendingEvents.reserve(eventCount);
+	mPositionHistory.Reserve(mMaxPlayers);
+	mSnapshots.Reserve(mMaxPlayers, seedCount, itemCount, bulletCount, eventCount);
+	mBaselineView.Reserve(mMaxPlayers, seedCount, itemCount, bulletCount, eventCount);
+	mCurrentView.Reserve(mMaxPlayers, seedCount, itemCount, bulletCount, eventCount);
 }
 
-void Server::SendPingPacket(const sf::IpAddress& remoteAddress, en::U16 remotePort)
+void Server::AddEvent(SnapshotEventType type, en::U32 clientID, en::U32 otherClientID, ItemID itemID, const en::Vector2f& position)
 {
-	if (mSocket.IsRunning() && remotePort != 0)
-	{
-		sf::Packet packet;
-		packet << static_cast<en::U8>(ServerPacketID::Ping);
-		mSocket.SendPacket(packet, remoteAddress, remotePort);
-	}
+	SnapshotEvent event;
+	event.sequence = 0; // Set by BuildSnapshot
+	event.type = type;
+	event.clientID = clientID;
+	event.otherClientID = otherClientID;
+	event.itemID = itemID;
+	event.position = position;
+	mPendingEvents.push_back(event);
 }
 
-void Server::SendPongPacket(const sf::IpAddress& remoteAddress, en::U16 remotePort)
+void Server::BuildSnapshot()
 {
-	if (mSocket.IsRunning() && remotePort != 0)
+	mSnapshotSequence++;
+	Snapshot& snapshot = mSnapshots.Push(mSnapshotSequence);
+
+	const en::U32 chickenSize = mChickens.Size();
+	for (en::U32 i = 0; i < chickenSize; ++i)
 	{
-		sf::Packet packet;
-		packet << static_cast<en::U8>(ServerPacketID::Pong);
-		mSocket.SendPacket(packet, remoteAddress, remotePort);
+		SnapshotChicken chicken;
+		chicken.clientID = mChickens.clientIDs[i];
+		chicken.chicken = mChickens.GetChicken(i);
+		chicken.far = false;
+		snapshot.chickens.push_back(chicken);
+
+		SnapshotScore score;
+		score.clientID = chicken.clientID;
+		score.kills = chicken.chicken.kills;
+		snapshot.scores.push_back(score);
 	}
-}
-
-void Server::SendConnectionAcceptedPacket(const sf::IpAddress& remoteAddress, en::U16 remotePort, en::U32 clientID)
-{
-	if (mSocket.IsRunning() && remotePort != 0)
+	AssignSnapshotValues(snapshot.seeds, mSeeds.begin(), mSeeds.end());
+	AssignSnapshotValues(snapshot.items, mItems.begin(), mItems.end());
+	AssignSnapshotValues(snapshot.bullets, mBullets.begin(), mBullets.end());
+	snapshot.Sort();
+
+	// Swap so both vectors keep their capacity
+	snapshot.events.swap(mPendingEvents);
+	mPendingEvents.clear();
+	for (SnapshotEvent& event : snapshot.events)
 	{
-		sf::Packet packet;
-		packet << static_cast<en::U8>(ServerPacketID::ConnectionAccepted);
-		packet << clientID;
-		mSocket.SendPacket(packet, remoteAddress, remotePort);
+		event.sequence = mSnapshotSequence;
 	}
 }
 
-void Server::SendConnectionRejectedPacket(const sf::IpAddress& remoteAddress, en::U16 remotePort, RejectReason reason)
+// One datagram per client per tick, against the last snapshot it acknowledged
+// Each client only gets what is around its chicken, see BuildSnapshotView
+void Server::SendSnapshots()
 {
-	if (mSocket.IsRunning() && remotePort != 0)
+	if (!mSocket.IsRunning())
 	{
-		sf::Packet packet;
-		packet << static_cast<en::U8>(ServerPacketID::ConnectionRejected);
-		packet << static_cast<en::U32>(reason);
-		mSocket.SendPacket(packet, remoteAddress, remotePort);
+		return;
 	}
-}
 
-void Server::SendClientJoinedPacket(en::U32 clientID, const std::string& nickname, const Chicken& chicken)
-{
-	if (mSocket.IsRunning())
+	const Snapshot* current = mSnapshots.Get(mSnapshotSequence);
+	const en::U32 size = static_cast<en::U32>(mPlayers.size());
+	for (en::U32 i = 0; i < size; ++i)
 	{
-		sf::Packet packet;
-		packet << static_cast<en::U8>(ServerPacketID::ClientJoined);
-		packet << clientID;
-		packet << nickname;
-		packet << chicken;
-		SendToAllPlayers(packet);
+		if (mPlayers[i].remotePort == 0)
+		{
+			continue;
+		}
+
+		// Send the full state if the acknowledged snapshot is too old to rebuild its view
+		const en::U32 ackedSnapshot = mPlayers[i].ackedSnapshot;
+		const Snapshot* baseline = (mSnapshotSequence - ackedSnapshot <= DefaultSnapshotBufferSize - DefaultRelevanceFarInterval) ? mSnapshots.Get(ackedSnapshot) : nullptr;
+		if (baseline == nullptr)
+		{
+			baseline = mSnapshots.Get(0);
+		}
+
+		const en::U32 clientID = mPlayers[i].clientID;
+		BuildSnapshotView(*baseline, mSnapshots, clientID, mBaselineView);
+		BuildSnapshotView(*current, mSnapshots, clientID, mCurrentView);
+
+		mSnapshotPacket.clear();
+		mSnapshotPacket << static_cast<en::U8>(ServerPacketID::Snapshot);
+		mSnapshotPacket << current->sequence;
+		mSnapshotPacket << baseline->sequence;
+		mSnapshotWriter.Clear();
+		WriteSnapshotDelta(mSnapshotWriter, mBaselineView, mCurrentView, mSnapshots, clientID);
+		mSnapshotPacket.append(mSnapshotWriter.GetData(), mSnapshotWriter.GetByteCount());
+		mSocket.SendPacket(mSnapshotPacket, mPlayers[i].remoteAddress, mPlayers[i].remotePort);
 	}
 }
 
-void Server::SendClientLeftPacket(en::U32 clientID)
+void Server::SendToAllPlayers(const PooledPacket& packet)
 {
-	if (mSocket.IsRunning())
+	const en::U32 size = static_cast<en::U32>(mPlayers.size());
+	for (en::U32 i = 0; i < size; ++i)
 	{
-		sf::Packet packet;
-		packet << static_cast<en::U8>(ServerPacketID::ClientLeft);
-		packet << clientID;
-		SendToAllPlayers(packet);
+		if (mPlayers[i].remotePort != 0)
+		{
+			mSocket.SendPacket(packet, mPlayers[i].remoteAddress, mPlayers[i].remotePort);
+		}
 	}
 }
 
-void Server::SendServerStopPacket()
+void Server::SendReliablePacket(const PooledPacket& packet, en::U32 playerIndex, ReliableChannelID channel)
 {
-	if (mSocket.IsRunning())
+	Player& player = mPlayers[playerIndex];
+	if (packet && player.remotePort != 0 && !player.reliable.Send(packet.getData(), packet.getDataSize(), channel))
 	{
-		sf::Packet packet;
-		packet << static_cast<en::U8>(ServerPacketID::Stopping);
-		mSocket.SetBlocking(true);
-		SendToAllPlayers(packet);
-		mSocket.SetBlocking(false);
+		// The client hasn't acked anything for a while, it will most likely time out
+		LogWarning(en::LogChannel::All, 6, "Reliable queue full for ClientID %d, message dropped", player.clientID);
 	}
 }
 
-void Server::SendServerInfo(const std::string& nickname, en::U32 kills)
+void Server::SendReliableToAllPlayers(const PooledPacket& packet, ReliableChannelID channel)
 {
-	if (mSocket.IsRunning())
+	const en::U32 size = static_cast<en::U32>(mPlayers.size());
+	for (en::U32 i = 0; i < size; ++i)
 	{
-		sf::Packet packet;
-		packet << static_cast<en::U8>(ServerPacketID::ServerInfo);
-		packet << nickname;
-		packet << kills;
-		SendToAllPlayers(packet);
+		SendReliablePacket(packet, i, channel);
 	}
 }
 
-void Server::SendPlayerInfo(const sf::IpAddress& remoteAddress, en::U16 remotePort, const Player& player)
+void Server::SendReliablePackets()
 {
-	if (mSocket.IsRunning() && remotePort != 0)
+	if (!mSocket.IsRunning())
 	{
-		sf::Packet packet;
-		packet << static_cast<en::U8>(ServerPacketID::PlayerInfo);
-		packet << player.clientID;
-		packet << player.nickname;
-		packet << player.chicken;
-		mSocket.SendPacket(packet, remoteAddress, remotePort);
+		return;
+	}
+	const en::U32 size = static_cast<en::U32>(mPlayers.size());
+	for (en::U32 i = 0; i < size; ++i)
+	{
+		Player& player = mPlayers[i];
+		mReliablePacket.clear();
+		mReliablePacket << static_cast<en::U8>(ServerPacketID::Reliable);
+		if (player.reliable.WritePacket(mReliablePacket, mNetworkClock.getElapsedTime()))
+		{
+			mSocket.SendPacket(mReliablePacket, player.remoteAddress, player.remotePort);
+		}
 	}
 }
 
-void Server::SendItemInfo(const sf::IpAddress& remoteAddress, en::U16 remotePort, const Item& item)
+void Server::SendPingPacket(const sf::IpAddress& remoteAddress, en::U16 remotePort)
 {
 	if (mSocket.IsRunning() && remotePort != 0)
 	{
-		sf::Packet packet;
-		packet << static_cast<en::U8>(ServerPacketID::AddItem);
-		packet << item;
+		PooledPacket packet(mPacketPool);
+		packet << static_cast<en::U8>(ServerPacketID::Ping);
 		mSocket.SendPacket(packet, remoteAddress, remotePort);
 	}
 }
 
-void Server::SendUpdateChickenPacket(en::U32 clientID, const Chicken& chicken)
+void Server::SendPongPacket(const sf::IpAddress& remoteAddress, en::U16 remotePort)
 {
-	if (mSocket.IsRunning())
+	if (mSocket.IsRunning() && remotePort != 0)
 	{
-		sf::Packet packet;
-		packet << static_cast<en::U8>(ServerPacketID::UpdateChicken);
-		packet << clientID;
-		packet << chicken;
-		SendToAllPlayers(packet);
+		PooledPacket packet(mPacketPool);
+		packet << static_cast<en::U8>(ServerPacketID::Pong);
+		mSocket.SendPacket(packet, remoteAddress, remotePort);
 	}
 }
 
-void Server::SendAddSeedPacket(const Seed& seed)
+void Server::SendConnectionAcceptedPacket(en::U32 playerIndex)
 {
 	if (mSocket.IsRunning())
 	{
-		sf::Packet packet;
-		packet << static_cast<en::U8>(ServerPacketID::AddSeed);
-		packet << seed;
-		SendToAllPlayers(packet);
+		PooledPacket packet(mPacketPool);
+		packet << static_cast<en::U8>(ServerPacketID::ConnectionAccepted);
+		packet << mPlayers[playerIndex].clientID;
+		SendReliablePacket(packet, playerIndex, ReliableChannelID::Session);
 	}
 }
 
-void Server::SendRemoveSeedPacket(en::U32 seedUID, bool eated, en::U32 eaterClientID)
+void Server::SendConnectionRejectedPacket(const sf::IpAddress& remoteAddress, en::U16 remotePort, RejectReason reason)
 {
-	if (mSocket.IsRunning())
+	if (mSocket.IsRunning() && remotePort != 0)
 	{
-		sf::Packet packet;
-		packet << static_cast<en::U8>(ServerPacketID::RemoveSeed);
-		packet << seedUID;
-		packet << eated;
-		packet << eaterClientID;
-		SendToAllPlayers(packet);
+		PooledPacket packet(mPacketPool);
+		packet << static_cast<en::U8>(ServerPacketID::ConnectionRejected);
+		packet << static_cast<en::U32>(reason);
+		mSocket.SendPacket(packet, remoteAddress, remotePort);
 	}
 }
 
-void Server::SendAddItemPacket(const Item& item)
+void Server::SendClientJoinedPacket(en::U32 clientID, const std::string& nickname, const Chicken& chicken)
 {
 	if (mSocket.IsRunning())
 	{
-		sf::Packet packet;
-		packet << static_cast<en::U8>(ServerPacketID::AddItem);
-		packet << item;
-		SendToAllPlayers(packet);
+		PooledPacket packet(mPacketPool);
+		packet << static_cast<en::U8>(ServerPacketID::ClientJoined);
+		packet << clientID;
+		packet << nickname;
+		packet << chicken;
+		SendReliableToAllPlayers(packet, ReliableChannelID::Session);
 	}
 }
 
-void Server::SendRemoveItemPacket(en::U32 itemUID, bool pickedUp, en::U32 pickerClientID)
+void Server::SendClientLeftPacket(en::U32 clientID)
 {
 	if (mSocket.IsRunning())
 	{
-		sf::Packet packet;
-		packet << static_cast<en::U8>(ServerPacketID::RemoveItem);
-		packet << itemUID;
-		packet << pickedUp;
-		packet << pickerClientID;
-		SendToAllPlayers(packet);
+		PooledPacket packet(mPacketPool);
+		packet << static_cast<en::U8>(ServerPacketID::ClientLeft);
+		packet << clientID;
+		SendReliableToAllPlayers(packet, ReliableChannelID::Session);
 	}
 }
 
-void Server::SendShootBulletPacket(const Bullet& bullet)
+void Server::SendServerStopPacket()
 {
 	if (mSocket.IsRunning())
 	{
-		sf::Packet packet;
-		packet << static_cast<en::U8>(ServerPacketID::ShootBullet);
-		packet << bullet;
+		PooledPacket packet(mPacketPool);
+		packet << static_cast<en::U8>(ServerPacketID::Stopping);
 		SendToAllPlayers(packet);
+		mSocket.Flush();
 	}
 }
 
-void Server::SendHitChickenPacket(en::U32 clientID, en::U32 killerClientID)
+// The players before toPlayerIndex, in a few messages written once for every client joining
+// Their chickens are as they were when they were serialized, the first snapshot of the client is a full one anyway
+void Server::SendPlayerList(en::U32 toPlayerIndex)
 {
 	if (mSocket.IsRunning())
 	{
-		sf::Packet packet;
-		packet << static_cast<en::U8>(ServerPacketID::HitChicken);
-		packet << clientID;
-		packet << killerClientID;
-		SendToAllPlayers(packet);
+		UpdatePlayerList(toPlayerIndex);
+		Player& player = mPlayers[toPlayerIndex];
+		for (const sf::Packet& message : mPlayerListMessages)
+		{
+			if (player.remotePort != 0 && !player.reliable.Send(message.getData(), message.getDataSize(), ReliableChannelID::Session))
+			{
+				LogWarning(en::LogChannel::All, 6, "Reliable queue full for ClientID %d, message dropped", player.clientID);
+			}
+		}
 	}
 }
 
-void Server::SendKillChickenPacket(en::U32 clientID, en::U32 killerClientID)
+void Server::UpdatePlayerList(en::U32 playerCount)
 {
-	if (mSocket.IsRunning())
+	if (mPlayerListVersion != mPlayersVersion || mPlayerListCount > playerCount)
 	{
-		sf::Packet packet;
-		packet << static_cast<en::U8>(ServerPacketID::KillChicken);
-		packet << clientID;
-		packet << killerClientID;
-		SendToAllPlayers(packet);
+		mPlayerListMessages.clear();
+		mPlayerListCount = 0;
+		mPlayerListVersion = mPlayersVersion;
 	}
-}
-
-void Server::SendRespawnChickenPacket(en::U32 clientID, const en::Vector2f& position)
-{
-	if (mSocket.IsRunning())
+	for (; mPlayerListCount < playerCount; ++mPlayerListCount)
 	{
-		sf::Packet packet;
-		packet << static_cast<en::U8>(ServerPacketID::RespawnChicken);
-		packet << clientID;
-		packet << position.x;
-		packet << position.y;
-		SendToAllPlayers(packet);
+		mPlayerListEntry.clear();
+		mPlayerListEntry << mPlayers[mPlayerListCount].clientID;
+		mPlayerListEntry << mPlayers[mPlayerListCount].nickname;
+		mPlayerListEntry << mChickens.GetChicken(mPlayerListCount);
+		if (mPlayerListMessages.empty() || mPlayerListMessages.back().getDataSize() + mPlayerListEntry.getDataSize() > DefaultPlayerListMessageSize)
+		{
+			mPlayerListMessages.emplace_back();
+			mPlayerListMessages.back() << static_cast<en::U8>(ServerPacketID::PlayerList);
+		}
+		mPlayerListMessages.back().append(mPlayerListEntry.getData(), mPlayerListEntry.getDataSize());
 	}
 }
@@ -1,16 +1,27 @@
 #pragma once
 
+#include <Enlivengine/System/FixedTimestep.hpp>
 #include <Enlivengine/System/Log.hpp>
 #include <Enlivengine/System/Hash.hpp>
 #include <Enlivengine/System/Time.hpp>
+#include <Enlivengine/System/SlotMap.hpp>
 #include <Enlivengine/Math/Random.hpp>
 #include <Enlivengine/Map/Map.hpp>
 
 #include <SFML/Network.hpp>
+#include <deque>
+#include <unordered_map>
 #include <vector>
 
 #include <Common.hpp>
+#include <PacketPool.hpp>
+#include <Snapshot.hpp>
+#include <SpatialGrid.hpp>
 #include "Player.hpp"
+#include "PositionHistory.hpp"
+#include "Replay.hpp"
+#include "ServerMetrics.hpp"
+#include "ServerProfile.hpp"
 #include "ServerSocket.hpp"
 
 class Server
@@ -19,6 +30,8 @@ public:
 	Server();
 
 	bool Start(int argc, char** argv);
+	// Room of a RoomManager, which owns the socket and calls HandlePacket/Simulate
+	void Start(ServerSocket& network);
 	void Stop();
 
 	bool Run();
@@ -26,21 +39,78 @@ public:
 
 	void UpdateLogic(en::Time dt);
 	void Tick(en::Time dt);
+	void Simulate(en::U32 stepCount, en::U32 tickCount);
+
+	// Schedulers of Run, their overrun counters keep growing until ResetStatistics
+	const en::FixedTimestep& GetStepTimestep() const { return mStepTimestep; }
+	const en::FixedTimestep& GetTickTimestep() const { return mTickTimestep; }
+
+	// Rooms : hand what was queued since the last call to the socket of the RoomManager, from its thread
+	// Called after every batch of steps, the reliable messages due are written first
+	void SendQueuedPackets() { SendReliablePackets(); mSocket.FlushToNetwork(); }
+
+	// Also used by the benchmark to run the simulation without any client
+	void AddAIPlayer(const std::string& nickname);
+	en::U32 GetPlayerCount() const { return static_cast<en::U32>(mPlayers.size()); }
+	bool HasPlayer(en::U64 endpointKey) const { return mEndpointToPlayer.count(endpointKey) > 0; }
+	en::U32 GetPlayerListMessageCount() const { return static_cast<en::U32>(mPlayerListMessages.size()); }
+
+	// Also used by the benchmark to replay a recorded packet stream
+	void HandlePacket(sf::Packet& receivedPacket, const sf::IpAddress& remoteAddress, en::U16 remotePort);
+
+	// Record the packets handled and the Simulate calls until Stop, to play the session again with ReplayReader
+	// Before Start : the replay starts from the seed and the settings of the server
+	bool StartRecording(const std::string& path);
+	void StopRecording();
+	bool IsRecording() const { return mReplayRecorder.IsOpen(); }
+	ReplaySettings GetReplaySettings() const;
+
+	void SetMaxPlayers(en::U32 maxPlayers);
+	en::U32 GetMaxPlayers() const { return mMaxPlayers; }
+
+	// Each world has its own, so worlds stepped on different threads don't share anything
+	void SetRandomSeed(en::U32 seed) { mRandom.setSeed(seed); }
+	en::U32 GetRandomSeed() const { return mRandom.getSeed(); }
+
+	// Time spent in each phase of the steps and ticks is added to profile, nullptr to stop
+	void SetProfile(ServerProfile* profile) { mProfile = profile; }
+
+	// Step and tick durations, entity counts and overruns are recorded in metrics, nullptr to stop
+	// Rooms sharing the same metrics add up their counts
+	void SetMetrics(ServerMetrics* metrics);
+
+	// Same seed and same inputs must give the same hash, to check that a run is deterministic
+	en::U32 ComputeStateHash() const;
+
+	// Hits of the bullets of a player are tested against the chickens as the player saw them when shooting
+	// Each chicken keeps a position per step over the window, zero to test against the current positions only
+	void SetLagCompensationWindow(en::Time maxRewind);
+	en::Time GetLagCompensationWindow() const { return mMaxRewind; }
+	en::Time GetSimulationTime() const { return mTime; }
+
+	// Lowest index of a chicken other than the shooter within reach of position at time, U32_Max if none
+	en::U32 FindBulletHit(const en::Vector2f& position, en::U32 shooterClientID, en::Time time) const;
+
+	static en::U32 GenerateClientID(const sf::IpAddress& remoteAddress, en::U16 remotePort);
 
 private:
+	void StartWorld();
 	void HandleIncomingPackets();
+	void ProcessPacket(sf::Packet& receivedPacket, const sf::IpAddress& remoteAddress, en::U16 remotePort);
 
-	void UpdatePlayer(en::F32 dtSeconds, Player& player);
-	void UpdateAIPlayer(en::F32 dtSeconds, Player& player);
+	void UpdateChickenGrid();
+
+	void UpdatePlayer(en::F32 dtSeconds, en::U32 playerIndex);
+	void UpdateAIPlayer(en::F32 dtSeconds, en::U32 playerIndex);
 	void UpdateBullets(en::Time dt);
+	en::Time GetRewindTime(en::U32 shooterClientID) const;
 	void UpdateLoots(en::Time dt);
 
-	void UpdateLastPacketTime(const sf::IpAddress& remoteAddress, en::U16 remotePort);
+	// Move the gauges by the change of the counts since they were last reported
+	void ReportMetrics();
 
-	en::U32 GenerateClientID(const sf::IpAddress& remoteAddress, en::U16 remotePort) const;
-	
-	// Check with a generated client ID from address/port
-	bool IsClientIDAssignedToThisPlayer(en::U32 clientID, const sf::IpAddress& remoteAddress, en::U16 remotePort) const;
+	// Messages received in order by the ReliableEndpoint of the player at remoteAddress:remotePort
+	void HandleReliableMessages(const sf::IpAddress& remoteAddress, en::U16 remotePort);
 
 	// Get ID from known player
 	en::U32 GetClientIDFromIpAddress(const sf::IpAddress& remoteAddress, en::U16 remotePort, en::I32* playerIndex = nullptr) const;
@@ -50,38 +120,51 @@ private:
 
 	bool IsBlacklisted(const sf::IpAddress& remoteAddress) const { return false; } // TODO
 
+private:
+	// Keep mPlayers, mChickens, mChickenGrid, mPositionHistory and the lookup indexes in sync
+	// A removal moves the last row into the hole : a row index is only valid until then,
+	// what outlives it (seeds, bullets, events, replays) holds the clientID and gets the row back with GetPlayerIndexFromClientID
+	void AddPlayer(const Player& player, const Chicken& chicken);
+	void RemovePlayer(en::U32 playerIndex);
+
+	// Size the containers filled by the steps and ticks from mMaxPlayers, so they don't allocate once running
+	void ReserveCapacity();
+	Chicken CreateChicken();
+
 private:
 	bool IsInMap(const en::Vector2f& position) const;
 	en::Vector2f GetRandomPositionSpawn();
 	en::Vector2f GetRandomPositionItem();
 
 private:
-	void AddNewSeed(const en::Vector2f& position, en::U32 clientID);
+	void AddNewSeed(const en::Vector2f& position, en::U32 playerIndex);
 	void AddNewItem(const en::Vector2f& position, ItemID itemID);
 	void AddNewBullet(const en::Vector2f& position, en::F32 rotation, en::U32 clientID, ItemID itemID, en::F32 remainingDistance);
+	void AddEvent(SnapshotEventType type, en::U32 clientID, en::U32 otherClientID, ItemID itemID, const en::Vector2f& position);
 
 private:
-	void SendToAllPlayers(sf::Packet& packet);
+	void BuildSnapshot();
+	void SendSnapshots();
+
+private:
+	void SendToAllPlayers(const PooledPacket& packet);
+	void SendReliablePacket(const PooledPacket& packet, en::U32 playerIndex, ReliableChannelID channel);
+	void SendReliableToAllPlayers(const PooledPacket& packet, ReliableChannelID channel);
+	// Resends, acks and the reliable messages queued since the last call
+	void SendReliablePackets();
 
 	void SendPingPacket(const sf::IpAddress& remoteAddress, en::U16 remotePort);
 	void SendPongPacket(const sf::IpAddress& remoteAddress, en::U16 remotePort);
-	void SendConnectionAcceptedPacket(const sf::IpAddress& remoteAddress, en::U16 remotePort, en::U32 clientID);
+	void SendConnectionAcceptedPacket(en::U32 playerIndex);
 	void SendConnectionRejectedPacket(const sf::IpAddress& remoteAddress, en::U16 remotePort, RejectReason reason);
 	void SendClientJoinedPacket(en::U32 clientID, const std::string& nickname, const Chicken& chicken);
 	void SendClientLeftPacket(en::U32 clientID);
 	void SendServerStopPacket();
-	void SendServerInfo(const std::string& nickname, en::U32 kills);
-	void SendPlayerInfo(const sf::IpAddress& remoteAddress, en::U16 remotePort, const Player& player);
-	void SendItemInfo(const sf::IpAddress& remoteAddress, en::U16 remotePort, const Item& item);
-	void SendUpdateChickenPacket(en::U32 clientID, const Chicken& chicken);
-	void SendAddSeedPacket(const Seed& seed);
-	void SendRemoveSeedPacket(en::U32 seedUID, bool eated, en::U32 eaterClientID);
-	void SendAddItemPacket(const Item& item);
-	void SendRemoveItemPacket(en::U32 itemID, bool pickedUp, en::U32 pickerClientID);
-	void SendShootBulletPacket(const Bullet& bullet);
-	void SendHitChickenPacket(en::U32 clientID, en::U32 killerClientID);
-	void SendKillChickenPacket(en::U32 clientID, en::U32 killerClientID);
-	void SendRespawnChickenPacket(en::U32 clientID, const en::Vector2f& position);
+	void SendPlayerList(en::U32 toPlayerIndex);
+
+	// Brings the cached PlayerList messages to the first playerCount players, only the new ones are serialized
+	// until a player leaves and the list is written again
+	void UpdatePlayerList(en::U32 playerCount);
 
 private:  
 	ServerSocket mSocket;
@@ -89,7 +172,57 @@ private:
 
 	en::Vector2f mMapSize;
 	std::vector<Player> mPlayers;
-	std::vector<Seed> mSeeds;
-	std::vector<Item> mItems;
-	std::vector<Bullet> mBullets;
+	ChickenArrays mChickens;
+	std::unordered_map<en::U64, en::U32> mEndpointToPlayer; // Address+port -> player index, AI players are not in it
+	std::unordered_map<en::U32, en::U32> mClientIDToPlayer; // ClientID -> player index
+	// UIDs of seeds/items/bullets are their SlotMap handles
+	en::SlotMap<Seed> mSeeds;
+	en::SlotMap<Item> mItems;
+	std::deque<en::U32> mItemSpawnOrder; // Oldest first, might still contain picked up items
+	en::SlotMap<Bullet> mBullets;
+
+	SpatialGrid mChickenGrid; // Rebuilt each step, updated when chickens move, join or leave
+
+	SnapshotBuffer mSnapshots;
+	en::U32 mSnapshotSequence;
+	std::vector<SnapshotEvent> mPendingEvents; // Moved into the next snapshot
+	sf::Packet mSnapshotPacket;
+	en::BitWriter mSnapshotWriter;
+	Snapshot mBaselineView; // What the client being sent to sees of the baseline and current snapshots
+	Snapshot mCurrentView;
+
+	PacketPool mPacketPool; // Every other message is written in place, no allocation per send
+	sf::Packet mReceivedPacket; // Reused, keeps its capacity
+	sf::Packet mReliablePacket;
+	sf::Packet mReliableMessage;
+
+	std::vector<sf::Packet> mPlayerListMessages; // Sent as is to each joining client
+	sf::Packet mPlayerListEntry;
+	en::U32 mPlayerListCount; // Players already in mPlayerListMessages
+	en::U32 mPlayerListVersion; // mPlayersVersion the messages were written for
+	en::U32 mPlayersVersion; // Changed when players are removed or reordered, and each tick as the chickens move
+
+	en::U32 mMaxPlayers;
+
+	en::Time mTime; // Simulation time, advanced by each step
+	en::Clock mNetworkClock; // Resends of the reliable messages, also runs while a room has nobody to simulate with
+	PositionHistory mPositionHistory; // Recorded after each step
+	en::Time mMaxRewind;
+
+	en::RandomEngine mRandom;
+	en::FixedTimestep mStepTimestep;
+	en::FixedTimestep mTickTimestep;
+	en::FixedTimestep mBulletTimestep; // Advanced by the steps
+	en::FixedTimestep mLootTimestep;
+	en::U32 mPingPlayerIndex; // Round robin over the rows, doesn't follow a player
+	en::Time mPingTime;
+	en::Time mItemSpawnTime;
+
+	ServerProfile* mProfile;
+	ReplayRecorder mReplayRecorder;
+	ServerMetrics* mMetrics;
+	en::I64 mReportedPlayers;
+	en::I64 mReportedSeeds;
+	en::I64 mReportedItems;
+	en::I64 mReportedBullets;
 };
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <Enlivengine/System/Metrics.hpp>
+
+// What a server process exposes, registered once in a registry which outlives it
+// Shared by the rooms and the socket : every metric is recorded lock-free, from any thread
+struct ServerMetrics
+{
+	explicit ServerMetrics(en::MetricsRegistry& registry)
+		: stepDuration(registry.AddHistogram("ludumdare46_step_duration_microseconds", "Duration of a simulation step of a room"))
+		, tickDuration(registry.AddHistogram("ludumdare46_tick_duration_microseconds", "Duration of a network tick of a room"))
+		, datagramsReceived(registry.AddCounter("ludumdare46_datagrams_received_total", "Datagrams received by the socket"))
+		, datagramsSent(registry.AddCounter("ludumdare46_datagrams_sent_total", "Datagrams handed to the socket"))
+		, datagramsDropped(registry.AddCounter("ludumdare46_datagrams_dropped_total", "Datagrams dropped because the outgoing queue was full"))
+		, bytesReceived(registry.AddCounter("ludumdare46_received_bytes_total", "Bytes received by the socket"))
+		, bytesSent(registry.AddCounter("ludumdare46_sent_bytes_total", "Bytes handed to the socket"))
+		, overruns(registry.AddCounter("ludumdare46_overruns_total", "Loops with more steps or ticks due than the catch-up limit"))
+		, droppedSteps(registry.AddCounter("ludumdare46_dropped_steps_total", "Steps dropped by overruns"))
+		, droppedTicks(registry.AddCounter("ludumdare46_dropped_ticks_total", "Ticks dropped by overruns"))
+		, rooms(registry.AddGauge("ludumdare46_rooms", "Rooms hosted"))
+		, players(registry.AddGauge("ludumdare46_players", "Players in every room, AI included"))
+		, seeds(registry.AddGauge("ludumdare46_seeds", "Seeds in every room"))
+		, items(registry.AddGauge("ludumdare46_items", "Items on the ground in every room"))
+		, bullets(registry.AddGauge("ludumdare46_bullets", "Bullets flying in every room"))
+	{
+	}
+
+	en::MetricHistogram& stepDuration;
+	en::MetricHistogram& tickDuration;
+
+	en::MetricCounter& datagramsReceived;
+	en::MetricCounter& datagramsSent;
+	en::MetricCounter& datagramsDropped;
+	en::MetricCounter& bytesReceived;
+	en::MetricCounter& bytesSent;
+
+	en::MetricCounter& overruns;
+	en::MetricCounter& droppedSteps;
+	en::MetricCounter& droppedTicks;
+
+	// Each room adds the change of its own counts
+	en::MetricGauge& rooms;
+	en::MetricGauge& players;
+	en::MetricGauge& seeds;
+	en::MetricGauge& items;
+	en::MetricGauge& bullets;
+};
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <Enlivengine/System/PrimitiveTypes.hpp>
+#include <Enlivengine/System/Time.hpp>
+
+#include <cstddef>
+
+enum class ServerPhase : en::U32
+{
+	Players, // Chicken grid, AI, movement, seeds and shots
+	Bullets,
+	Loots,
+	Tick, // Snapshot, pings, timeouts
+
+	Count
+};
+
+inline const char* GetServerPhaseName(ServerPhase phase)
+{
+	switch (phase)
+	{
+	case ServerPhase::Players: return "Players";
+	case ServerPhase::Bullets: return "Bullets";
+	case ServerPhase::Loots: return "Loots";
+	case ServerPhase::Tick: return "Tick";
+	default: break;
+	}
+	return "";
+}
+
+// Accumulated by a Server it has been given to, see Server::SetProfile
+struct ServerProfile
+{
+	static constexpr en::U32 PhaseCount = static_cast<en::U32>(ServerPhase::Count);
+
+	ServerProfile()
+		: getAllocationCount(nullptr)
+	{
+		Reset();
+	}
+
+	void Reset()
+	{
+		for (en::U32 i = 0; i < PhaseCount; ++i)
+		{
+			times[i] = en::Time::Zero;
+			calls[i] = 0;
+			allocations[i] = 0;
+		}
+		overruns = 0;
+		droppedSteps = 0;
+		droppedTicks = 0;
+	}
+
+	en::Time times[PhaseCount];
+	en::U32 calls[PhaseCount];
+	std::size_t allocations[PhaseCount];
+
+	// Run loops with more steps or ticks due than DefaultMaxCatchUpSteps/Ticks, and how many they dropped
+	en::U32 overruns;
+	en::U32 droppedSteps;
+	en::U32 droppedTicks;
+
+	// Optional, read around each phase to count its allocations
+	std::size_t (*getAllocationCount)();
+};
+
+// Add the duration of the scope to a phase, nothing without profile
+class ServerProfileScope
+{
+public:
+	ServerProfileScope(ServerProfile* profile, ServerPhase phase)
+		: mProfile(profile)
+		, mPhase(static_cast<en::U32>(phase))
+		, mStart((profile != nullptr) ? en::Time::now() : en::Time::Zero)
+		, mAllocations((profile != nullptr && profile->getAllocationCount != nullptr) ? profile->getAllocationCount() : 0)
+	{
+	}
+
+	~ServerProfileScope()
+	{
+		if (mProfile != nullptr)
+		{
+			mProfile->times[mPhase] += en::Time::now() - mStart;
+			mProfile->calls[mPhase]++;
+			if (mProfile->getAllocationCount != nullptr)
+			{
+				mProfile->allocations[mPhase] += mProfile->getAllocationCount() - mAllocations;
+			}
+		}
+	}
+
+private:
+	ServerProfile* mProfile;
+	en::U32 mPhase;
+	en::Time mStart;
+	std::size_t mAllocations;
+};
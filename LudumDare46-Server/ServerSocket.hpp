@@ -2,9 +2,23 @@
 
 #include <SFML/Network.hpp>
 #include <Common.hpp>
+#include <PacketBatch.hpp>
+#include <PacketPool.hpp>
+
+#include "BatchedUdpSocket.hpp"
+#include "ServerMetrics.hpp"
 
 #include <Enlivengine/System/Log.hpp>
+#include <Enlivengine/System/SPSCQueue.hpp>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <unordered_map>
 
+// The socket is owned by a network thread, which exchanges datagrams with the simulation through two SPSC queues
+// Both queues are filled in place, so neither thread allocates once started
+// A socket can also be attached to another one instead of being started, for the rooms of a RoomManager
 class ServerSocket
 {
 public:
@@ -12,9 +26,23 @@ public:
 		: mSocket()
 		, mSocketPort(DefaultServerPort)
 		, mRunning(false)
+		, mBatches()
+		, mMetrics(nullptr)
+		, mNetwork(nullptr)
+		, mQueues()
+		, mThread()
+		, mThreadRunning(false)
 	{
 	}
 
+	~ServerSocket()
+	{
+		if (mRunning)
+		{
+			Stop();
+		}
+	}
+
 	bool Start()
 	{
 		LogInfo(en::LogChannel::All, 5, "Starting...%s", "");
@@ -25,31 +53,125 @@ public:
 			return false;
 		}
 		mSocket.setBlocking(false);
+		if (mQueues == nullptr)
+		{
+			mQueues.reset(new Queues());
+		}
 		mRunning = true;
+		mThreadRunning = true;
+		mThread = std::thread(&ServerSocket::NetworkThread, this);
 		LogInfo(en::LogChannel::All, 5, "Started at %s:%d", sf::IpAddress::getPublicAddress().toString().c_str(), mSocket.getLocalPort());
 		return true;
 	}
 
+	// Everything queued before is still sent
 	void Stop()
 	{
+		if (mNetwork != nullptr)
+		{
+			Detach();
+			return;
+		}
+
 		LogInfo(en::LogChannel::All, 5, "Stopping...%s", "");
+		Flush();
+		mThreadRunning = false;
+		if (mThread.joinable())
+		{
+			mThread.join();
+		}
 		mSocket.unbind();
 		mRunning = false;
 		LogInfo(en::LogChannel::All, 5, "Stopped%s", "");
 	}
 
-	void SetBlocking(bool blocking) { mSocket.setBlocking(blocking); }
-	bool IsBlocking() const { return mSocket.isBlocking(); }
-	
+	// Nothing is bound, the messages go through network when it flushes this socket
+	// Calls to Flush are ignored meanwhile : they might come from other threads
+	void Attach(ServerSocket& network)
+	{
+		mNetwork = &network;
+		mRunning = true;
+	}
+
+	// Send what is still queued, then stop
+	void Detach()
+	{
+		if (mNetwork != nullptr)
+		{
+			mNetwork->Flush(*this);
+			mNetwork = nullptr;
+		}
+		mRunning = false;
+	}
+
+	bool IsAttached() const { return mNetwork != nullptr; }
+
+	// Only from the thread using the network socket
+	void FlushToNetwork()
+	{
+		if (mNetwork != nullptr)
+		{
+			mNetwork->Flush(*this);
+		}
+	}
+
+	// Queued until the next Flush
 	void SendPacket(sf::Packet& packet, const sf::IpAddress& remoteAddress, en::U16 remotePort)
 	{
-		mSocket.send(packet, remoteAddress, remotePort);
+		GetBatch(remoteAddress, remotePort).Append(packet);
+	}
+
+	void SendPacket(const PooledPacket& packet, const sf::IpAddress& remoteAddress, en::U16 remotePort)
+	{
+		if (packet)
+		{
+			GetBatch(remoteAddress, remotePort).Append(packet.getData(), packet.getDataSize());
+		}
+	}
+
+	// Hand the queued messages to the network thread, a few datagrams per endpoint instead of one per message
+	void Flush()
+	{
+		if (mNetwork == nullptr)
+		{
+			Flush(*this);
+		}
+	}
+
+	// Same, with the messages queued in an attached socket
+	// Only from the thread using this socket, while nothing else uses the attached one
+	void Flush(ServerSocket& source)
+	{
+		std::unordered_map<en::U64, EndpointBatch>& batches = source.mBatches;
+		for (auto itr = batches.begin(); itr != batches.end(); )
+		{
+			EndpointBatch& batch = itr->second;
+			if (batch.batch.IsEmpty())
+			{
+				// Nothing sent to this endpoint since the last Flush, forget it
+				itr = batches.erase(itr);
+			}
+			else
+			{
+				batch.batch.Flush([this, &batch](const void* data, std::size_t size)
+				{
+					PushOutgoing(data, size, batch.remoteAddress, batch.remotePort);
+				});
+				++itr;
+			}
+		}
 	}
 
+	// Datagrams received by the network thread, oldest first
 	bool PollPacket(sf::Packet& packet, sf::IpAddress& remoteAddress, en::U16& remotePort)
 	{
-		if (mSocket.receive(packet, remoteAddress, remotePort) == sf::Socket::Done)
+		if (ReceivedDatagram* datagram = (mQueues != nullptr) ? mQueues->incoming.BeginPop() : nullptr)
 		{
+			packet.clear();
+			packet.append(datagram->data, datagram->size);
+			remoteAddress = datagram->remoteAddress;
+			remotePort = datagram->remotePort;
+			mQueues->incoming.EndPop();
 			return true;
 		}
 		else
@@ -58,13 +180,155 @@ public:
 		}
 	}
 
+	// recvmmsg/sendmmsg on Linux, set before Start
+	void SetSystemBatchEnabled(bool enabled) { mSocket.SetSystemBatchEnabled(enabled); }
+	bool IsSystemBatchEnabled() const { return mSocket.IsSystemBatchEnabled(); }
+
+	// Written by the network thread, exact once stopped
+	en::U64 GetSystemCallCount() const { return mSocket.GetSystemCallCount(); }
+
+	// Datagrams and bytes counted by the network thread, set before Start
+	void SetMetrics(ServerMetrics* metrics) { mMetrics = metrics; }
+
 	en::U16 GetSocketPort() const { return mSocketPort; }
+	en::U16 GetLocalPort() const { return mSocket.getLocalPort(); }
 	void SetSocketPort(en::U16 socketPort) { mSocketPort = socketPort; }
 
 	bool IsRunning() const { return mRunning; }
 
 private:
-	sf::UdpSocket mSocket;
+	PacketBatch& GetBatch(const sf::IpAddress& remoteAddress, en::U16 remotePort)
+	{
+		EndpointBatch& batch = mBatches[GetEndpointKey(remoteAddress, remotePort)];
+		batch.remoteAddress = remoteAddress;
+		batch.remotePort = remotePort;
+		return batch.batch;
+	}
+
+	void PushOutgoing(const void* data, std::size_t size, const sf::IpAddress& remoteAddress, en::U16 remotePort)
+	{
+		if (!mRunning || mQueues == nullptr)
+		{
+			return;
+		}
+		SentDatagram* datagram = mQueues->outgoing.BeginPush();
+		if (datagram == nullptr)
+		{
+			// The network thread is late by a whole queue, UDP can lose this one too
+			LogWarning(en::LogChannel::All, 5, "Outgoing queue full, datagram dropped%s", "");
+			if (mMetrics != nullptr)
+			{
+				mMetrics->datagramsDropped.Add();
+			}
+			return;
+		}
+		const char* bytes = static_cast<const char*>(data);
+		datagram->data.assign(bytes, bytes + size);
+		datagram->remoteAddress = remoteAddress;
+		datagram->remotePort = remotePort;
+		mQueues->outgoing.EndPush();
+	}
+
+	void NetworkThread()
+	{
+		sf::SocketSelector selector;
+		selector.add(mSocket);
+		while (mThreadRunning)
+		{
+			SendOutgoing();
+			if (selector.wait(DefaultNetworkWaitTime))
+			{
+				if (!ReceiveIncoming())
+				{
+					// The simulation is late, leave the datagrams in the socket buffer meanwhile
+					std::this_thread::yield();
+				}
+			}
+		}
+		// Last messages queued before Stop
+		SendOutgoing();
+	}
+
+	// The queue slots are contiguous, so they are handed to the socket a batch at a time
+	void SendOutgoing()
+	{
+		en::U32 count = 0;
+		for (const SentDatagram* datagrams = mQueues->outgoing.BeginPop(DefaultNetworkQueueSize, count); count > 0; datagrams = mQueues->outgoing.BeginPop(DefaultNetworkQueueSize, count))
+		{
+			mSocket.SendBatch(datagrams, count);
+			if (mMetrics != nullptr)
+			{
+				en::U64 bytes = 0;
+				for (en::U32 i = 0; i < count; ++i)
+				{
+					bytes += datagrams[i].data.size();
+				}
+				mMetrics->datagramsSent.Add(count);
+				mMetrics->bytesSent.Add(bytes);
+			}
+			mQueues->outgoing.EndPop(count);
+		}
+	}
+
+	// False if the incoming queue is full
+	bool ReceiveIncoming()
+	{
+		en::U32 count = 0;
+		for (ReceivedDatagram* datagrams = mQueues->incoming.BeginPush(DefaultNetworkQueueSize, count); count > 0; datagrams = mQueues->incoming.BeginPush(DefaultNetworkQueueSize, count))
+		{
+			const en::U32 received = mSocket.ReceiveBatch(datagrams, count);
+			if (mMetrics != nullptr)
+			{
+				en::U64 bytes = 0;
+				for (en::U32 i = 0; i < received; ++i)
+				{
+					bytes += datagrams[i].size;
+				}
+				mMetrics->datagramsReceived.Add(received);
+				mMetrics->bytesReceived.Add(bytes);
+			}
+			mQueues->incoming.EndPush(received);
+			if (received < count)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+private:
+	struct EndpointBatch
+	{
+		sf::IpAddress remoteAddress;
+		en::U16 remotePort;
+		PacketBatch batch;
+	};
+
+	BatchedUdpSocket mSocket;
 	en::U16 mSocketPort;
 	bool mRunning;
-};
\ No newline at end of file
+	std::unordered_map<en::U64, EndpointBatch> mBatches;
+	ServerMetrics* mMetrics;
+
+	// Only allocated when started, attached sockets don't need them
+	struct Queues
+	{
+		Queues()
+			: incoming(DefaultNetworkQueueSize)
+			, outgoing(DefaultNetworkQueueSize)
+		{
+			for (SentDatagram& datagram : outgoing.GetSlots())
+			{
+				datagram.data.reserve(DefaultMaxDatagramSize);
+			}
+		}
+
+		en::SPSCQueue<ReceivedDatagram> incoming; // Network thread -> simulation
+		en::SPSCQueue<SentDatagram> outgoing; // Simulation -> network thread
+	};
+
+	ServerSocket* mNetwork; // Attached to it, if any
+	std::unique_ptr<Queues> mQueues;
+	std::thread mThread;
+	std::atomic<bool> mThreadRunning;
+};
@@ -0,0 +1,71 @@
+#include "AllocationCounter.hpp"
+#include "Server.hpp"
+
+#include <Enlivengine/System/Time.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+// Headless and deterministic : no socket, only AI players, seeded random engine
+// Run it before and after a change of the simulation, the state hash must only change if the behavior does
+// Usage : LudumDare46ServerSimulationBenchmark [players] [steps] [seed]
+int main(int argc, char** argv)
+{
+	const en::U32 playerCount = (argc >= 2) ? static_cast<en::U32>(std::atoi(argv[1])) : 256;
+	const en::U32 measuredSteps = (argc >= 3) ? static_cast<en::U32>(std::atoi(argv[2])) : 3600;
+	const en::U32 seed = (argc >= 4) ? static_cast<en::U32>(std::atoi(argv[3])) : 42;
+	const en::U32 warmupSteps = 600;
+	const en::U32 stepsPerTick = static_cast<en::U32>(DefaultTickInterval.asSeconds() / DefaultStepInterval.asSeconds() + 0.5f);
+
+	std::printf("Simulation : %u AI players, %u steps (+%u warmup), seed %u\n", playerCount, measuredSteps, warmupSteps, seed);
+
+	Server server;
+	server.SetRandomSeed(seed);
+	server.SetMaxPlayers(playerCount);
+	for (en::U32 i = 0; i < playerCount; ++i)
+	{
+		server.AddAIPlayer("Bot" + std::to_string(i));
+	}
+
+	ServerProfile profile;
+	profile.getAllocationCount = &GetAllocationCount;
+	server.SetProfile(&profile);
+
+	en::U32 step = 0;
+	const auto runSteps = [&server, &step, stepsPerTick](en::U32 count)
+	{
+		for (en::U32 i = 0; i < count; ++i, ++step)
+		{
+			server.UpdateLogic(DefaultStepInterval);
+			if ((step + 1) % stepsPerTick == 0)
+			{
+				server.Tick(DefaultTickInterval);
+			}
+		}
+	};
+
+	runSteps(warmupSteps);
+	profile.Reset();
+
+	const std::size_t allocationsBefore = GetAllocationCount();
+	en::Clock clock;
+	runSteps(measuredSteps);
+	const en::Time elapsed = clock.getElapsedTime();
+	const std::size_t allocations = GetAllocationCount() - allocationsBefore;
+
+	server.SetProfile(nullptr);
+
+	std::printf("%-8s %10s %8s %10s %7s %12s\n", "Phase", "total ms", "calls", "us/call", "share", "allocations");
+	for (en::U32 i = 0; i < ServerProfile::PhaseCount; ++i)
+	{
+		const en::F32 totalMs = profile.times[i].asSeconds() * 1000.0f;
+		const en::F32 perCallUs = (profile.calls[i] > 0) ? totalMs * 1000.0f / static_cast<en::F32>(profile.calls[i]) : 0.0f;
+		const en::F32 share = totalMs * 100.0f / (elapsed.asSeconds() * 1000.0f);
+		std::printf("%-8s %10.3f %8u %10.3f %6.1f%% %12zu\n", GetServerPhaseName(static_cast<ServerPhase>(i)), totalMs, profile.calls[i], perCallUs, share, profile.allocations[i]);
+	}
+	std::printf("Total : %.3f ms, %.4f ms/step, %zu allocations\n", elapsed.asSeconds() * 1000.0f, elapsed.asSeconds() * 1000.0f / static_cast<en::F32>(measuredSteps), allocations);
+	std::printf("Players left : %u, state hash : %08x\n", server.GetPlayerCount(), server.ComputeStateHash());
+
+	return 0;
+}
@@ -1,8 +1,8 @@
-#include "Server.hpp"
+#include "RoomManager.hpp"
 
 int main(int argc, char** argv)
 {
-	Server server;
+	RoomManager server;
 	if (!server.Start(argc, argv))
 	{
 		return -1;
@@ -11,4 +11,4 @@ int main(int argc, char** argv)
 	server.Run();
 
 	return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,187 @@
+#include <Common.hpp>
+#include <Enlivengine/Math/Utilities.hpp>
+
+#include <doctest/doctest.h>
+
+namespace
+{
+
+// Within one quantization step
+bool IsQuantized(en::F32 value, en::F32 expected, const en::BitQuantization& quantization)
+{
+	return en::Math::Abs(value - expected) <= quantization.GetResolution();
+}
+
+bool IsQuantizedPosition(const en::Vector2f& value, const en::Vector2f& expected)
+{
+	return IsQuantized(value.x, expected.x, en::BitQuantization(DefaultPositionXQuantization))
+		&& IsQuantized(value.y, expected.y, en::BitQuantization(DefaultPositionYQuantization));
+}
+
+bool IsQuantizedRotation(en::F32 value, en::F32 expected)
+{
+	const en::F32 resolution = en::BitQuantization(DefaultRotationQuantization).GetResolution();
+	return en::Math::AngleBetween(value, expected) <= resolution;
+}
+
+template <typename T>
+bool RoundTrip(const T& value, T& result)
+{
+	en::BitWriter writer;
+	writer << value;
+	en::BitReader reader(writer.GetData(), writer.GetByteCount());
+	reader >> result;
+	return reader.IsValid();
+}
+
+} // namespace
+
+DOCTEST_TEST_CASE("Compact encoding of the common structs")
+{
+	Chicken chicken;
+	chicken.position = en::Vector2f(1234.56f, 789.01f);
+	chicken.rotation = 123.4f;
+	chicken.itemID = ItemID::Uzi;
+	chicken.kills = 300;
+	chicken.lifeMax = DefaultChickenLife;
+	chicken.life = 37.3f;
+	chicken.speed = DefaultChickenSpeed * 1.3f;
+	chicken.attack = 27.7f;
+	Chicken chickenRead;
+	DOCTEST_CHECK(RoundTrip(chicken, chickenRead));
+	DOCTEST_CHECK(IsQuantizedPosition(chickenRead.position, chicken.position));
+	DOCTEST_CHECK(IsQuantizedRotation(chickenRead.rotation, chicken.rotation));
+	DOCTEST_CHECK(chickenRead.itemID == chicken.itemID);
+	DOCTEST_CHECK(chickenRead.kills == chicken.kills);
+	DOCTEST_CHECK(IsQuantized(chickenRead.lifeMax, chicken.lifeMax, en::BitQuantization(DefaultLifeQuantization)));
+	DOCTEST_CHECK(IsQuantized(chickenRead.life, chicken.life, en::BitQuantization(DefaultLifeQuantization)));
+	DOCTEST_CHECK(IsQuantized(chickenRead.speed, chicken.speed, en::BitQuantization(DefaultStatQuantization)));
+	DOCTEST_CHECK(IsQuantized(chickenRead.attack, chicken.attack, en::BitQuantization(DefaultStatQuantization)));
+
+	Seed seed;
+	seed.seedUID = 0x12345;
+	seed.position = en::Vector2f(10.5f, 3000.25f);
+	seed.clientID = 0xDEADBEEF;
+	seed.remainingTime = en::seconds(2.3f);
+	Seed seedRead;
+	DOCTEST_CHECK(RoundTrip(seed, seedRead));
+	DOCTEST_CHECK(seedRead.seedUID == seed.seedUID);
+	DOCTEST_CHECK(IsQuantizedPosition(seedRead.position, seed.position));
+	DOCTEST_CHECK(seedRead.clientID == seed.clientID);
+	DOCTEST_CHECK(IsQuantized(seedRead.remainingTime.asSeconds(), seed.remainingTime.asSeconds(), en::BitQuantization(DefaultSeedTimeQuantization)));
+
+	Item item;
+	item.itemUID = 42;
+	item.itemID = ItemID::Crossbow;
+	item.position = en::Vector2f(2048.0f, 1536.0f);
+	Item itemRead;
+	DOCTEST_CHECK(RoundTrip(item, itemRead));
+	DOCTEST_CHECK(itemRead.itemUID == item.itemUID);
+	DOCTEST_CHECK(itemRead.itemID == item.itemID);
+	DOCTEST_CHECK(IsQuantizedPosition(itemRead.position, item.position));
+
+	Bullet bullet;
+	bullet.bulletUID = 1u << 20;
+	bullet.position = en::Vector2f(-12.5f, 99.9f);
+	bullet.rotation = 359.0f;
+	bullet.clientID = 5;
+	bullet.itemID = ItemID::Shuriken;
+	bullet.remainingDistance = DefaultItemRange * 0.7f;
+	Bullet bulletRead;
+	DOCTEST_CHECK(RoundTrip(bullet, bulletRead));
+	DOCTEST_CHECK(bulletRead.bulletUID == bullet.bulletUID);
+	DOCTEST_CHECK(IsQuantizedPosition(bulletRead.position, bullet.position));
+	DOCTEST_CHECK(IsQuantizedRotation(bulletRead.rotation, bullet.rotation));
+	DOCTEST_CHECK(bulletRead.clientID == bullet.clientID);
+	DOCTEST_CHECK(bulletRead.itemID == bullet.itemID);
+	DOCTEST_CHECK(IsQuantized(bulletRead.remainingDistance, bullet.remainingDistance, en::BitQuantization(DefaultBulletDistanceQuantization)));
+}
+
+DOCTEST_TEST_CASE("Compact encoding of positions on the map bounds")
+{
+	const en::Vector2f minPosition(-(DefaultMapBorder), -(DefaultMapBorder));
+	const en::Vector2f maxPosition(DefaultMapSizeX + DefaultMapBorder, DefaultMapSizeY + DefaultMapBorder);
+
+	en::BitWriter writer;
+	WritePosition(writer, minPosition);
+	WritePosition(writer, maxPosition);
+	// Clamped to the bounds
+	WritePosition(writer, minPosition - en::Vector2f(100.0f, 100.0f));
+	WritePosition(writer, maxPosition + en::Vector2f(100.0f, 100.0f));
+
+	en::BitReader reader(writer.GetData(), writer.GetByteCount());
+	const en::Vector2f minRead = ReadPosition(reader);
+	const en::Vector2f maxRead = ReadPosition(reader);
+	const en::Vector2f belowRead = ReadPosition(reader);
+	const en::Vector2f aboveRead = ReadPosition(reader);
+	DOCTEST_CHECK(reader.IsValid());
+	DOCTEST_CHECK(minRead.x == doctest::Approx(minPosition.x));
+	DOCTEST_CHECK(minRead.y == doctest::Approx(minPosition.y));
+	DOCTEST_CHECK(maxRead.x == doctest::Approx(maxPosition.x));
+	DOCTEST_CHECK(maxRead.y == doctest::Approx(maxPosition.y));
+	DOCTEST_CHECK(belowRead.x == doctest::Approx(minPosition.x));
+	DOCTEST_CHECK(belowRead.y == doctest::Approx(minPosition.y));
+	DOCTEST_CHECK(aboveRead.x == doctest::Approx(maxPosition.x));
+	DOCTEST_CHECK(aboveRead.y == doctest::Approx(maxPosition.y));
+}
+
+DOCTEST_TEST_CASE("Compact encoding of rotations")
+{
+	const en::F32 rotations[] = { 0.0f, 90.0f, 359.99f, 360.0f, 450.0f, -90.0f, -0.01f, -720.0f };
+	const en::F32 expected[] = { 0.0f, 90.0f, 359.99f, 0.0f, 90.0f, 270.0f, 359.99f, 0.0f };
+
+	en::BitWriter writer;
+	for (en::F32 rotation : rotations)
+	{
+		WriteRotation(writer, rotation);
+	}
+
+	en::BitReader reader(writer.GetData(), writer.GetByteCount());
+	for (en::U32 i = 0; i < sizeof(rotations) / sizeof(rotations[0]); ++i)
+	{
+		const en::F32 rotation = ReadRotation(reader);
+		DOCTEST_CHECK(rotation >= 0.0f);
+		DOCTEST_CHECK(rotation < 360.0f);
+		DOCTEST_CHECK(IsQuantizedRotation(rotation, expected[i]));
+	}
+	DOCTEST_CHECK(reader.IsValid());
+}
+
+DOCTEST_TEST_CASE("Compact encoding of item IDs")
+{
+	en::BitWriter writer;
+	for (en::U32 itemID = 0; itemID < static_cast<en::U32>(ItemID::Count); ++itemID)
+	{
+		WriteItemID(writer, itemID);
+	}
+	{
+		en::BitReader reader(writer.GetData(), writer.GetByteCount());
+		for (en::U32 itemID = 0; itemID < static_cast<en::U32>(ItemID::Count); ++itemID)
+		{
+			DOCTEST_CHECK(ReadItemID(reader) == itemID);
+		}
+		DOCTEST_CHECK(reader.IsValid());
+	}
+
+	// Fits in the bits, but isn't an item : read as None and the reader is invalid
+	writer.Clear();
+	writer.WriteBits(static_cast<en::U32>(ItemID::Count), DefaultItemIDBits);
+	{
+		en::BitReader reader(writer.GetData(), writer.GetByteCount());
+		DOCTEST_CHECK(ReadItemID(reader) == static_cast<en::U32>(ItemID::None));
+		DOCTEST_CHECK(!reader.IsValid());
+	}
+
+	// Same through a struct
+	writer.Clear();
+	writer.WriteVarU32(1);
+	writer.WriteBits((1u << DefaultItemIDBits) - 1, DefaultItemIDBits);
+	WritePosition(writer, en::Vector2f(0.0f, 0.0f));
+	{
+		en::BitReader reader(writer.GetData(), writer.GetByteCount());
+		Item itemRead;
+		reader >> itemRead;
+		DOCTEST_CHECK(!reader.IsValid());
+		DOCTEST_CHECK(itemRead.itemID == ItemID::None);
+	}
+}
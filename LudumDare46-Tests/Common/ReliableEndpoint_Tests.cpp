@@ -0,0 +1,169 @@
+#include <ReliableEndpoint.hpp>
+
+#include <doctest/doctest.h>
+
+namespace
+{
+
+bool SendValue(ReliableEndpoint& endpoint, en::U32 value, ReliableChannelID channel)
+{
+	sf::Packet message;
+	message << value;
+	return endpoint.Send(message.getData(), message.getDataSize(), channel);
+}
+
+// One datagram from -> to, False if from had nothing to send
+bool Transfer(ReliableEndpoint& from, ReliableEndpoint& to, en::Time now, bool lost = false)
+{
+	sf::Packet packet;
+	if (!from.WritePacket(packet, now))
+	{
+		return false;
+	}
+	if (!lost)
+	{
+		DOCTEST_CHECK(to.ReadPacket(packet.getData(), packet.getDataSize(), now));
+	}
+	return true;
+}
+
+} // namespace
+
+DOCTEST_TEST_CASE("ReliableEndpoint resend delay")
+{
+	ReliableEndpoint client;
+	ReliableEndpoint server;
+	DOCTEST_CHECK(!Transfer(server, client, en::Time::Zero));
+
+	DOCTEST_CHECK(SendValue(server, 42, ReliableChannelID::Session));
+	DOCTEST_CHECK(Transfer(server, client, en::Time::Zero, true));
+
+	// Lost, but not sent again before DefaultReliableMinResendDelay
+	DOCTEST_CHECK(!Transfer(server, client, DefaultReliableMinResendDelay - en::milliseconds(1)));
+	DOCTEST_CHECK(server.GetResendCount() == 0);
+	DOCTEST_CHECK(Transfer(server, client, DefaultReliableMinResendDelay));
+	DOCTEST_CHECK(server.GetResendCount() == 1);
+
+	// Acked : nothing is due anymore, and the resent message doesn't give a round trip
+	DOCTEST_CHECK(Transfer(client, server, DefaultReliableMinResendDelay + en::milliseconds(30)));
+	DOCTEST_CHECK(server.GetQueuedCount(ReliableChannelID::Session) == 0);
+	DOCTEST_CHECK(server.GetRoundTripTime() == en::Time::Zero);
+	DOCTEST_CHECK(!Transfer(server, client, en::seconds(10.0f)));
+
+	sf::Packet message;
+	en::U32 value = 0;
+	DOCTEST_CHECK(client.PollMessage(message));
+	message >> value;
+	DOCTEST_CHECK(value == 42);
+	DOCTEST_CHECK(!client.PollMessage(message));
+}
+
+DOCTEST_TEST_CASE("ReliableEndpoint duplicates")
+{
+	ReliableEndpoint client;
+	ReliableEndpoint server;
+	DOCTEST_CHECK(SendValue(server, 1, ReliableChannelID::Session));
+	DOCTEST_CHECK(SendValue(server, 2, ReliableChannelID::Session));
+
+	sf::Packet packet;
+	DOCTEST_CHECK(server.WritePacket(packet, en::Time::Zero));
+	DOCTEST_CHECK(client.ReadPacket(packet.getData(), packet.getDataSize(), en::Time::Zero));
+	DOCTEST_CHECK(client.ReadPacket(packet.getData(), packet.getDataSize(), en::Time::Zero));
+
+	sf::Packet message;
+	en::U32 value = 0;
+	DOCTEST_CHECK(client.PollMessage(message));
+	message >> value;
+	DOCTEST_CHECK(value == 1);
+	DOCTEST_CHECK(client.PollMessage(message));
+	message >> value;
+	DOCTEST_CHECK(value == 2);
+	DOCTEST_CHECK(!client.PollMessage(message));
+
+	// Received again after being polled, as if the ack was lost : acked again, not delivered again
+	DOCTEST_CHECK(client.ReadPacket(packet.getData(), packet.getDataSize(), en::milliseconds(200)));
+	DOCTEST_CHECK(!client.PollMessage(message));
+	DOCTEST_CHECK(Transfer(client, server, en::milliseconds(200)));
+	DOCTEST_CHECK(server.GetQueuedCount(ReliableChannelID::Session) == 0);
+
+	// A malformed packet is rejected
+	DOCTEST_CHECK(!client.ReadPacket(packet.getData(), packet.getDataSize() - 1, en::milliseconds(200)));
+}
+
+DOCTEST_TEST_CASE("ReliableEndpoint in order per channel with loss")
+{
+	ReliableEndpoint client;
+	ReliableEndpoint server;
+	const en::U32 messageCount = 500;
+	en::U32 sent[2] = { 0, 0 };
+	en::U32 received[2] = { 0, 0 };
+	bool inOrder = true;
+	en::Time now = en::Time::Zero;
+	for (en::U32 round = 0; round < 2000 && (received[0] < messageCount || received[1] < messageCount); ++round)
+	{
+		for (en::U32 c = 0; c < 2; ++c)
+		{
+			const ReliableChannelID channel = static_cast<ReliableChannelID>(c);
+			if (sent[c] < messageCount && SendValue(server, c * 100000 + sent[c], channel))
+			{
+				sent[c]++;
+			}
+		}
+
+		// A third of the datagrams are lost each way
+		now += en::milliseconds(20);
+		Transfer(server, client, now, round % 3 == 0);
+		Transfer(client, server, now, round % 3 == 1);
+
+		sf::Packet message;
+		while (client.PollMessage(message))
+		{
+			en::U32 value = 0;
+			message >> value;
+			const en::U32 c = value / 100000;
+			inOrder = inOrder && c < 2 && value % 100000 == received[c];
+			received[c]++;
+		}
+	}
+	DOCTEST_CHECK(inOrder);
+	DOCTEST_CHECK(received[0] == messageCount);
+	DOCTEST_CHECK(received[1] == messageCount);
+	DOCTEST_CHECK(server.GetResendCount() > 0);
+}
+
+DOCTEST_TEST_CASE("ReliableEndpoint sequence wrap")
+{
+	// Past 65536 messages, with losses around the wrap so the ack bitfield spans it
+	ReliableEndpoint client;
+	ReliableEndpoint server;
+	const en::U32 messageCount = 65536 + 200;
+	en::U32 sent = 0;
+	en::U32 received = 0;
+	bool inOrder = true;
+	en::Time now = en::Time::Zero;
+	for (en::U32 round = 0; round < 20000 && received < messageCount; ++round)
+	{
+		for (en::U32 i = 0; i < 16 && sent < messageCount && SendValue(server, sent, ReliableChannelID::Gameplay); ++i)
+		{
+			sent++;
+		}
+
+		const bool nearWrap = (sent > 65536 - 64 && sent < 65536 + 64);
+		now += en::milliseconds(40);
+		Transfer(server, client, now, nearWrap && round % 2 == 0);
+		Transfer(client, server, now);
+
+		sf::Packet message;
+		while (client.PollMessage(message))
+		{
+			en::U32 value = 0;
+			message >> value;
+			inOrder = inOrder && value == received;
+			received++;
+		}
+	}
+	DOCTEST_CHECK(inOrder);
+	DOCTEST_CHECK(received == messageCount);
+	Transfer(client, server, now);
+	DOCTEST_CHECK(server.GetQueuedCount(ReliableChannelID::Gameplay) == 0);
+}
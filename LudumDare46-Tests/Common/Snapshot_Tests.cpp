@@ -0,0 +1,96 @@
+#include <Snapshot.hpp>
+
+#include <doctest/doctest.h>
+
+namespace
+{
+
+// One chicken moving along x, its score and a seed
+void PushSnapshot(SnapshotBuffer& buffer, en::U32 sequence)
+{
+	Snapshot& snapshot = buffer.Push(sequence);
+
+	SnapshotChicken chicken;
+	chicken.clientID = 7;
+	chicken.chicken.position = en::Vector2f(10.0f * sequence, 200.0f);
+	chicken.chicken.rotation = 90.0f;
+	chicken.chicken.itemID = ItemID::Laser;
+	chicken.chicken.kills = sequence / 10;
+	chicken.chicken.lifeMax = DefaultChickenLife;
+	chicken.chicken.life = DefaultChickenLife;
+	chicken.chicken.speed = DefaultChickenSpeed;
+	chicken.chicken.attack = DefaultChickenAttack;
+	chicken.far = false;
+	snapshot.chickens.push_back(chicken);
+	snapshot.scores.push_back({ chicken.clientID, chicken.chicken.kills });
+
+	Seed seed;
+	seed.seedUID = 3;
+	seed.position = en::Vector2f(300.0f, 400.0f);
+	seed.clientID = chicken.clientID;
+	seed.remainingTime = en::seconds(2.0f);
+	snapshot.seeds.push_back(seed);
+}
+
+// Like the client : decode against baselineSequence if it can still be used
+bool ReceiveSnapshot(const SnapshotBuffer& server, SnapshotBuffer& client, en::U32 sequence, en::U32 baselineSequence)
+{
+	const Snapshot* baseline = client.GetBaseline(sequence, baselineSequence);
+	if (baseline == nullptr)
+	{
+		return false;
+	}
+
+	en::BitWriter writer;
+	WriteSnapshotDelta(writer, *server.Get(baselineSequence), *server.Get(sequence), server);
+	en::BitReader reader(writer.GetData(), writer.GetByteCount());
+	Snapshot& current = client.Push(sequence);
+	return ReadSnapshotDelta(reader, *baseline, current);
+}
+
+bool IsSameSnapshot(const Snapshot& a, const Snapshot& b)
+{
+	return a.chickens.size() == 1 && b.chickens.size() == 1
+		&& a.chickens[0].clientID == b.chickens[0].clientID
+		&& a.chickens[0].chicken.position.x == doctest::Approx(b.chickens[0].chicken.position.x).epsilon(0.001)
+		&& a.chickens[0].chicken.kills == b.chickens[0].chicken.kills
+		&& a.scores.size() == 1 && b.scores.size() == 1 && a.scores[0].kills == b.scores[0].kills
+		&& a.seeds.size() == 1 && b.seeds.size() == 1 && a.seeds[0].seedUID == b.seeds[0].seedUID;
+}
+
+} // namespace
+
+DOCTEST_TEST_CASE("Snapshot full state after the buffer wrapped")
+{
+	SnapshotBuffer server;
+	SnapshotBuffer client;
+	for (en::U32 sequence = 1; sequence <= 40; ++sequence)
+	{
+		PushSnapshot(server, sequence);
+	}
+
+	// A late joiner gets the full state, against the empty baseline 0
+	DOCTEST_CHECK(ReceiveSnapshot(server, client, 40, 0));
+	DOCTEST_CHECK(IsSameSnapshot(*client.Get(40), *server.Get(40)));
+
+	// Then deltas against what it acknowledged
+	for (en::U32 sequence = 41; sequence <= 50; ++sequence)
+	{
+		PushSnapshot(server, sequence);
+	}
+	DOCTEST_CHECK(ReceiveSnapshot(server, client, 50, 40));
+	DOCTEST_CHECK(IsSameSnapshot(*client.Get(50), *server.Get(50)));
+
+	// A baseline a whole buffer old is rejected, even if the client still has it
+	for (en::U32 sequence = 51; sequence <= 82; ++sequence)
+	{
+		PushSnapshot(server, sequence);
+	}
+	DOCTEST_CHECK(client.Get(50) != nullptr);
+	DOCTEST_CHECK(client.GetBaseline(82, 50) == nullptr);
+	DOCTEST_CHECK(!ReceiveSnapshot(server, client, 82, 50));
+
+	// A client that fell behind is sent the full state again
+	DOCTEST_CHECK(ReceiveSnapshot(server, client, 82, 0));
+	DOCTEST_CHECK(IsSameSnapshot(*client.Get(82), *server.Get(82)));
+}
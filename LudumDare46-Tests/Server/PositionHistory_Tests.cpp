@@ -0,0 +1,129 @@
+#include <PositionHistory.hpp>
+
+#include <doctest/doctest.h>
+
+namespace
+{
+
+bool IsSamePoint(const en::Vector2f& a, const en::Vector2f& b)
+{
+	return a.x == doctest::Approx(b.x).epsilon(0.0001) && a.y == doctest::Approx(b.y).epsilon(0.0001);
+}
+
+// Two chickens : the first moves along x by 10 per step, the second along y by 20 per step
+void RecordSteps(PositionHistory& history, en::U32 firstStep, en::U32 stepCount)
+{
+	for (en::U32 step = firstStep; step < firstStep + stepCount; ++step)
+	{
+		const en::Vector2f positions[2] = { en::Vector2f(10.0f * step, 0.0f), en::Vector2f(0.0f, 20.0f * step) };
+		history.Record(en::seconds(0.1f * step), positions, 2);
+	}
+}
+
+} // namespace
+
+DOCTEST_TEST_CASE("PositionHistory interpolation")
+{
+	PositionHistory history;
+	history.Initialize(4);
+	history.Reset(0, en::Vector2f(0.0f, 0.0f), en::Time::Zero);
+	history.Reset(1, en::Vector2f(0.0f, 0.0f), en::Time::Zero);
+	DOCTEST_CHECK(history.GetRecordedCount() == 0);
+	DOCTEST_CHECK(IsSamePoint(history.GetPosition(0, en::seconds(1.0f)), en::Vector2f(0.0f, 0.0f)));
+
+	RecordSteps(history, 1, 3);
+	DOCTEST_CHECK(history.GetRecordedCount() == 3);
+	DOCTEST_CHECK(history.GetNewestTime() == en::seconds(0.3f));
+	DOCTEST_CHECK(history.GetOldestTime() == en::seconds(0.1f));
+
+	// On the samples
+	DOCTEST_CHECK(IsSamePoint(history.GetPosition(0, en::seconds(0.2f)), en::Vector2f(20.0f, 0.0f)));
+	DOCTEST_CHECK(IsSamePoint(history.GetPosition(1, en::seconds(0.3f)), en::Vector2f(0.0f, 60.0f)));
+
+	// Between the samples
+	DOCTEST_CHECK(IsSamePoint(history.GetPosition(0, en::seconds(0.15f)), en::Vector2f(15.0f, 0.0f)));
+	DOCTEST_CHECK(IsSamePoint(history.GetPosition(1, en::seconds(0.275f)), en::Vector2f(0.0f, 55.0f)));
+
+	// Each step moved the second chicken by 20
+	DOCTEST_CHECK(history.GetMaxDistanceSince(en::seconds(0.3f)) == doctest::Approx(0.0f));
+	DOCTEST_CHECK(history.GetMaxDistanceSince(en::seconds(0.2f)) == doctest::Approx(20.0f));
+	DOCTEST_CHECK(history.GetMaxDistanceSince(en::seconds(0.15f)) == doctest::Approx(40.0f));
+}
+
+DOCTEST_TEST_CASE("PositionHistory rewind window")
+{
+	PositionHistory history;
+	history.Initialize(4);
+	history.Reset(0, en::Vector2f(0.0f, 0.0f), en::Time::Zero);
+	history.Reset(1, en::Vector2f(0.0f, 0.0f), en::Time::Zero);
+
+	// The ring only keeps the steps 7 to 10
+	RecordSteps(history, 1, 10);
+	DOCTEST_CHECK(history.GetRecordedCount() == 4);
+	DOCTEST_CHECK(history.GetOldestTime() == en::seconds(0.7f));
+	DOCTEST_CHECK(history.GetNewestTime() == en::seconds(1.0f));
+
+	// Clamped to the oldest and the newest samples
+	DOCTEST_CHECK(IsSamePoint(history.GetPosition(0, en::seconds(0.2f)), en::Vector2f(70.0f, 0.0f)));
+	DOCTEST_CHECK(IsSamePoint(history.GetPosition(0, en::seconds(5.0f)), en::Vector2f(100.0f, 0.0f)));
+	DOCTEST_CHECK(IsSamePoint(history.GetPosition(1, en::seconds(0.85f)), en::Vector2f(0.0f, 170.0f)));
+
+	// Only the moves still in the window are counted
+	DOCTEST_CHECK(history.GetMaxDistanceSince(en::Time::Zero) == doctest::Approx(60.0f));
+}
+
+DOCTEST_TEST_CASE("PositionHistory respawn")
+{
+	PositionHistory history;
+	history.Initialize(4);
+	history.Reset(0, en::Vector2f(0.0f, 0.0f), en::Time::Zero);
+	history.Reset(1, en::Vector2f(0.0f, 0.0f), en::Time::Zero);
+	RecordSteps(history, 1, 2);
+
+	// Killed at step 2 : the rewinds before that have to miss it, instead of finding it at the spawn
+	history.Reset(0, en::Vector2f(500.0f, 500.0f), en::seconds(0.2f));
+	DOCTEST_CHECK(history.GetSpawnTime(0) == en::seconds(0.2f));
+	DOCTEST_CHECK(history.GetSpawnTime(1) == en::Time::Zero);
+	DOCTEST_CHECK(IsSamePoint(history.GetPosition(0, en::seconds(0.2f)), en::Vector2f(500.0f, 500.0f)));
+
+	// The move after the respawn starts from the spawn, not from where it died
+	const en::Vector2f positions[2] = { en::Vector2f(503.0f, 504.0f), en::Vector2f(0.0f, 60.0f) };
+	history.Record(en::seconds(0.3f), positions, 2);
+	DOCTEST_CHECK(history.GetMaxDistanceSince(en::seconds(0.2f)) == doctest::Approx(20.0f));
+	DOCTEST_CHECK(IsSamePoint(history.GetPosition(0, en::seconds(0.25f)), en::Vector2f(501.5f, 502.0f)));
+
+	// Spawned between two samples : never interpolated with the older one
+	history.Reset(1, en::Vector2f(0.0f, 75.0f), en::seconds(0.35f));
+	RecordSteps(history, 4, 1);
+	DOCTEST_CHECK(IsSamePoint(history.GetPosition(1, en::seconds(0.35f)), en::Vector2f(0.0f, 80.0f)));
+}
+
+DOCTEST_TEST_CASE("PositionHistory removal")
+{
+	PositionHistory history;
+	history.Initialize(4);
+	history.Reserve(3);
+	history.Reset(0, en::Vector2f(0.0f, 0.0f), en::Time::Zero);
+	history.Reset(1, en::Vector2f(0.0f, 0.0f), en::Time::Zero);
+	history.Reset(2, en::Vector2f(1000.0f, 0.0f), en::seconds(0.1f));
+	for (en::U32 step = 1; step <= 3; ++step)
+	{
+		const en::Vector2f positions[3] = { en::Vector2f(10.0f * step, 0.0f), en::Vector2f(0.0f, 20.0f * step), en::Vector2f(1000.0f, 30.0f * step) };
+		history.Record(en::seconds(0.1f * step), positions, 3);
+	}
+
+	// The last chicken takes the place of the removed one, with its history and its spawn time
+	history.Remove(0, 2);
+	DOCTEST_CHECK(history.GetSpawnTime(0) == en::seconds(0.1f));
+	DOCTEST_CHECK(IsSamePoint(history.GetPosition(0, en::seconds(0.15f)), en::Vector2f(1000.0f, 45.0f)));
+	DOCTEST_CHECK(IsSamePoint(history.GetPosition(1, en::seconds(0.15f)), en::Vector2f(0.0f, 30.0f)));
+
+	// Removing the last one doesn't move any other
+	history.Remove(1, 1);
+	DOCTEST_CHECK(IsSamePoint(history.GetPosition(0, en::seconds(0.3f)), en::Vector2f(1000.0f, 90.0f)));
+
+	// A new chicken at a removed index starts its own history
+	history.Reset(1, en::Vector2f(7.0f, 7.0f), en::seconds(0.3f));
+	DOCTEST_CHECK(history.GetSpawnTime(1) == en::seconds(0.3f));
+	DOCTEST_CHECK(IsSamePoint(history.GetPosition(1, en::seconds(0.3f)), en::Vector2f(7.0f, 7.0f)));
+}
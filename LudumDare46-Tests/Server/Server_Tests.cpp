@@ -0,0 +1,90 @@
+#include <AllocationCounter.hpp>
+
+#include <Server.hpp>
+
+#include <doctest/doctest.h>
+
+#include <string>
+
+DOCTEST_TEST_CASE("Server steady state ticks don't allocate")
+{
+	const en::U32 clientCount = 32;
+	const en::U32 aiCount = 32;
+	const en::U32 warmupTicks = 2400;
+	const en::U32 measuredTicks = 600;
+	const en::U32 stepsPerTick = static_cast<en::U32>(DefaultTickInterval.asSeconds() / DefaultStepInterval.asSeconds() + 0.5f);
+
+	// A room of a network socket that is never started : everything is written and batched, nothing is sent
+	const std::size_t allocationsAtStart = GetAllocationCount();
+	en::MetricsRegistry metricsRegistry;
+	ServerMetrics metrics(metricsRegistry);
+	ServerSocket network;
+	Server server;
+	server.SetRandomSeed(42);
+	server.SetMetrics(&metrics);
+	server.SetMaxPlayers(clientCount + aiCount + 1);
+	server.Start(network);
+	for (en::U32 i = 0; i < aiCount; ++i)
+	{
+		server.AddAIPlayer("Bot" + std::to_string(i));
+	}
+
+	const sf::IpAddress address = sf::IpAddress::LocalHost;
+	sf::Packet packet;
+	for (en::U32 i = 0; i < clientCount; ++i)
+	{
+		packet.clear();
+		packet << static_cast<en::U8>(ClientPacketID::Join) << std::string("Client" + std::to_string(i));
+		server.HandlePacket(packet, address, static_cast<en::U16>(40000 + i));
+	}
+	DOCTEST_CHECK(server.GetPlayerCount() == clientCount + aiCount + 1);
+
+	// The hooks do count : creating the server and the players allocates
+	DOCTEST_CHECK(GetAllocationCount() > allocationsAtStart);
+
+	// What the clients send every tick : Ping, SnapshotAck and sometimes DropSeed
+	en::U32 sequence = 0;
+	const auto runTick = [&](en::U32 tick)
+	{
+		for (en::U32 i = 0; i < clientCount; ++i)
+		{
+			const en::U16 port = static_cast<en::U16>(40000 + i);
+			packet.clear();
+			packet << static_cast<en::U8>(ClientPacketID::Ping);
+			server.HandlePacket(packet, address, port);
+
+			packet.clear();
+			packet << static_cast<en::U8>(ClientPacketID::SnapshotAck) << sequence;
+			server.HandlePacket(packet, address, port);
+
+			if ((tick + i) % 4 == 0)
+			{
+				packet.clear();
+				packet << static_cast<en::U8>(ClientPacketID::DropSeed) << Server::GenerateClientID(address, port);
+				packet << 100.0f + static_cast<en::F32>((i * 37 + tick * 11) % 3000) << 100.0f + static_cast<en::F32>((i * 53 + tick * 7) % 2000);
+				server.HandlePacket(packet, address, port);
+			}
+		}
+		server.Simulate(stepsPerTick, 1);
+		server.SendQueuedPackets();
+		sequence++;
+	};
+
+	for (en::U32 tick = 0; tick < warmupTicks; ++tick)
+	{
+		runTick(tick);
+	}
+
+	const std::size_t allocationsBefore = GetAllocationCount();
+	for (en::U32 tick = warmupTicks; tick < warmupTicks + measuredTicks; ++tick)
+	{
+		runTick(tick);
+	}
+	const std::size_t allocations = GetAllocationCount() - allocationsBefore;
+
+	DOCTEST_CHECK(allocations == 0);
+	DOCTEST_CHECK(server.GetPlayerCount() == clientCount + aiCount + 1);
+	DOCTEST_CHECK(metrics.tickDuration.GetCount() == warmupTicks + measuredTicks);
+
+	server.Stop();
+}